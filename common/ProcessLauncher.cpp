@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ProcessLauncher.h"
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <vector>
+
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+extern char **environ;
+
+#define READ_CHUNK 16384            // 每次读取的最小空间
+#define INITIAL_CAPACITY 65536      // 输出缓冲区的初始大小
+#define MAX_POLL_INTERVAL 50        // 不支持 pidfd 时等待进程退出的最大轮询间隔(ms)
+
+/**
+ * @brief waitExited : wait until the child exits without reaping it, the caller reaps it with wait4
+ * @param pid
+ * @param timeout : msec
+ * @return false if the child is still running when the timeout expires
+ */
+static bool waitExited(pid_t pid, qint64 timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+#ifdef SYS_pidfd_open
+    // pidfd 在子进程退出时可读，阻塞等待到截止时间，不需要轮询
+    int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd >= 0) {
+        bool exited = false;
+        while (true) {
+            qint64 remaining = timeout - timer.elapsed();
+            if (remaining <= 0)
+                break;
+            struct pollfd pfd;
+            pfd.fd = pidfd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            int n = poll(&pfd, 1, static_cast<int>(remaining));
+            if (n < 0 && errno == EINTR)
+                continue;
+            exited = n > 0;
+            break;
+        }
+        close(pidfd);
+        return exited;
+    }
+#endif
+
+    // 内核不支持 pidfd 时查询子进程状态，间隔逐渐加大；WNOWAIT 不回收子进程
+    int interval = 1;
+    while (true) {
+        siginfo_t info;
+        memset(&info, 0, sizeof(info));
+        int r = waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOHANG | WNOWAIT);
+        if (r == 0 && info.si_pid == pid)
+            return true;
+        if (r < 0 && errno != EINTR)
+            return true;
+        qint64 remaining = timeout - timer.elapsed();
+        if (remaining <= 0)
+            return false;
+        usleep(static_cast<useconds_t>(qMin<qint64>(interval, remaining) * 1000));
+        interval = qMin(interval * 2, MAX_POLL_INTERVAL);
+    }
+}
+
+bool ProcessLauncher::run(const QString &program, const QStringList &args, int timeout, QByteArray &output, ProcessStat *stat)
+{
+    ProcessStat unused;
+    if (!stat)
+        stat = &unused;
+    *stat = ProcessStat();
+    output.clear();
+    if (timeout <= 0)
+        timeout = DEFAULT_CMD_TIMEOUT;
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        qInfo() << "Failed to create pipe for" << program << ":" << strerror(errno);
+        return false;
+    }
+
+    // argv 中的字符串由 list 持有
+    QList<QByteArray> list;
+    list << program.toLocal8Bit();
+    foreach (const QString &arg, args) {
+        list << arg.toLocal8Bit();
+    }
+    std::vector<char *> argv;
+    for (QByteArray &arg : list) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    // 标准输出重定向到管道，标准输入和错误输出重定向到 /dev/null
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    // 子进程使用新的进程组，信号恢复默认处理
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t mask, def;
+    sigemptyset(&mask);
+    sigfillset(&def);
+    posix_spawnattr_setsigmask(&attr, &mask);
+    posix_spawnattr_setsigdefault(&attr, &def);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    pid_t pid = -1;
+    int ret = posix_spawnp(&pid, argv[0], &actions, &attr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    close(fds[1]);
+    if (ret != 0) {
+        close(fds[0]);
+        qInfo() << "Failed to start" << program << ":" << strerror(ret);
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool finished = true;
+    stat->started = true;
+
+    // 读取到预分配的缓冲区中，空间不足时加倍
+    output.reserve(INITIAL_CAPACITY);
+    while (true) {
+        int remaining = timeout - static_cast<int>(timer.elapsed());
+        if (remaining <= 0) {
+            finished = false;
+            break;
+        }
+
+        struct pollfd pfd;
+        pfd.fd = fds[0];
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int n = poll(&pfd, 1, remaining);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            break;
+        if (n == 0) {
+            finished = false;
+            break;
+        }
+
+        int size = output.size();
+        if (output.capacity() - size < READ_CHUNK)
+            output.reserve(qMax(output.capacity() * 2, size + READ_CHUNK));
+        output.resize(output.capacity());
+        ssize_t len = read(fds[0], output.data() + size, static_cast<size_t>(output.size() - size));
+        output.resize(size + static_cast<int>(qMax<ssize_t>(len, 0)));
+        if (len == 0)
+            break;
+        if (len < 0 && errno != EINTR && errno != EAGAIN)
+            break;
+    }
+    close(fds[0]);
+
+    // 输出结束后进程可能还未退出，仍然受超时时间限制
+    if (finished && !waitExited(pid, timeout - timer.elapsed()))
+        finished = false;
+    if (!finished)
+        kill(-pid, SIGKILL);
+
+    // 子进程已经退出或被结束，阻塞回收并获取资源使用
+    int status = 0;
+    struct rusage usage;
+    pid_t r = -1;
+    do {
+        r = wait4(pid, &status, 0, &usage);
+    } while (r < 0 && errno == EINTR);
+    if (r == pid) {
+        if (WIFEXITED(status))
+            stat->exitCode = WEXITSTATUS(status);
+        else if (WIFSIGNALED(status))
+            stat->termSignal = WTERMSIG(status);
+        stat->cpuUsec = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL
+                        + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+        stat->maxRssKb = usage.ru_maxrss;
+    }
+
+    stat->timedOut = !finished;
+    stat->wallMsec = timer.elapsed();
+    stat->bytes = output.size();
+    if (!finished)
+        qWarning() << "Process timeout :" << program << args.join(" ");
+    return finished;
+}
+
+bool ProcessLauncher::run(const QString &program, const QStringList &args, int timeout, QString &output, ProcessStat *stat)
+{
+    QByteArray data;
+    bool finished = run(program, args, timeout, data, stat);
+    output = QString::fromUtf8(data);
+    return finished;
+}
+
+bool ProcessLauncher::runCommand(const QString &cmd, int timeout, QString &output, ProcessStat *stat)
+{
+    QStringList args = cmd.split(" ", QString::SkipEmptyParts);
+    if (args.isEmpty()) {
+        output.clear();
+        if (stat)
+            *stat = ProcessStat();
+        return false;
+    }
+    QString program = args.takeFirst();
+    return run(program, args, timeout, output, stat);
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESSLAUNCHER_H
+#define PROCESSLAUNCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+#define DEFAULT_CMD_TIMEOUT 30000    // 采集命令默认的超时时间(ms)
+
+/**
+ * @brief The ProcessStat struct : 一次执行的耗时和资源使用，来自 wait4 的 rusage
+ */
+struct ProcessStat {
+    bool    started = false;        //<! 是否启动成功
+    bool    timedOut = false;       //<! 是否超时
+    int     exitCode = -1;          //<! 正常退出时的返回值
+    int     termSignal = 0;         //<! 被信号结束时的信号，超时结束为 SIGKILL
+    qint64  wallMsec = 0;           //<! 从启动到回收的时间
+    qint64  cpuUsec = 0;            //<! 子进程的用户态和内核态时间
+    qint64  maxRssKb = 0;           //<! 子进程的最大常驻内存
+    qint64  bytes = 0;              //<! 标准输出的字节数
+};
+
+/**
+ * @brief The ProcessLauncher class
+ * 通过 posix_spawn 直接执行命令，不经过 /bin/bash -c，也不需要 QProcess 的事件机制。
+ * 子进程在独立的进程组中运行，超时后结束整个进程组
+ */
+class ProcessLauncher
+{
+public:
+    /**
+     * @brief run : spawn the program and read its stdout until it exits or the deadline expires
+     * @param program : searched in PATH
+     * @param args
+     * @param timeout : deadline in msec, <= 0 means DEFAULT_CMD_TIMEOUT
+     * @param output : stdout of the program, partial if timeout
+     * @param stat : time and resource usage of the child, may be null, stat->started tells a failed start from a timeout
+     * @return false if the program could not be started or the deadline expired
+     */
+    static bool run(const QString &program, const QStringList &args, int timeout, QByteArray &output, ProcessStat *stat = nullptr);
+
+    /**
+     * @brief run
+     * @param program
+     * @param args
+     * @param timeout
+     * @param output : stdout decoded as UTF-8
+     * @param stat
+     * @return false if the program could not be started or the deadline expired
+     */
+    static bool run(const QString &program, const QStringList &args, int timeout, QString &output, ProcessStat *stat = nullptr);
+
+    /**
+     * @brief runCommand : run a simple command line such as "lsblk -d -o name,rota", no shell syntax
+     * @param cmd
+     * @param timeout
+     * @param output
+     * @param stat
+     * @return false if the program could not be started or the deadline expired
+     */
+    static bool runCommand(const QString &cmd, int timeout, QString &output, ProcessStat *stat = nullptr);
+};
+
+#endif // PROCESSLAUNCHER_H
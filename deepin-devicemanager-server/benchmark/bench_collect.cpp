@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ThreadPool.h"
+#include "DeviceInfoManager.h"
+#include "CollectorBundle.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDir>
+
+#include <algorithm>
+
+/**
+ * @brief findBundles : a bundle directory or a directory of bundles
+ */
+static QStringList findBundles(const QString &path)
+{
+    QStringList bundles;
+    QDir dir(path);
+    if (dir.exists("info")) {
+        bundles << dir.absolutePath();
+        return bundles;
+    }
+    foreach (const QString &name, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        if (QDir(dir.filePath(name)).exists("info"))
+            bundles << QDir(dir.filePath(name)).absolutePath();
+    }
+    return bundles;
+}
+
+/**
+ * @brief runOnce : msec of a full collection from an empty DeviceInfoManager to ThreadPool::finished
+ */
+static qint64 runOnce()
+{
+    // 每轮从空的信息开始，开机只采集一次的命令也重新执行
+    DeviceInfoManager::getInstance()->setAllInfo(QMap<QString, QString>());
+
+    ThreadPool pool;
+    QEventLoop loop;
+    QObject::connect(&pool, &ThreadPool::finished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+
+    QElapsedTimer timer;
+    timer.start();
+    pool.loadDeviceInfo(true);
+    loop.exec();
+    return timer.elapsed();
+}
+
+// 用法: deepin-devicemanager-server-replay-bench [-n rounds] <bundle>...
+// 与 deepin-devicemanager-replay-bench 使用同样的 bundle，分别测量后台采集和前台生成设备的耗时
+int main(int argc, char **argv)
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+
+    int rounds = 5;
+    QStringList bundles;
+    QStringList args = a.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "-n" && i + 1 < args.size())
+            rounds = qMax(1, args[++i].toInt());
+        else
+            bundles << findBundles(args[i]);
+    }
+    if (bundles.isEmpty()) {
+        out << "usage: " << a.applicationName() << " [-n rounds] <bundle>...\n";
+        return 1;
+    }
+
+    out << QString("%1 %2 %3 %4\n").arg("collect", -40).arg("min(ms)", 10).arg("median", 10).arg("max", 10);
+    foreach (const QString &bundle, bundles) {
+        CollectorBundle::getInstance()->setReplayDir(bundle);
+
+        QVector<qint64> times;
+        for (int i = 0; i < rounds; ++i)
+            times.append(runOnce());
+        std::sort(times.begin(), times.end());
+
+        out << QString("%1 %2 %3 %4\n").arg(QDir(bundle).dirName(), -40)
+            .arg(times.first(), 10).arg(times[times.size() / 2], 10).arg(times.last(), 10);
+        out.flush();
+    }
+    return 0;
+}
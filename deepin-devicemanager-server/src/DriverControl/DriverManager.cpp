@@ -9,6 +9,7 @@
 #include "DebInstaller.h"
 #include "DriverInstaller.h"
 #include "DeviceInfoManager.h"
+#include "DeviceRecordStore.h"
 #include "HttpDriverInterface.h"
 
 #include <QThread>
@@ -533,6 +534,47 @@ void DriverManager::getMapInfoFromHwinfo(const QString &info, QMap<QString, QStr
     }
 }
 
+void DriverManager::getMapInfoFromHwinfo(const DeviceRecord &record, QMap<QString, QString> &mapInfo)
+{
+    // 已按字段解析，规则与文本的解析相同
+    for (const QPair<QString, QString> &field : record.fields) {
+        QString key = field.first.trimmed();
+        QString value = field.second.trimmed();
+        if (key.contains("PS/2 Mouse") || value.contains("PS/2 Mouse")) {
+            key = "Hotplug";
+            value = "PS/2";
+        } else if (value.contains(": ")) {
+            // 文本中按 ": " 无法拆分为两部分的行会被忽略
+            continue;
+        }
+
+        if (mapInfo.find(key) != mapInfo.end())
+            mapInfo[key] += QString(" ");
+
+        QRegExp re(".*\"(.*)\".*");
+        if (re.exactMatch(value)) {
+            QString cap = re.cap(1);
+
+            //这里是为了防止  "usb-storage", "sr"  -》 usb-storage", "sr
+            if ("Driver" ==  key || "Driver Modules" ==  key)
+                cap.replace("\"", "");
+
+            // 如果信息中有unknown 则过滤
+            if (!cap.contains("unknown"))
+                mapInfo[key] += cap;
+        } else if ("Resolution" == key) {
+            mapInfo[key] += value;
+        } else if (!value.contains("unknown")) {
+            // 如果信息中有unknown 则过滤
+            mapInfo[key] = value;
+        }
+    }
+
+    if (mapInfo.find("Module Alias") != mapInfo.end()) {
+        mapInfo["Module Alias"].replace(QRegExp("[0-9a-zA-Z]{10}$"), "");
+    }
+}
+
 bool DriverManager::isNetworkOnline()
 {
     /*
@@ -676,17 +718,12 @@ bool DriverManager::checkBoardCardInfo()
 {
     QMap<QString, QString> mapInfo;
 
-    const QString &info = DeviceInfoManager::getInstance()->getInfo("hwinfo");
-
-    // 获取信息
-    QStringList items = info.split("\n\n");
-
-    foreach (const QString &item, items) {
-        if (item.isEmpty())
-            continue;
+    // 使用已解析的 hwinfo 记录
+    const QList<DeviceRecord> records = DeviceRecordStore::getInstance()->records("hwinfo");
 
+    foreach (const DeviceRecord &record, records) {
         mapInfo.clear();
-        getMapInfoFromHwinfo(item, mapInfo);
+        getMapInfoFromHwinfo(record, mapInfo);
         if (mapInfo["Hardware Class"] == "sound" || mapInfo["Device"].contains("USB Audio")) {
             if (checkBoardCardInfo(DR_Sound, mapInfo)) return true;
         } else if (mapInfo["Hardware Class"].contains("network")) {
@@ -16,6 +16,7 @@ class ModCore;
 class DebInstaller;
 class DriverInstaller;
 class QThread;
+struct DeviceRecord;
 
 class DriverManager : public QObject
 {
@@ -59,6 +60,7 @@ private:
      */
     void getMapInfo(QMap<QString, QString> &mapInfo, cups_dest_t *src);
     void getMapInfoFromHwinfo(const QString &info, QMap<QString, QString> &mapInfo, const QString &ch = QString(": "));
+    void getMapInfoFromHwinfo(const DeviceRecord &record, QMap<QString, QString> &mapInfo);
 
     bool isNetworkOnline();
 signals:
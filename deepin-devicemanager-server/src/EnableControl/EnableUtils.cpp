@@ -4,11 +4,11 @@
 
 #include "EnableUtils.h"
 #include "EnableSqlManager.h"
+#include "ProcessLauncher.h"
 
 #include <QStringList>
 #include <QMap>
 #include <QFile>
-#include <QProcess>
 
 #include <net/if.h>
 #include <sys/ioctl.h>
@@ -22,12 +22,11 @@ EnableUtils::EnableUtils()
 
 }
 
-void EnableUtils::disableOutDevice(const QString& info)
+void EnableUtils::disableOutDevice(const QList<DeviceRecord>& records)
 {
-    QStringList items = info.split("\n\n");
-    foreach(const QString& item,items){
+    foreach(const DeviceRecord& record,records){
         QMap<QString,QString> mapItem;
-        if(!getMapInfo(item,mapItem))
+        if(!getMapInfo(record,mapItem))
             continue;
 
         // 获取设备的唯一标识
@@ -86,11 +85,9 @@ void EnableUtils::disableOutDevice(const QString& info)
 
 void EnableUtils::disableOutDevice()
 {
-    QProcess process;
-    process.start("hwinfo --usb");
-    process.waitForFinished(-1);
-    QString info = process.readAllStandardOutput();
-    EnableUtils::disableOutDevice(info);
+    QString info;
+    ProcessLauncher::run("hwinfo", QStringList() << "--usb", DEFAULT_CMD_TIMEOUT, info);
+    EnableUtils::disableOutDevice(DeviceRecordStore::parseHwinfo(info));
 }
 
 void EnableUtils::disableInDevice()
@@ -157,19 +154,16 @@ bool EnableUtils::ioctlOperateNetworkLogicalName(const QString& logicalName, boo
     return true;
 }
 
-bool EnableUtils::getMapInfo(const QString& item,QMap<QString,QString>& mapInfo)
+bool EnableUtils::getMapInfo(const DeviceRecord& record,QMap<QString,QString>& mapInfo)
 {
-    QStringList lines = item.split("\n");
     // 行数太少则为无用信息
-    if(lines.size() <= LEAST_NUM){
+    if(record.fields.size() <= LEAST_NUM){
         return false;
     }
 
-    foreach(const QString& line,lines){
-        QStringList words = line.split(": ");
-        if(words.size() != 2)
-            continue;
-        mapInfo.insert(words[0].trimmed(),words[1].replace("\"","").trimmed());
+    for(const QPair<QString,QString>& field : record.fields){
+        QString value = field.second;
+        mapInfo.insert(field.first,value.replace("\"","").trimmed());
     }
 
     // hub为usb接口，可以直接过滤
@@ -8,6 +8,8 @@
 
 #include <QString>
 
+#include "DeviceRecordStore.h"
+
 class EnableUtils
 {
 public:
@@ -15,9 +17,9 @@ public:
 
     /**
      * @brief disableDevice 禁用外设
-     * @param info
+     * @param records hwinfo 解析后的记录
      */
-    static void disableOutDevice(const QString& info);
+    static void disableOutDevice(const QList<DeviceRecord>& records);
 
     /**
      * @brief disableDevice 禁用外设
@@ -38,12 +40,12 @@ public:
     static bool ioctlOperateNetworkLogicalName(const QString& logicalName, bool enable);
 
     /**
-     * @brief getMapInfo 解析usb信息
-     * @param item
+     * @brief getMapInfo 获取usb信息
+     * @param record
      * @param mapInfo
      * @return
      */
-    static bool getMapInfo(const QString& item,QMap<QString,QString>& mapInfo);
+    static bool getMapInfo(const DeviceRecord& record,QMap<QString,QString>& mapInfo);
 };
 
 #endif // ENABLEUTILS_H
@@ -7,8 +7,7 @@
 #define DETECTTHREAD_H
 
 #include <QThread>
-#include <QMap>
-#include <QDateTime>
+#include <QStringList>
 
 class MonitorUsb;
 
@@ -29,45 +28,19 @@ public:
 signals:
     /**
      * @brief usbChanged
+     * @param categories : 发生变化的设备类别
      */
-    void usbChanged();
+    void usbChanged(const QStringList &categories);
 
 private slots:
     /**
      * @brief slotUsbChanged usb发生变化时的曹函数处理
+     * @param categories : 发生变化的设备类别
      */
-    void slotUsbChanged();
-
-private:
-    /**
-     * @brief isUsbDevicesChanged 判断hwinfo --usb信息是否发生变化
-     * @return
-     */
-    bool isUsbDevicesChanged();
-
-    /**
-     * @brief updateMemUsbInfo 更新
-     * @param usbInfo
-     */
-    void updateMemUsbInfo(const QMap<QString,QMap<QString,QString>>& usbInfo);
-
-    /**
-     * @brief curHwinfoUsbInfo 获取当前的usb信息
-     * @param usbInfo
-     */
-    void curHwinfoUsbInfo(QMap<QString,QMap<QString,QString>>& usbInfo);
-
-    /**
-     * @brief getMapInfo 解析usb信息
-     * @param item
-     * @param mapInfo
-     * @return
-     */
-    bool getMapInfo(const QString& item,QMap<QString,QString>& mapInfo);
+    void slotUsbChanged(const QStringList &categories);
 
 private:
     MonitorUsb *mp_MonitorUsb; //<! udev检测任务
-    QMap<QString,QMap<QString,QString>> m_MapUsbInfo; //<! usb信息
 };
 
 #endif // DETECTTHREAD_H
@@ -6,21 +6,34 @@
 #include "EnableSqlManager.h"
 #include "EnableUtils.h"
 #include "WakeupUtils.h"
+#include "ProcessLauncher.h"
 
 #include <QDebug>
-#include <QProcess>
 #include <QFile>
 #include <QDateTime>
 
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <errno.h>
+
+#define DEBOUNCE_MS 300         // 内核处理完毕后等待的时间，合并同一次插拔的事件
+#define QUIET_MS 2000           // 存在没有驱动的接口时，没有新事件多久后认为处理完毕
+#define MAX_SETTLE_MS 10000     // 一次插拔最长的等待时间
+
 MonitorUsb::MonitorUsb()
     : m_Udev(nullptr)
-    , mp_Timer(new QTimer(this))
-    , m_UsbChangeTime()
-    , m_UsbChanged(false)
+    , mon(nullptr)
+    , fd(-1)
+    , m_TimerFd(-1)
+    , m_InBurst(false)
+    , m_DeviceAdded(false)
+    , m_BurstBegin(0)
+    , m_LastEvent(0)
 {
     m_Udev = udev_new();
     if (!m_Udev) {
         printf("error!!!\n");
+        return;
     }
     // 创建一个新的monitor
     mon = udev_monitor_new_from_netlink(m_Udev, "udev");
@@ -32,72 +45,192 @@ MonitorUsb::MonitorUsb()
     // 获取该监控的文件描述符，fd就代表了这个监控
     fd = udev_monitor_get_fd(mon);
 
-    // 定时器发送消息
-    connect(mp_Timer, &QTimer::timeout, this, &MonitorUsb::slotTimeout);
-    mp_Timer->start(1000);
+    m_TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+}
+
+MonitorUsb::~MonitorUsb()
+{
+    if (m_TimerFd >= 0)
+        close(m_TimerFd);
+    if (mon)
+        udev_monitor_unref(mon);
+    if (m_Udev)
+        udev_unref(m_Udev);
 }
 
 void MonitorUsb::monitor()
 {
-    char buf[10];
-    fd_set fds;
-    struct timeval tv;
+    if (fd < 0 || m_TimerFd < 0)
+        return;
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0)
+        return;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    ev.data.fd = m_TimerFd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, m_TimerFd, &ev);
+
+    struct epoll_event events[2];
     while (true) {
-        FD_ZERO(&fds);
-        FD_SET(fd, &fds);
-        tv.tv_sec = 0;
-        tv.tv_usec = 10000;
-        int ret = select(fd + 1, &fds, nullptr, nullptr, &tv);
-
-        // 判断是否有事件产生
-        if (!ret)
-            continue;
-        if (! FD_ISSET(fd, &fds))
-            continue;
-
-        // 获取产生事件的设备映射
-        struct udev_device *dev = udev_monitor_receive_device(mon);
-        if (!dev)
-            continue;
-
-        // 监测蓝牙设备
-        if (0 == strcmp(udev_device_get_devtype(dev), "link")) {
-            emit usbChanged();
-            continue;
+        // 没有事件时一直阻塞
+        int num = epoll_wait(epfd, events, 2, -1);
+        if (num < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
         }
 
-        // 获取事件并判断是否是插拔
-        unsigned long long curNum = udev_device_get_devnum(dev);
-        if (0 == curNum) {
-            udev_device_unref(dev);
-            continue;
+        for (int i = 0; i < num; ++i) {
+            if (events[i].data.fd == fd) {
+                // 一次读取所有已到达的事件
+                struct udev_device *dev = nullptr;
+                while ((dev = udev_monitor_receive_device(mon)) != nullptr) {
+                    handleDevice(dev);
+                    udev_device_unref(dev);
+                }
+            } else if (events[i].data.fd == m_TimerFd) {
+                uint64_t expirations = 0;
+                if (read(m_TimerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                    onTimeout();
+            }
         }
+    }
+    close(epfd);
+}
+
+void MonitorUsb::handleDevice(struct udev_device *dev)
+{
+    const char *action = udev_device_get_action(dev);
+    const char *devtype = udev_device_get_devtype(dev);
+    const char *devpath = udev_device_get_devpath(dev);
+    if (!action || !devpath)
+        return;
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
 
-        // 只有add和remove事件才会更新缓存信息
-        strcpy(buf, udev_device_get_action(dev));
-        if (0 == strcmp("add", buf) || 0 == strcmp("remove", buf)) {
-            QProcess process;
-            process.start("hwinfo --usb");
-            process.waitForFinished(-1);
-            QString info = process.readAllStandardOutput();
-            if(0 == strcmp("add", buf)){
-                EnableUtils::disableOutDevice(info);
+    // 监测蓝牙设备
+    if (devtype && 0 == strcmp(devtype, "link")) {
+        m_SetCategory.insert("bluetooth");
+    } else if (devtype && (0 == strcmp(devtype, "usb_device") || 0 == strcmp(devtype, "usb_interface"))) {
+        QString path(devpath);
+        if (0 == strcmp("add", action)) {
+            // 新增的设备和接口需要等待驱动绑定
+            m_SetPending.insert(path);
+            m_DeviceAdded = true;
+        } else if (0 == strcmp("bind", action) || 0 == strcmp("remove", action)) {
+            m_SetPending.remove(path);
+            // bind 只表示内核处理进度，不单独触发刷新
+            if (0 == strcmp("bind", action)) {
+                if (m_InBurst)
+                    m_LastEvent = now;
+                return;
             }
-            WakeupUtils::updateWakeupDeviceInfo(info);
-            m_UsbChanged = true;
-            m_UsbChangeTime = QDateTime::currentMSecsSinceEpoch();
+        } else {
+            return;
         }
 
-        udev_device_unref(dev);
+        // usb接口事件中记录设备类别，只刷新该类别相关的信息
+        if (0 == strcmp(devtype, "usb_interface")) {
+            QString category = interfaceCategory(udev_device_get_property_value(dev, "INTERFACE"));
+            if (!category.isEmpty())
+                m_SetCategory.insert(category);
+        } else {
+            m_SetCategory.insert("usb");
+        }
+    } else {
+        return;
+    }
+
+    if (!m_InBurst) {
+        m_InBurst = true;
+        m_BurstBegin = now;
     }
+    m_LastEvent = now;
+    armTimer(DEBOUNCE_MS);
+}
+
+void MonitorUsb::armTimer(int msec)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = msec / 1000;
+    spec.it_value.tv_nsec = static_cast<long>(msec % 1000) * 1000000;
+    timerfd_settime(m_TimerFd, 0, &spec, nullptr);
 }
 
-void MonitorUsb::slotTimeout()
+void MonitorUsb::onTimeout()
 {
-    if(!m_UsbChanged)
+    if (!m_InBurst)
         return;
-    if(QDateTime::currentMSecsSinceEpoch() - m_UsbChangeTime < 1000)
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 idle = now - m_LastEvent;
+    qint64 elapsed = now - m_BurstBegin;
+
+    // 1. 所有设备都已绑定驱动，且一段时间内没有新事件
+    // 2. 有的接口没有驱动，不会收到bind事件，较长时间没有新事件
+    // 3. 超过最长的等待时间
+    if ((m_SetPending.isEmpty() && idle >= DEBOUNCE_MS) || idle >= QUIET_MS || elapsed >= MAX_SETTLE_MS) {
+        finishBurst();
         return;
-    m_UsbChanged = false;
-    emit usbChanged();
+    }
+
+    qint64 wait = m_SetPending.isEmpty() ? DEBOUNCE_MS - idle : QUIET_MS - idle;
+    wait = qMin(wait, MAX_SETTLE_MS - elapsed);
+    armTimer(static_cast<int>(qMax<qint64>(wait, 1)));
+}
+
+void MonitorUsb::finishBurst()
+{
+    qInfo() << "usb changed, categories:" << m_SetCategory.toList()
+            << "settle time:" << QDateTime::currentMSecsSinceEpoch() - m_BurstBegin
+            << "pending:" << m_SetPending.size();
+
+    // 一次插拔只获取一次usb信息，用于禁用和唤醒设置
+    if (m_SetCategory.contains("usb")) {
+        QString info;
+        ProcessLauncher::run("hwinfo", QStringList() << "--usb", DEFAULT_CMD_TIMEOUT, info);
+        const QList<DeviceRecord> records = DeviceRecordStore::parseHwinfo(info);
+        if (m_DeviceAdded)
+            EnableUtils::disableOutDevice(records);
+        WakeupUtils::updateWakeupDeviceInfo(records);
+    }
+
+    QStringList categories = m_SetCategory.toList();
+    m_InBurst = false;
+    m_DeviceAdded = false;
+    m_SetPending.clear();
+    m_SetCategory.clear();
+
+    emit usbChanged(categories);
+}
+
+QString MonitorUsb::interfaceCategory(const char *interface)
+{
+    if (!interface)
+        return "";
+
+    // INTERFACE : bInterfaceClass/bInterfaceSubClass/bInterfaceProtocol，十进制
+    bool ok = false;
+    int cls = QString(interface).section("/", 0, 0).toInt(&ok);
+    if (!ok)
+        return "";
+
+    switch (cls) {
+    case 0x03:  // HID
+        return "input";
+    case 0x07:  // Printer
+        return "printer";
+    case 0x08:  // Mass Storage
+        return "storage";
+    case 0xE0:  // Wireless Controller，蓝牙适配器
+        return "bluetooth";
+    default:
+        return "";
+    }
 }
@@ -10,13 +10,20 @@
 #include <unistd.h>
 
 #include <QObject>
-#include <QTimer>
+#include <QSet>
+#include <QStringList>
 
+/**
+ * @brief The MonitorUsb class
+ * 使用 epoll 阻塞等待 udev 事件，空闲时不占用CPU。
+ * 一次插拔产生的多个事件合并处理，所有新增的设备和接口都绑定驱动(bind)后认为内核处理完毕
+ */
 class MonitorUsb : public QObject
 {
     Q_OBJECT
 public:
     MonitorUsb();
+    ~MonitorUsb() override;
 
     /**
      * @brief monitor
@@ -26,23 +33,51 @@ public:
 signals:
     /**
      * @brief usbChanged
+     * @param categories : 发生变化的设备类别，如 usb storage input printer bluetooth
      */
-    void usbChanged();
+    void usbChanged(const QStringList &categories);
+
+private:
+    /**
+     * @brief handleDevice : 处理一个udev事件
+     * @param dev
+     */
+    void handleDevice(struct udev_device *dev);
+
+    /**
+     * @brief armTimer : 重新设置定时器
+     * @param msec
+     */
+    void armTimer(int msec);
 
-private slots:
     /**
-     * @brief slotTimeout
+     * @brief onTimeout : 定时器到期，内核处理完毕或超时则通知刷新
      */
-    void slotTimeout();
+    void onTimeout();
+
+    /**
+     * @brief finishBurst : 结束本次插拔，通知刷新
+     */
+    void finishBurst();
+
+    /**
+     * @brief interfaceCategory : usb接口类别对应的设备类别
+     * @param interface : udev INTERFACE属性，如 8/6/80
+     * @return
+     */
+    static QString interfaceCategory(const char *interface);
 
 private:
     struct udev                       *m_Udev;              //<! udev Environment
     struct udev_monitor               *mon;                 //<! object of mon
     int                               fd;                   //<! fd
-    QTimer                            *mp_Timer;            //<! 定时器
-    qint64                            m_UsbChangeTime;      //<! 记录当前时间
-    bool                              m_UsbChanged;         //<! 记录是否有usb插拔
-
+    int                               m_TimerFd;            //<! 合并事件的定时器
+    bool                              m_InBurst;            //<! 正在处理一次插拔
+    bool                              m_DeviceAdded;        //<! 本次插拔是否有新增设备
+    qint64                            m_BurstBegin;         //<! 本次插拔第一个事件的时间
+    qint64                            m_LastEvent;          //<! 最后一个事件的时间
+    QSet<QString>                     m_SetPending;         //<! 已添加但还未绑定驱动的设备
+    QSet<QString>                     m_SetCategory;        //<! 本次插拔涉及的设备类别
 };
 
 #endif // MONITORUSB_H
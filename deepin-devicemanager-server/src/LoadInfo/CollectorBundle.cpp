@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CollectorBundle.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDebug>
+
+#include <unistd.h>
+#include <limits.h>
+
+#define MAX_CAPTURE_FILE_SIZE (1024 * 1024)    // 单个 sysfs 文件保存的最大长度
+
+std::atomic<CollectorBundle *> CollectorBundle::s_Instance;
+std::mutex CollectorBundle::m_mutex;
+
+// 读取时可能阻塞、有副作用或者只能 mmap 的属性，不保存
+static const char *s_SkipFiles[] = {"vpd", "rom", "config", "remove", "reset", "rescan",
+                                    "resource0", "resource1", "resource2", "resource3",
+                                    "resource4", "resource5", "resource0_wc", "resource2_wc"
+                                   };
+
+/**
+ * @brief isSkipFile
+ */
+static bool isSkipFile(const QString &name)
+{
+    for (const char *skip : s_SkipFiles) {
+        if (name == skip)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief writeFile : write the data, create the directory if not exist
+ */
+static bool writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(data);
+    return file.commit();
+}
+
+CollectorBundle::CollectorBundle()
+    : m_Mode(None)
+    , m_FilesCaptured(false)
+{
+    // 回放优先，避免把回放的结果再录制一遍
+    QString replay = QString::fromLocal8Bit(qgetenv(REPLAY_DIR_ENV));
+    QString capture = QString::fromLocal8Bit(qgetenv(CAPTURE_DIR_ENV));
+    if (!replay.isEmpty()) {
+        m_Mode = Replay;
+        m_Dir = replay;
+    } else if (!capture.isEmpty()) {
+        m_Mode = Capture;
+        m_Dir = capture;
+    }
+    if (None != m_Mode)
+        qInfo() << (isReplaying() ? "Replay collectors from" : "Capture collectors to") << m_Dir;
+}
+
+CollectorBundle::CollectorBundle(Mode mode, const QString &dir)
+    : m_Mode(mode)
+    , m_Dir(dir)
+    , m_FilesCaptured(false)
+{
+
+}
+
+void CollectorBundle::setReplayDir(const QString &dir)
+{
+    m_Mode = dir.isEmpty() ? None : Replay;
+    m_Dir = dir;
+}
+
+QString CollectorBundle::sysPath(const QString &path) const
+{
+    if (!isReplaying())
+        return path;
+    return m_Dir + "/fs" + path;
+}
+
+bool CollectorBundle::replayInfo(const QString &key, QString &info) const
+{
+    info.clear();
+    QFile file(QString("%1/info/%2.txt").arg(m_Dir).arg(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    info = QString::fromUtf8(file.readAll());
+    return true;
+}
+
+bool CollectorBundle::capture(const QMap<QString, QString> &infos)
+{
+    if (!isCapturing())
+        return false;
+
+    bool ok = true;
+    for (QMap<QString, QString>::const_iterator it = infos.begin(); it != infos.end(); ++it) {
+        // is_server_running 等状态不是采集结果
+        if (it.key().startsWith("is_"))
+            continue;
+        ok = writeFile(QString("%1/info/%2.txt").arg(m_Dir).arg(it.key()), it.value().toUtf8()) && ok;
+    }
+
+    if (!m_FilesCaptured) {
+        captureFiles();
+        m_FilesCaptured = true;
+    }
+    return ok;
+}
+
+void CollectorBundle::captureFiles()
+{
+    // CpuInfo
+    copyTree("/sys/devices/system/cpu", m_Dir + "/fs/sys/devices/system/cpu", 3);
+    copyTree("/proc/cpuinfo", m_Dir + "/fs/proc/cpuinfo", 0);
+
+    // DmiDecoder
+    copyTree("/sys/firmware/dmi/tables", m_Dir + "/fs/sys/firmware/dmi/tables", 0);
+
+    // PciEnumerator，devices 下都是指向 /sys/devices 的链接，保存链接指向的目录
+    QString pciPath = "/sys/bus/pci/devices";
+    QStringList names = QDir(pciPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    foreach (const QString &name, names)
+        copyTree(pciPath + "/" + name, m_Dir + "/fs" + pciPath + "/" + name, 0);
+}
+
+void CollectorBundle::copyTree(const QString &src, const QString &dst, int depth)
+{
+    QFileInfo info(src);
+    if (!info.isDir()) {
+        QFile file(src);
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        // procfs 和 sysfs 的文件大小不可靠，读到结束为止
+        QByteArray data = file.read(MAX_CAPTURE_FILE_SIZE);
+        if (file.error() == QFile::NoError)
+            writeFile(dst, data);
+        return;
+    }
+
+    QDir().mkpath(dst);
+    QDir dir(src);
+    QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System | QDir::Hidden);
+    foreach (const QFileInfo &entry, entries) {
+        QString target = dst + "/" + entry.fileName();
+        if (entry.isSymLink()) {
+            // 保留原始的相对链接，driver 等通过链接名获取，cpufreq 等在 bundle 中同样可以解析
+            char link[PATH_MAX];
+            ssize_t len = readlink(entry.filePath().toLocal8Bit().constData(), link, sizeof(link) - 1);
+            if (len <= 0)
+                continue;
+            link[len] = '\0';
+            QFile::remove(target);
+            if (symlink(link, target.toLocal8Bit().constData()) != 0)
+                qWarning() << "Failed to capture link :" << entry.filePath();
+        } else if (entry.isDir()) {
+            if (depth > 0)
+                copyTree(entry.filePath(), target, depth - 1);
+        } else if (!isSkipFile(entry.fileName())) {
+            copyTree(entry.filePath(), target, 0);
+        }
+    }
+}
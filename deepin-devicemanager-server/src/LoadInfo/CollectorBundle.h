@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COLLECTORBUNDLE_H
+#define COLLECTORBUNDLE_H
+
+#include <QString>
+#include <QMap>
+
+#include <mutex>
+#include <atomic>
+
+#define CAPTURE_DIR_ENV "DEVICEMANAGER_CAPTURE_DIR"    // 设置后每轮采集结束把结果保存到该目录
+#define REPLAY_DIR_ENV  "DEVICEMANAGER_REPLAY_DIR"     // 设置后从该目录读取，不执行命令也不读取本机的 sysfs
+
+/**
+ * @brief The CollectorBundle class
+ * 采集结果的录制和回放，一个目录保存一台机器：
+ *   info/<key>.txt   每个采集命令的输出，与 DeviceInfoManager 的 key 相同
+ *   fs/<path>        进程内采集读取的 sysfs 和 procfs 文件
+ * 回放时 ThreadPoolTask 从该目录读取，客户端使用同一个目录，可以在没有原机器的情况下测量整个流程
+ */
+class CollectorBundle
+{
+public:
+    enum Mode {
+        None,
+        Capture,
+        Replay
+    };
+
+    inline static CollectorBundle *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        CollectorBundle *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new CollectorBundle();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief isCapturing
+     * @return
+     */
+    bool isCapturing() const { return Capture == m_Mode; }
+
+    /**
+     * @brief isReplaying
+     * @return
+     */
+    bool isReplaying() const { return Replay == m_Mode; }
+
+    /**
+     * @brief setReplayDir : replay another bundle, used by the benchmark, must not be called while collecting
+     * @param dir : empty to stop replaying
+     */
+    void setReplayDir(const QString &dir);
+
+    /**
+     * @brief sysPath : the path in the bundle when replaying
+     * @param path : /sys/bus/pci/devices /proc/cpuinfo ...
+     * @return
+     */
+    QString sysPath(const QString &path) const;
+
+    /**
+     * @brief replayInfo : read info/<key>.txt
+     * @param key
+     * @param info : empty if not captured
+     * @return false if not captured
+     */
+    bool replayInfo(const QString &key, QString &info) const;
+
+    /**
+     * @brief capture : save all info and the sysfs and procfs files read in process
+     * @param infos : DeviceInfoManager::allInfo
+     * @return
+     */
+    bool capture(const QMap<QString, QString> &infos);
+
+protected:
+    CollectorBundle();
+    CollectorBundle(Mode mode, const QString &dir);
+
+private:
+    /**
+     * @brief captureFiles : copy the sysfs and procfs trees read by CpuInfo PciEnumerator and DmiDecoder
+     */
+    void captureFiles();
+
+    /**
+     * @brief copyTree : copy the regular files, symlinks below the top are copied as symlinks
+     * @param src
+     * @param dst
+     * @param depth : levels of sub directories
+     */
+    static void copyTree(const QString &src, const QString &dst, int depth);
+
+private:
+    static std::atomic<CollectorBundle *> s_Instance;
+    static std::mutex m_mutex;
+
+    Mode        m_Mode;             //<! 录制或回放
+    QString     m_Dir;              //<! bundle directory
+    bool        m_FilesCaptured;    //<! sysfs 只需要保存一次
+};
+
+#endif // COLLECTORBUNDLE_H
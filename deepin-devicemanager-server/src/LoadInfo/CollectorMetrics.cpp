@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CollectorMetrics.h"
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDebug>
+
+std::atomic<CollectorMetrics *> CollectorMetrics::s_Instance;
+std::mutex CollectorMetrics::m_mutex;
+
+/**
+ * @brief seconds : msec or usec to the seconds of Prometheus
+ */
+static QString seconds(qint64 value, double unit)
+{
+    return QString::number(static_cast<double>(value) / unit, 'g', 12);
+}
+
+/**
+ * @brief appendMetric : one metric with a sample for each collector
+ */
+static void appendMetric(QString &text, const QMap<QString, CollectorStat> &mapStat, const QString &name,
+                         const QString &type, const QString &help, QString (*value)(const CollectorStat &))
+{
+    text += QString("# HELP %1 %2\n# TYPE %1 %3\n").arg(name).arg(help).arg(type);
+    for (QMap<QString, CollectorStat>::const_iterator it = mapStat.begin(); it != mapStat.end(); ++it)
+        text += QString("%1{collector=\"%2\"} %3\n").arg(name).arg(it.key()).arg(value(it.value()));
+}
+
+CollectorMetrics::CollectorMetrics(const QString &path)
+    : m_Path(path)
+{
+    // node_exporter 只读取 --collector.textfile.directory 下的文件，由部署时通过环境变量指定
+    if (m_Path.isEmpty())
+        m_Path = QString::fromLocal8Bit(qgetenv(COLLECTOR_METRICS_ENV));
+    if (m_Path.isEmpty())
+        m_Path = COLLECTOR_METRICS_PATH;
+}
+
+const QVector<qint64> &CollectorMetrics::bucketBounds()
+{
+    static const QVector<qint64> bounds = QVector<qint64>() << 10 << 50 << 100 << 250 << 500
+                                          << 1000 << 2500 << 5000 << 10000 << 30000 << 60000;
+    return bounds;
+}
+
+void CollectorMetrics::record(const QString &collector, const ProcessStat &stat)
+{
+    const QVector<qint64> &bounds = bucketBounds();
+
+    QMutexLocker locker(&m_Mutex);
+    CollectorStat &s = m_MapStat[collector];
+    if (s.buckets.isEmpty())
+        s.buckets.fill(0, bounds.size() + 1);
+
+    ++s.runs;
+    if (!stat.started || stat.exitCode != 0)
+        ++s.failures;
+    if (stat.timedOut)
+        ++s.timeouts;
+    if (stat.termSignal != 0)
+        ++s.kills;
+    s.wallMsec += stat.wallMsec;
+    s.cpuUsec += stat.cpuUsec;
+    s.bytes += stat.bytes;
+    s.maxRssKb = qMax(s.maxRssKb, stat.maxRssKb);
+    s.lastExitCode = stat.exitCode;
+    s.lastWallMsec = stat.wallMsec;
+
+    int index = 0;
+    while (index < bounds.size() && stat.wallMsec > bounds[index])
+        ++index;
+    ++s.buckets[index];
+}
+
+QMap<QString, CollectorStat> CollectorMetrics::stats()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_MapStat;
+}
+
+QString CollectorMetrics::toPrometheus()
+{
+    const QMap<QString, CollectorStat> mapStat = stats();
+    const QVector<qint64> &bounds = bucketBounds();
+
+    QString text;
+    appendMetric(text, mapStat, "devicemanager_collector_runs_total", "counter", "Number of collector runs.",
+                 [](const CollectorStat &s) { return QString::number(s.runs); });
+    appendMetric(text, mapStat, "devicemanager_collector_failures_total", "counter", "Runs that failed to start or exited non-zero.",
+                 [](const CollectorStat &s) { return QString::number(s.failures); });
+    appendMetric(text, mapStat, "devicemanager_collector_timeouts_total", "counter", "Runs that exceeded the deadline.",
+                 [](const CollectorStat &s) { return QString::number(s.timeouts); });
+    appendMetric(text, mapStat, "devicemanager_collector_kills_total", "counter", "Runs terminated by a signal.",
+                 [](const CollectorStat &s) { return QString::number(s.kills); });
+    appendMetric(text, mapStat, "devicemanager_collector_cpu_seconds_total", "counter", "User and system CPU time of the child.",
+                 [](const CollectorStat &s) { return seconds(s.cpuUsec, 1000000.0); });
+    appendMetric(text, mapStat, "devicemanager_collector_output_bytes_total", "counter", "Bytes written to stdout.",
+                 [](const CollectorStat &s) { return QString::number(s.bytes); });
+    appendMetric(text, mapStat, "devicemanager_collector_max_rss_bytes", "gauge", "Peak resident set size of the child.",
+                 [](const CollectorStat &s) { return QString::number(s.maxRssKb * 1024); });
+    appendMetric(text, mapStat, "devicemanager_collector_last_exit_code", "gauge", "Exit code of the last run.",
+                 [](const CollectorStat &s) { return QString::number(s.lastExitCode); });
+    appendMetric(text, mapStat, "devicemanager_collector_last_duration_seconds", "gauge", "Wall time of the last run.",
+                 [](const CollectorStat &s) { return seconds(s.lastWallMsec, 1000.0); });
+
+    // 直方图的桶是累加的
+    const QString name = "devicemanager_collector_duration_seconds";
+    text += QString("# HELP %1 Wall time of collector runs.\n# TYPE %1 histogram\n").arg(name);
+    for (QMap<QString, CollectorStat>::const_iterator it = mapStat.begin(); it != mapStat.end(); ++it) {
+        const CollectorStat &s = it.value();
+        quint64 count = 0;
+        for (int i = 0; i < s.buckets.size(); ++i) {
+            count += s.buckets[i];
+            QString le = i < bounds.size() ? seconds(bounds[i], 1000.0) : QString("+Inf");
+            text += QString("%1_bucket{collector=\"%2\",le=\"%3\"} %4\n").arg(name).arg(it.key()).arg(le).arg(count);
+        }
+        text += QString("%1_sum{collector=\"%2\"} %3\n").arg(name).arg(it.key()).arg(seconds(s.wallMsec, 1000.0));
+        text += QString("%1_count{collector=\"%2\"} %3\n").arg(name).arg(it.key()).arg(s.runs);
+    }
+    return text;
+}
+
+bool CollectorMetrics::save()
+{
+    QDir().mkpath(QFileInfo(m_Path).absolutePath());
+
+    // 先写临时文件再替换，读取者不会读到一半的内容
+    QSaveFile file(m_Path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(toPrometheus().toUtf8());
+    return file.commit();
+}
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COLLECTORMETRICS_H
+#define COLLECTORMETRICS_H
+
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <QMutex>
+
+#include <mutex>
+#include <atomic>
+
+#include "ProcessLauncher.h"
+
+#define COLLECTOR_METRICS_PATH "/var/cache/deepin-devicemanager-server/collector.prom"  // Prometheus 文本格式的采集统计
+#define COLLECTOR_METRICS_ENV  "DEVICEMANAGER_METRICS_PATH"   // 设置后写到该文件，如 node_exporter textfile 目录下的 devicemanager.prom
+
+/**
+ * @brief The CollectorStat struct : 一个采集命令的累计统计
+ */
+struct CollectorStat {
+    quint64         runs = 0;           //<! 执行次数
+    quint64         failures = 0;       //<! 启动失败或返回值非0的次数
+    quint64         timeouts = 0;       //<! 超时的次数
+    quint64         kills = 0;          //<! 被信号结束的次数
+    qint64          wallMsec = 0;       //<! 累计耗时
+    qint64          cpuUsec = 0;        //<! 累计cpu时间
+    qint64          bytes = 0;          //<! 累计输出字节数
+    qint64          maxRssKb = 0;       //<! 最大常驻内存
+    int             lastExitCode = 0;   //<! 最后一次的返回值
+    qint64          lastWallMsec = 0;   //<! 最后一次的耗时
+    QVector<quint64> buckets;           //<! 耗时直方图，与 CollectorMetrics::bucketBounds 对应，不累加
+};
+
+/**
+ * @brief The CollectorMetrics class
+ * 记录每个采集命令每次执行的耗时、子进程cpu时间、输出大小、返回值以及超时和结束事件，
+ * 通过 dbus 和 Prometheus 文本文件提供，用来定位某个机型上刷新慢的命令
+ */
+class CollectorMetrics
+{
+public:
+    inline static CollectorMetrics *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        CollectorMetrics *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new CollectorMetrics();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief record : record one run of the collector
+     * @param collector : hwinfo smartctl:sda lspci ...
+     * @param stat
+     */
+    void record(const QString &collector, const ProcessStat &stat);
+
+    /**
+     * @brief stats
+     * @return collector -> accumulated stat
+     */
+    QMap<QString, CollectorStat> stats();
+
+    /**
+     * @brief toPrometheus : the Prometheus text exposition format
+     * @return
+     */
+    QString toPrometheus();
+
+    /**
+     * @brief save : write toPrometheus() to the file atomically
+     * @return
+     */
+    bool save();
+
+    /**
+     * @brief bucketBounds : upper bounds of the duration histogram in msec, +Inf is implied
+     * @return
+     */
+    static const QVector<qint64> &bucketBounds();
+
+protected:
+    /**
+     * @brief CollectorMetrics
+     * @param path : empty means COLLECTOR_METRICS_ENV or COLLECTOR_METRICS_PATH
+     */
+    explicit CollectorMetrics(const QString &path = QString());
+
+private:
+    static std::atomic<CollectorMetrics *> s_Instance;
+    static std::mutex m_mutex;
+
+    QString                         m_Path;         //<! Prometheus text file
+    QMutex                          m_Mutex;        //<! lock of m_MapStat
+    QMap<QString, CollectorStat>    m_MapStat;      //<! collector -> stat
+};
+
+#endif // COLLECTORMETRICS_H
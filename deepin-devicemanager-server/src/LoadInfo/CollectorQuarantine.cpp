@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CollectorQuarantine.h"
+#include "DeviceSnapshot.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDebug>
+
+std::atomic<CollectorQuarantine *> CollectorQuarantine::s_Instance;
+std::mutex CollectorQuarantine::m_mutex;
+
+CollectorQuarantine::CollectorQuarantine(const QString &path)
+    : m_Path(path)
+    , m_Fingerprint(DeviceSnapshot::hardwareFingerprint().toHex())
+    , m_BootId(DeviceSnapshot::bootId())
+{
+    load();
+}
+
+bool CollectorQuarantine::isQuarantined(const QString &entry)
+{
+    QMutexLocker locker(&m_Mutex);
+    QMap<QString, Entry>::const_iterator it = m_MapEntry.constFind(entry);
+    if (it == m_MapEntry.constEnd())
+        return false;
+
+    // 每次开机重新尝试一次，USB设备变化后也重新尝试，如慢速设备已经拔出
+    return it->boot == m_BootId && it->usb == DeviceSnapshot::usbTopology().toHex();
+}
+
+void CollectorQuarantine::add(const QString &entry)
+{
+    QByteArray usb = DeviceSnapshot::usbTopology().toHex();
+
+    QMutexLocker locker(&m_Mutex);
+    Entry &item = m_MapEntry[entry];
+    if (item.boot == m_BootId && item.usb == usb)
+        return;
+
+    qWarning() << "Quarantine collector :" << entry;
+    item.boot = m_BootId;
+    item.usb = usb;
+    if (!save())
+        qWarning() << "Failed to save collector quarantine";
+}
+
+void CollectorQuarantine::release(const QString &entry)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (m_MapEntry.remove(entry) == 0)
+        return;
+
+    qInfo() << "Release collector :" << entry;
+    if (!save())
+        qWarning() << "Failed to save collector quarantine";
+}
+
+QStringList CollectorQuarantine::entries()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_MapEntry.keys();
+}
+
+void CollectorQuarantine::clear()
+{
+    QMutexLocker locker(&m_Mutex);
+    m_MapEntry.clear();
+    QFile::remove(m_Path);
+}
+
+void CollectorQuarantine::load()
+{
+    QFile file(m_Path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    // 第一行为硬件指纹，之后每行一个命令及其超时时的 boot id 和 USB 拓扑，以 tab 分隔
+    QList<QByteArray> lines = file.readAll().split('\n');
+    file.close();
+    if (lines.isEmpty() || lines.first().trimmed() != m_Fingerprint) {
+        // 硬件发生了变化，重新尝试所有命令
+        QFile::remove(m_Path);
+        return;
+    }
+
+    for (int i = 1; i < lines.size(); ++i) {
+        QList<QByteArray> fields = lines[i].trimmed().split('\t');
+        QString entry = QString::fromUtf8(fields.first());
+        if (entry.isEmpty())
+            continue;
+
+        Entry &item = m_MapEntry[entry];
+        item.boot = fields.value(1);
+        item.usb = fields.value(2);
+    }
+}
+
+bool CollectorQuarantine::save()
+{
+    QDir().mkpath(QFileInfo(m_Path).absolutePath());
+
+    QSaveFile file(m_Path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    file.write(m_Fingerprint + "\n");
+    for (QMap<QString, Entry>::const_iterator it = m_MapEntry.constBegin(); it != m_MapEntry.constEnd(); ++it) {
+        file.write(it.key().toUtf8() + "\t" + it->boot + "\t" + it->usb + "\n");
+    }
+    return file.commit();
+}
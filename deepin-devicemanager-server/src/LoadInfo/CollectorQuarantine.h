@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COLLECTORQUARANTINE_H
+#define COLLECTORQUARANTINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+
+#include <mutex>
+#include <atomic>
+
+#define QUARANTINE_PATH "/var/cache/deepin-devicemanager-server/collector.quarantine"  // 超时采集命令的隔离列表
+
+/**
+ * @brief The CollectorQuarantine class
+ * 记录超时的采集命令，如 hwinfo、smartctl:serial:XXX，之后的采集跳过这些命令并保留已有信息，
+ * 列表保存到磁盘，硬件指纹变化后失效，每次开机或USB设备变化后重新尝试一次，成功后移除
+ */
+class CollectorQuarantine
+{
+public:
+    inline static CollectorQuarantine *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        CollectorQuarantine *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new CollectorQuarantine();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief isQuarantined
+     * @param entry : collector key, or collector:device
+     * @return false if the entry was added in another boot or before the USB topology changed
+     */
+    bool isQuarantined(const QString &entry);
+
+    /**
+     * @brief add : quarantine a collector that timed out, saved immediately
+     * @param entry : collector key, or collector:device
+     */
+    void add(const QString &entry);
+
+    /**
+     * @brief release : remove a collector that finished in time
+     * @param entry : collector key, or collector:device
+     */
+    void release(const QString &entry);
+
+    /**
+     * @brief entries
+     * @return
+     */
+    QStringList entries();
+
+    /**
+     * @brief clear : remove all entries and the file
+     */
+    void clear();
+
+protected:
+    explicit CollectorQuarantine(const QString &path = QUARANTINE_PATH);
+
+private:
+    /**
+     * @brief load : load the entries, ignored if the hardware fingerprint changed
+     */
+    void load();
+
+    /**
+     * @brief save
+     * @return
+     */
+    bool save();
+
+private:
+    /**
+     * @brief The Entry struct : where a collector timed out
+     */
+    struct Entry {
+        QByteArray boot;                            //<! boot id
+        QByteArray usb;                             //<! USB 拓扑
+    };
+
+    static std::atomic<CollectorQuarantine *> s_Instance;
+    static std::mutex m_mutex;
+
+    QString                     m_Path;             //<! quarantine file
+    QByteArray                  m_Fingerprint;      //<! 当前的硬件指纹
+    QByteArray                  m_BootId;           //<! 当前的 boot id
+    QMutex                      m_Mutex;            //<! lock of m_MapEntry
+    QMap<QString, Entry>        m_MapEntry;         //<! quarantined collectors
+};
+
+#endif // COLLECTORQUARANTINE_H
@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CpuFreqSampler.h"
+
+#include <QDateTime>
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QDebug>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+std::atomic<CpuFreqSampler *> CpuFreqSampler::s_Instance;
+std::mutex CpuFreqSampler::m_mutex;
+
+QDBusArgument &operator<<(QDBusArgument &argument, const CpuFreqSample &sample)
+{
+    argument.beginStructure();
+    argument << static_cast<qulonglong>(sample.seq) << static_cast<qlonglong>(sample.msec) << sample.cpu << static_cast<uint>(sample.khz);
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, CpuFreqSample &sample)
+{
+    qulonglong seq = 0;
+    qlonglong msec = 0;
+    uint khz = 0;
+    argument.beginStructure();
+    argument >> seq >> msec >> sample.cpu >> khz;
+    argument.endStructure();
+    sample.seq = seq;
+    sample.msec = msec;
+    sample.khz = khz;
+    return argument;
+}
+
+CpuFreqSampler::CpuFreqSampler(const QString &sysCpuPath, int capacity)
+    : QThread(nullptr)
+    , m_SysCpuPath(sysCpuPath)
+    , m_Capacity(qMax(capacity, 1))
+    , m_Opened(false)
+    , m_Running(false)
+    , m_Interval(CPU_FREQ_DEFAULT_INTERVAL)
+    , m_LastRequest(0)
+    , m_FirstSeq(static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) << 10)
+    , m_Seq(m_FirstSeq)
+    , m_Times(m_Capacity, 0)
+{
+    // a(txiu)
+    qDBusRegisterMetaType<CpuFreqSample>();
+    qDBusRegisterMetaType<QList<CpuFreqSample> >();
+}
+
+QList<CpuFreqSample> CpuFreqSampler::samples(quint64 since)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_LastRequest = QDateTime::currentMSecsSinceEpoch();
+    if (!m_Running) {
+        // 上一次的采样线程已经决定退出，等待其结束后重新启动，先同步采样一次，第一次获取就有数据
+        m_Running = true;
+        locker.unlock();
+        wait();
+        sampleOnce();
+        start(QThread::LowPriority);
+        locker.relock();
+    }
+
+    QList<CpuFreqSample> lst;
+    if (m_Seq == m_FirstSeq)
+        return lst;
+
+    quint64 capacity = static_cast<quint64>(m_Capacity);
+    quint64 first = qMax(m_FirstSeq + 1, m_Seq - capacity + 1);
+    if (0 == since)
+        first = m_Seq;
+    else if (since + 1 > first)
+        first = since + 1;
+
+    for (quint64 seq = first; seq <= m_Seq; ++seq) {
+        int slot = static_cast<int>(seq % capacity);
+        for (int i = 0; i < m_Cpus.size(); ++i) {
+            quint32 khz = m_Rings[i][slot];
+            if (0 == khz)
+                continue;
+            CpuFreqSample sample;
+            sample.seq = seq;
+            sample.msec = m_Times[slot];
+            sample.cpu = m_Cpus[i];
+            sample.khz = khz;
+            lst.append(sample);
+        }
+    }
+    return lst;
+}
+
+void CpuFreqSampler::setInterval(int msec)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Interval = qBound(CPU_FREQ_MIN_INTERVAL, msec, CPU_FREQ_MAX_INTERVAL);
+    m_Cond.wakeAll();
+}
+
+int CpuFreqSampler::interval()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Interval;
+}
+
+void CpuFreqSampler::run()
+{
+    forever {
+        QMutexLocker locker(&m_Mutex);
+        m_Cond.wait(&m_Mutex, static_cast<unsigned long>(m_Interval));
+        if (QDateTime::currentMSecsSinceEpoch() - m_LastRequest > CPU_FREQ_IDLE_TIMEOUT) {
+            m_Running = false;
+            locker.unlock();
+            closeCpus();
+            return;
+        }
+        locker.unlock();
+        sampleOnce();
+    }
+}
+
+void CpuFreqSampler::openCpus()
+{
+    // /sys/devices/system/cpu/cpu*
+    QVector<int> cpus;
+    QVector<int> fds;
+    DIR *dir = opendir(m_SysCpuPath.toLocal8Bit().constData());
+    if (dir) {
+        while (struct dirent *entry = readdir(dir)) {
+            const char *name = entry->d_name;
+            size_t len = strlen(name);
+            if (len < 4 || 0 != strncmp(name, "cpu", 3) || strspn(name + 3, "0123456789") != len - 3)
+                continue;
+            cpus.append(atoi(name + 3));
+        }
+        std::sort(cpus.begin(), cpus.end());
+
+        // scaling_cur_freq 在 x86 上由 APERF/MPERF 计算，其它驱动只提供 cpuinfo_cur_freq
+        QVector<int> opened;
+        foreach (int cpu, cpus) {
+            char path[64];
+            snprintf(path, sizeof(path), "cpu%d/cpufreq/scaling_cur_freq", cpu);
+            int fd = openat(dirfd(dir), path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                snprintf(path, sizeof(path), "cpu%d/cpufreq/cpuinfo_cur_freq", cpu);
+                fd = openat(dirfd(dir), path, O_RDONLY | O_CLOEXEC);
+            }
+            if (fd < 0)
+                continue;
+            opened.append(cpu);
+            fds.append(fd);
+        }
+        cpus = opened;
+        closedir(dir);
+    }
+
+    QMutexLocker locker(&m_Mutex);
+    m_Fds = fds;
+    m_Opened = true;
+    if (cpus != m_Cpus) {
+        // cpu 发生变化后旧的采样不再对应
+        m_Cpus = cpus;
+        m_Rings = QVector<QVector<quint32> >(m_Cpus.size(), QVector<quint32>(m_Capacity, 0));
+    }
+}
+
+void CpuFreqSampler::closeCpus()
+{
+    QMutexLocker locker(&m_Mutex);
+    foreach (int fd, m_Fds)
+        close(fd);
+    m_Fds.clear();
+    m_Opened = false;
+}
+
+void CpuFreqSampler::sampleOnce()
+{
+    // 只有一个采样者：同步采样在线程启动前，之后都在采样线程中
+    if (!m_Opened)
+        openCpus();
+
+    // 在锁外读取，sysfs 属性从偏移0读取时重新生成
+    QVector<quint32> values(m_Fds.size(), 0);
+    for (int i = 0; i < m_Fds.size(); ++i) {
+        char buf[32];
+        ssize_t len;
+        do {
+            len = pread(m_Fds[i], buf, sizeof(buf) - 1, 0);
+        } while (len < 0 && EINTR == errno);
+        if (len <= 0)
+            continue;
+        buf[len] = '\0';
+        values[i] = static_cast<quint32>(strtoul(buf, nullptr, 10));
+    }
+
+    QMutexLocker locker(&m_Mutex);
+    if (values.size() != m_Rings.size())
+        return;
+    ++m_Seq;
+    int slot = static_cast<int>(m_Seq % static_cast<quint64>(m_Capacity));
+    m_Times[slot] = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < values.size(); ++i)
+        m_Rings[i][slot] = values[i];
+}
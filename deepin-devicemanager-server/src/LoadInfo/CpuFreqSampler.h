@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPUFREQSAMPLER_H
+#define CPUFREQSAMPLER_H
+
+#include <QThread>
+#include <QList>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QMetaType>
+
+#include <mutex>
+#include <atomic>
+
+#define CPU_FREQ_RING_SIZE          120     // 每个cpu保存的采样数
+#define CPU_FREQ_DEFAULT_INTERVAL   1000    // 默认采样间隔 ms
+#define CPU_FREQ_MIN_INTERVAL       100
+#define CPU_FREQ_MAX_INTERVAL       10000
+#define CPU_FREQ_IDLE_TIMEOUT       10000   // 没有客户端获取时停止采样 ms
+
+class QDBusArgument;
+
+/**
+ * @brief The CpuFreqSample struct : 一个cpu的一次采样
+ */
+struct CpuFreqSample {
+    quint64 seq = 0;        //<! 采样序号，同一次采样的所有cpu相同
+    qint64  msec = 0;       //<! 采样时间
+    int     cpu = -1;       //<! 逻辑cpu
+    quint32 khz = 0;        //<! 当前频率
+};
+Q_DECLARE_METATYPE(CpuFreqSample)
+
+// a(txiu) 中的 (txiu)
+QDBusArgument &operator<<(QDBusArgument &argument, const CpuFreqSample &sample);
+const QDBusArgument &operator>>(const QDBusArgument &argument, CpuFreqSample &sample);
+
+/**
+ * @brief The CpuFreqSampler class
+ * 按固定间隔读取所有cpu的 scaling_cur_freq，每个cpu保存在固定大小的环形缓冲中，
+ * 有客户端获取时才采样，多个客户端共享同一份采样
+ */
+class CpuFreqSampler : public QThread
+{
+    Q_OBJECT
+public:
+    inline static CpuFreqSampler *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        CpuFreqSampler *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new CpuFreqSampler();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief samples : the samples after since, starts sampling if it is stopped
+     * @param since : 0 means only the latest sample of each cpu
+     * @return
+     */
+    QList<CpuFreqSample> samples(quint64 since);
+
+    /**
+     * @brief setInterval
+     * @param msec : clamped to [CPU_FREQ_MIN_INTERVAL, CPU_FREQ_MAX_INTERVAL]
+     */
+    void setInterval(int msec);
+
+    /**
+     * @brief interval
+     * @return
+     */
+    int interval();
+
+protected:
+    explicit CpuFreqSampler(const QString &sysCpuPath = "/sys/devices/system/cpu", int capacity = CPU_FREQ_RING_SIZE);
+
+    /**
+     * @brief run : sample until no client asks for CPU_FREQ_IDLE_TIMEOUT
+     */
+    void run() override;
+
+private:
+    /**
+     * @brief openCpus : open cpufreq/scaling_cur_freq of all cpus, cpuinfo_cur_freq if not exist
+     */
+    void openCpus();
+
+    /**
+     * @brief closeCpus
+     */
+    void closeCpus();
+
+    /**
+     * @brief sampleOnce : read all cpus with pread and append to the rings
+     */
+    void sampleOnce();
+
+private:
+    static std::atomic<CpuFreqSampler *> s_Instance;
+    static std::mutex m_mutex;
+
+    QString                 m_SysCpuPath;       //<! /sys/devices/system/cpu
+    int                     m_Capacity;         //<! 环形缓冲大小
+    QVector<int>            m_Cpus;             //<! 逻辑cpu
+    QVector<int>            m_Fds;              //<! 与 m_Cpus 对应的频率文件，保持打开
+    bool                    m_Opened;           //<! 是否已经打开，没有 cpufreq 时不重复查找
+
+    QMutex                  m_Mutex;            //<! 保护以下成员
+    QWaitCondition          m_Cond;             //<! 采样间隔等待
+    bool                    m_Running;          //<! 采样线程是否在运行
+    int                     m_Interval;         //<! 采样间隔 ms
+    qint64                  m_LastRequest;      //<! 最后一次获取的时间
+    quint64                 m_FirstSeq;         //<! 序号以启动时间为起点，服务重启后总是大于客户端已有的序号
+    quint64                 m_Seq;              //<! 最新的采样序号
+    QVector<qint64>         m_Times;            //<! seq % capacity -> 采样时间
+    QVector<QVector<quint32> > m_Rings;         //<! cpu下标 -> seq % capacity -> khz，0 为读取失败
+};
+
+#endif // CPUFREQSAMPLER_H
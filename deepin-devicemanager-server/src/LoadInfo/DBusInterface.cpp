@@ -6,14 +6,73 @@
 #include "DeviceInfoManager.h"
 #include "MainJob.h"
 #include "EnableSqlManager.h"
+#include "KernelConfig.h"
+#include "CollectorMetrics.h"
 
 #include <QDebug>
 #include <QFile>
+#include <QDBusMetaType>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+
+#define LARGE_INFO_SIZE (64 * 1024)    // 超过该长度的信息通过 memfd 传递
+
+/**
+ * @brief createSealedFd : write the data into a memfd and seal it, the content can not be changed after that
+ * @return : fd, -1 if failed
+ */
+static int createSealedFd(const QByteArray &data)
+{
+#ifdef SYS_memfd_create
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "devicemanager-info", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+#else
+    int fd = -1;
+#endif
+    if (fd < 0)
+        return -1;
+
+    const char *p = data.constData();
+    qint64 left = data.size();
+    while (left > 0) {
+        ssize_t n = write(fd, p, static_cast<size_t>(left));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return -1;
+        }
+        p += n;
+        left -= n;
+    }
+
+    // 密封后客户端只能读取，多个客户端可以共享同一个 memfd
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
 
 DBusInterface::DBusInterface(QObject *parent)
     : QObject(parent)
 {
-
+    // a{ss}
+    qDBusRegisterMetaType<QMap<QString, QString> >();
+    // a(sa{ss})
+    qDBusRegisterMetaType<DeviceRecord>();
+    qDBusRegisterMetaType<QList<DeviceRecord> >();
+    // a(txiu)
+    qDBusRegisterMetaType<CpuFreqSample>();
+    qDBusRegisterMetaType<QList<CpuFreqSample> >();
 }
 
 QString DBusInterface::getInfo(const QString &key)
@@ -28,6 +87,100 @@ QString DBusInterface::getInfo(const QString &key)
     return "0";
 }
 
+qulonglong DBusInterface::getGeneration()
+{
+    return DeviceInfoManager::getInstance()->generation();
+}
+
+QMap<QString, QString> DBusInterface::getInfos(const QStringList &keys)
+{
+    DeviceInfoSnapshotPtr snapshot = DeviceInfoManager::getInstance()->snapshot();
+    QMap<QString, QString> infos;
+    foreach (const QString &key, keys) {
+        if ("is_server_running" == key)
+            infos.insert(key, MainJob::serverIsRunning() ? "1" : "0");
+        else
+            infos.insert(key, snapshot->info.value(key));
+    }
+    return infos;
+}
+
+QMap<QString, QString> DBusInterface::getChangedInfos(qulonglong generation, qulonglong &current, QStringList &largeKeys)
+{
+    DeviceInfoSnapshotPtr snapshot = DeviceInfoManager::getInstance()->snapshot();
+    current = snapshot->generation;
+
+    // 客户端的版本比服务端新，说明服务重启过，返回全部信息
+    if (generation > current)
+        generation = 0;
+
+    // 连接支持传递文件描述符时，大的信息由客户端通过 getInfoFd 获取
+    bool fdPassing = calledFromDBus() && (connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing);
+
+    QMap<QString, QString> infos;
+    largeKeys.clear();
+    for (QMap<QString, quint64>::const_iterator it = snapshot->changed.begin(); it != snapshot->changed.end(); ++it) {
+        if (it.value() <= generation)
+            continue;
+        const QString &value = snapshot->info.value(it.key());
+        if (fdPassing && value.size() > LARGE_INFO_SIZE)
+            largeKeys.append(it.key());
+        else
+            infos.insert(it.key(), value);
+    }
+    return infos;
+}
+
+QDBusUnixFileDescriptor DBusInterface::getInfoFd(const QString &key)
+{
+    DeviceInfoSnapshotPtr snapshot = DeviceInfoManager::getInstance()->snapshot();
+    quint64 changed = snapshot->changed.value(key);
+
+    QMutexLocker locker(&m_FdMutex);
+    QMap<QString, QPair<quint64, QDBusUnixFileDescriptor> >::const_iterator it = m_MapFd.constFind(key);
+    if (it != m_MapFd.constEnd() && it.value().first == changed)
+        return it.value().second;
+
+    int fd = createSealedFd(snapshot->info.value(key).toUtf8());
+    if (fd < 0) {
+        qWarning() << "Failed to create memfd for" << key;
+        return QDBusUnixFileDescriptor();
+    }
+
+    QDBusUnixFileDescriptor descriptor;
+    descriptor.giveFileDescriptor(fd);
+    m_MapFd.insert(key, qMakePair(changed, descriptor));
+    return descriptor;
+}
+
+bool DBusInterface::isKernelConfigBuiltIn(const QString &symbol)
+{
+    return KernelConfig::getInstance()->isBuiltIn(symbol);
+}
+
+QList<DeviceRecord> DBusInterface::getRecords(const QStringList &sources)
+{
+    QList<DeviceRecord> records;
+    foreach (const QString &source, sources)
+        records.append(DeviceRecordStore::getInstance()->records(source));
+    return records;
+}
+
+QList<CpuFreqSample> DBusInterface::getCpuFreqSamples(qulonglong since)
+{
+    return CpuFreqSampler::getInstance()->samples(since);
+}
+
+void DBusInterface::setCpuFreqInterval(int msec)
+{
+    CpuFreqSampler::getInstance()->setInterval(msec);
+}
+
+QString DBusInterface::getCollectorStats()
+{
+    return CollectorMetrics::getInstance()->toPrometheus();
+}
+
 void DBusInterface::refreshInfo()
 {
     emit update();
@@ -8,6 +8,14 @@
 
 #include <QObject>
 #include <QDBusContext>
+#include <QDBusUnixFileDescriptor>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QStringList>
+
+#include "DeviceRecordStore.h"
+#include "CpuFreqSampler.h"
 
 class MainJob;
 class DBusInterface : public QObject, protected QDBusContext
@@ -28,11 +36,77 @@ public slots:
      */
     Q_SCRIPTABLE QString getInfo(const QString &key);
 
+    /**
+     * @brief getGeneration : the generation of the device info, increased on every change
+     * @return
+     */
+    Q_SCRIPTABLE qulonglong getGeneration();
+
+    /**
+     * @brief getInfos : Obtain several keys in one call, all values come from the same generation
+     * @param keys
+     * @return : key -> Hardware info
+     */
+    Q_SCRIPTABLE QMap<QString, QString> getInfos(const QStringList &keys);
+
+    /**
+     * @brief getChangedInfos : Obtain the keys changed after the generation, 0 means all keys
+     * @param generation : the generation the client already has
+     * @param current : the current generation
+     * @param largeKeys : changed keys too large to be sent as string, use getInfoFd to obtain them
+     * @return : key -> Hardware info, removed keys have an empty value
+     */
+    Q_SCRIPTABLE QMap<QString, QString> getChangedInfos(qulonglong generation, qulonglong &current, QStringList &largeKeys);
+
+    /**
+     * @brief getInfoFd : Obtain hardware information as a sealed memfd, the content is UTF-8
+     * @param key
+     * @return : read only file descriptor, invalid if failed
+     */
+    Q_SCRIPTABLE QDBusUnixFileDescriptor getInfoFd(const QString &key);
+
+    /**
+     * @brief isKernelConfigBuiltIn : whether the symbol is =y in the config of the running kernel
+     * @param symbol : CONFIG_USB_STORAGE or USB_STORAGE
+     * @return
+     */
+    Q_SCRIPTABLE bool isKernelConfigBuiltIn(const QString &symbol);
+
+    /**
+     * @brief getRecords : Obtain the parsed records instead of the text
+     * @param sources : hwinfo lshw dmidecode_N
+     * @return : a(sa{ss}), duplicate keys in a record keep the last value
+     */
+    Q_SCRIPTABLE QList<DeviceRecord> getRecords(const QStringList &sources);
+
+    /**
+     * @brief getCpuFreqSamples : Obtain the cpu frequency samples, sampling runs while clients ask
+     * @param since : the largest seq already obtained, 0 for the latest sample of each cpu
+     * @return : a(txiu) seq, msec, cpu, khz
+     */
+    Q_SCRIPTABLE QList<CpuFreqSample> getCpuFreqSamples(qulonglong since);
+
+    /**
+     * @brief setCpuFreqInterval : set the sampling interval
+     * @param msec
+     */
+    Q_SCRIPTABLE void setCpuFreqInterval(int msec);
+
+    /**
+     * @brief getCollectorStats : Obtain the time and resource usage of each collector
+     * @return : Prometheus text exposition format
+     */
+    Q_SCRIPTABLE QString getCollectorStats();
+
     /**
      * @brief refreshInfo
      * @return
      */
     Q_SCRIPTABLE void refreshInfo();
+
+private:
+    QMutex m_FdMutex;                                                   //<! 保护 m_MapFd
+    QMap<QString, QPair<quint64, QDBusUnixFileDescriptor> > m_MapFd;    //<! key -> (版本号, memfd)，内容不变时复用
 };
 
 #endif // DBUSINTERFACE_H
@@ -3,54 +3,108 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "DeviceInfoManager.h"
+#include "DeviceRecordStore.h"
 
-#include <QMutex>
 #include <QDebug>
+#include <QDateTime>
 
-QMutex mutex;
 std::atomic<DeviceInfoManager *> DeviceInfoManager::s_Instance;
 std::mutex DeviceInfoManager::m_mutex;
 
 DeviceInfoManager::DeviceInfoManager(QObject *parent)
     : QObject(parent)
 {
-
+    // 版本号以启动时间为起点，服务重启后的版本号总是大于客户端已有的版本号
+    std::shared_ptr<DeviceInfoSnapshot> first = std::make_shared<DeviceInfoSnapshot>();
+    first->generation = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) << 10;
+    mp_Snapshot = first;
 }
 
 void DeviceInfoManager::addInfo(const QString &key, const QString &value)
 {
-    QMutexLocker locker(&mutex);
-    if (m_MapInfo.find(key) != m_MapInfo.end()) {
-        m_MapInfo[key] = value;
-    } else {
-        m_MapInfo.insert(key, value);
-    }
+    QMap<QString, QString> infos;
+    infos.insert(key, value);
+    publish(infos, false);
 }
 
-const QString &DeviceInfoManager::getInfo(const QString &key)
+void DeviceInfoManager::addInfos(const QMap<QString, QString> &infos)
 {
-    QMutexLocker locker(&mutex);
-    return m_MapInfo[key];
+    publish(infos, false);
+}
+
+QString DeviceInfoManager::getInfo(const QString &key)
+{
+    // 返回值是隐式共享的，不会复制信息内容
+    return snapshot()->info.value(key);
 }
 
 bool DeviceInfoManager::isInfoExisted(const QString &key)
 {
-    QMutexLocker locker(&mutex);
-    if (m_MapInfo.find(key) != m_MapInfo.end()) {
-        return true;
-    } else {
-        return false;
-    }
+    return snapshot()->info.contains(key);
 }
 
 bool DeviceInfoManager::isPathExisted(const QString &path)
 {
-    QMutexLocker locker(&mutex);
-    const QString& hwinfo = m_MapInfo["hwinfo"];
-    QString pathT = path;
-    if(hwinfo.contains(pathT.replace("/sys",""))){
-        return true;
-    }
-    return false;
+    // 使用已解析的 hwinfo 记录，不再在整个 hwinfo 文本中查找
+    return DeviceRecordStore::getInstance()->isSysfsPathExisted(path);
+}
+
+QMap<QString, QString> DeviceInfoManager::allInfo()
+{
+    return snapshot()->info;
+}
+
+void DeviceInfoManager::setAllInfo(const QMap<QString, QString> &info)
+{
+    publish(info, true);
+}
+
+DeviceInfoSnapshotPtr DeviceInfoManager::snapshot() const
+{
+    return std::atomic_load(&mp_Snapshot);
 }
 
+quint64 DeviceInfoManager::generation() const
+{
+    return snapshot()->generation;
+}
+
+void DeviceInfoManager::publish(const QMap<QString, QString> &infos, bool replaceAll)
+{
+    std::lock_guard<std::mutex> lock(m_WriteMutex);
+    DeviceInfoSnapshotPtr cur = std::atomic_load(&mp_Snapshot);
+    quint64 generation = cur->generation + 1;
+
+    // QMap 隐式共享，复制只增加引用计数，修改时才分离
+    std::shared_ptr<DeviceInfoSnapshot> next = std::make_shared<DeviceInfoSnapshot>(*cur);
+    bool modified = false;
+    if (replaceAll) {
+        foreach (const QString &key, next->info.keys()) {
+            if (!infos.contains(key)) {
+                next->info.remove(key);
+                next->changed.insert(key, generation);
+                modified = true;
+            }
+        }
+    }
+    for (QMap<QString, QString>::const_iterator it = infos.begin(); it != infos.end(); ++it) {
+        QMap<QString, QString>::const_iterator old = next->info.constFind(it.key());
+        if (old != next->info.constEnd() && old.value() == it.value())
+            continue;
+        next->info.insert(it.key(), it.value());
+        next->changed.insert(it.key(), generation);
+        modified = true;
+    }
+
+    if (!modified)
+        return;
+
+    // 变化的 hwinfo dmidecode 等信息解析一次，供服务内的模块和客户端使用
+    for (QMap<QString, quint64>::const_iterator it = next->changed.begin(); it != next->changed.end(); ++it) {
+        if (it.value() == generation && DeviceRecordStore::isRecordSource(it.key()))
+            DeviceRecordStore::getInstance()->update(it.key(), next->info.value(it.key()));
+    }
+
+    next->generation = generation;
+    std::atomic_store(&mp_Snapshot, DeviceInfoSnapshotPtr(next));
+}
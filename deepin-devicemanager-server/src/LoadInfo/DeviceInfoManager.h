@@ -9,6 +9,19 @@
 #include <QObject>
 #include <QMap>
 #include <mutex>
+#include <memory>
+#include <atomic>
+
+/**
+ * @brief The DeviceInfoSnapshot struct : 某一时刻的全部设备信息，发布后不再修改
+ */
+struct DeviceInfoSnapshot {
+    quint64 generation = 0;                 //<! 版本号，每次发布加1
+    QMap<QString, QString> info;            //<! key -> info
+    QMap<QString, quint64> changed;         //<! key -> 最后一次变化时的版本号
+};
+
+typedef std::shared_ptr<const DeviceInfoSnapshot> DeviceInfoSnapshotPtr;
 
 class DeviceInfoManager : public QObject
 {
@@ -41,12 +54,18 @@ public:
      */
     void addInfo(const QString &key, const QString &value);
 
+    /**
+     * @brief addInfos : publish several keys in one generation
+     * @param infos
+     */
+    void addInfos(const QMap<QString, QString> &infos);
+
     /**
      * @brief getInfo
      * @param key
      * @return
      */
-    const QString &getInfo(const QString &key);
+    QString getInfo(const QString &key);
 
     /**
      * @brief isInfoExisted
@@ -62,14 +81,47 @@ public:
      */
     bool isPathExisted(const QString &path);
 
+    /**
+     * @brief allInfo : copy of all info, used to save the snapshot
+     * @return
+     */
+    QMap<QString, QString> allInfo();
+
+    /**
+     * @brief setAllInfo : replace all info with the snapshot
+     * @param info
+     */
+    void setAllInfo(const QMap<QString, QString> &info);
+
+    /**
+     * @brief snapshot : 当前发布的设备信息，读取时不加锁，持有期间内容不会变化
+     * @return
+     */
+    DeviceInfoSnapshotPtr snapshot() const;
+
+    /**
+     * @brief generation : 当前发布的版本号
+     * @return
+     */
+    quint64 generation() const;
+
 protected:
     explicit DeviceInfoManager(QObject *parent = nullptr);
 
+private:
+    /**
+     * @brief publish : 在当前版本的基础上修改并发布新版本，值没有变化时不发布
+     * @param infos
+     * @param replaceAll : 用 infos 替换所有信息
+     */
+    void publish(const QMap<QString, QString> &infos, bool replaceAll);
+
 private:
     static std::atomic<DeviceInfoManager *> s_Instance;
     static std::mutex m_mutex;
 
-    QMap<QString, QString>     m_MapInfo;
+    std::mutex                  m_WriteMutex;   //<! 只在写入者之间互斥，读取不加锁
+    DeviceInfoSnapshotPtr       mp_Snapshot;    //<! 当前版本，通过 std::atomic_load/atomic_store 访问
 };
 
 #endif // DEVICEINFOMANAGER_H
@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DeviceRecordStore.h"
+
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QRegExp>
+
+std::atomic<DeviceRecordStore *> DeviceRecordStore::s_Instance;
+std::mutex DeviceRecordStore::m_mutex;
+
+QString DeviceRecord::value(const QString &key) const
+{
+    for (int i = fields.size() - 1; i >= 0; --i) {
+        if (fields[i].first == key)
+            return fields[i].second;
+    }
+    return QString();
+}
+
+bool DeviceRecord::contains(const QString &key) const
+{
+    for (const QPair<QString, QString> &field : fields) {
+        if (field.first == key)
+            return true;
+    }
+    return false;
+}
+
+QMap<QString, QString> DeviceRecord::toMap() const
+{
+    QMap<QString, QString> map;
+    for (const QPair<QString, QString> &field : fields) {
+        map.insert(field.first, field.second);
+    }
+    return map;
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const DeviceRecord &record)
+{
+    argument.beginStructure();
+    argument << record.source << record.toMap();
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, DeviceRecord &record)
+{
+    QMap<QString, QString> map;
+    argument.beginStructure();
+    argument >> record.source >> map;
+    argument.endStructure();
+
+    record.fields.clear();
+    for (QMap<QString, QString>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        record.fields.append(qMakePair(it.key(), it.value()));
+    }
+    return argument;
+}
+
+DeviceRecordStore::DeviceRecordStore()
+{
+    // a(sa{ss})
+    qDBusRegisterMetaType<DeviceRecord>();
+    qDBusRegisterMetaType<QList<DeviceRecord> >();
+}
+
+bool DeviceRecordStore::isRecordSource(const QString &key)
+{
+    return key == "hwinfo" || key == "lshw" || key.startsWith("dmidecode_");
+}
+
+void DeviceRecordStore::update(const QString &source, const QString &info)
+{
+    // 在锁外解析，解析 hwinfo 时不阻塞查询
+    QList<DeviceRecord> records;
+    if (source == "hwinfo")
+        records = parseHwinfo(info);
+    else if (source == "lshw")
+        records = parseLshw(info);
+    else if (source.startsWith("dmidecode_"))
+        records = parseDmidecode(source, info);
+    else
+        return;
+
+    QMutexLocker locker(&m_Mutex);
+    if (records.isEmpty())
+        m_MapRecords.remove(source);
+    else
+        m_MapRecords.insert(source, records);
+    if (source == "hwinfo")
+        rebuildIndex();
+}
+
+QList<DeviceRecord> DeviceRecordStore::records(const QString &source)
+{
+    // QList 隐式共享，返回时不复制记录
+    QMutexLocker locker(&m_Mutex);
+    return m_MapRecords.value(source);
+}
+
+bool DeviceRecordStore::findByUniqueId(const QString &id, DeviceRecord &record)
+{
+    QMutexLocker locker(&m_Mutex);
+    QHash<QString, int>::const_iterator it = m_HashUniqueId.constFind(id);
+    if (it == m_HashUniqueId.constEnd())
+        return false;
+    record = m_MapRecords.value("hwinfo").at(it.value());
+    return true;
+}
+
+bool DeviceRecordStore::findBySysfsId(const QString &id, DeviceRecord &record)
+{
+    QMutexLocker locker(&m_Mutex);
+    QHash<QString, int>::const_iterator it = m_HashSysfsId.constFind(id);
+    if (it == m_HashSysfsId.constEnd())
+        return false;
+    record = m_MapRecords.value("hwinfo").at(it.value());
+    return true;
+}
+
+bool DeviceRecordStore::findByDeviceFile(const QString &file, DeviceRecord &record)
+{
+    QMutexLocker locker(&m_Mutex);
+    QHash<QString, int>::const_iterator it = m_HashDeviceFile.constFind(file);
+    if (it == m_HashDeviceFile.constEnd())
+        return false;
+    record = m_MapRecords.value("hwinfo").at(it.value());
+    return true;
+}
+
+bool DeviceRecordStore::isSysfsPathExisted(const QString &path)
+{
+    QString sysfs = path;
+    if (sysfs.startsWith("/sys/"))
+        sysfs = sysfs.mid(4);
+
+    QMutexLocker locker(&m_Mutex);
+    if (m_HashSysfsId.contains(sysfs))
+        return true;
+
+    // 路径为 usb 设备时，hwinfo 中的是其下的接口，如 1-1 与 1-1:1.0
+    const QList<DeviceRecord> records = m_MapRecords.value("hwinfo");
+    for (const DeviceRecord &record : records) {
+        if (isUnderPath(record.value("SysFS ID"), sysfs) || isUnderPath(record.value("SysFS Device Link"), sysfs))
+            return true;
+    }
+    return false;
+}
+
+bool DeviceRecordStore::isUnderPath(const QString &id, const QString &path)
+{
+    // 按完整的路径分量比较，1-1 不匹配 1-10
+    if (!id.startsWith(path))
+        return false;
+    return id.size() == path.size() || path.endsWith('/') || id.at(path.size()) == '/';
+}
+
+QList<DeviceRecord> DeviceRecordStore::parseHwinfo(const QString &info)
+{
+    QList<DeviceRecord> records;
+    QStringList items = info.split("\n\n");
+    foreach (const QString &item, items) {
+        DeviceRecord record;
+        record.source = "hwinfo";
+
+        // 第一行为 "24: USB 00.1: 0000 Unclassified device"，与其它行一样在第一个 ": " 处切分
+        QStringList lines = item.split("\n");
+        foreach (const QString &line, lines) {
+            int index = line.indexOf(": ");
+            if (index <= 0)
+                continue;
+            record.fields.append(qMakePair(line.left(index).trimmed(), line.mid(index + 2).trimmed()));
+        }
+        if (!record.fields.isEmpty())
+            records.append(record);
+    }
+    return records;
+}
+
+QList<DeviceRecord> DeviceRecordStore::parseLshw(const QString &info)
+{
+    QList<DeviceRecord> records;
+    if (info.isEmpty())
+        return records;
+
+    // 与客户端 CmdTool::getMapInfoFromLshw 相同，第一项为系统信息，其它项由客户端按 "*-" 的值分类
+    QStringList items = info.split("*-");
+    foreach (const QString &item, items) {
+        QMap<QString, QString> mapInfo;
+        QStringList lines = item.split("\n");
+        mapInfo.insert("*-", lines.first().trimmed());
+        foreach (const QString &line, lines) {
+            QStringList words = line.split(": ");
+            if (words.size() != 2)
+                continue;
+
+            // 将configuration和resources的内容进行拆分
+            if (words[0].contains("configuration")) {
+                QStringList keyValues = words[1].split(" ");
+                foreach (const QString &keyValue, keyValues) {
+                    QStringList attr = keyValue.split("=");
+                    if (attr.size() != 2)
+                        continue;
+                    mapInfo.insert(attr[0].trimmed(), attr[1].trimmed());
+                }
+            } else if (words[0].contains("resources")) {
+                QStringList keyValues = words[1].split(" ");
+                foreach (const QString &keyValue, keyValues) {
+                    QStringList attr = keyValue.split(":");
+                    if (attr.size() != 2)
+                        continue;
+                    if (mapInfo.find(attr[0].trimmed()) != mapInfo.end())
+                        mapInfo[attr[0].trimmed()] += QString("  ");
+                    mapInfo[attr[0].trimmed()] += attr[1].trimmed();
+                }
+            } else {
+                mapInfo.insert(words[0].trimmed(), words[1].trimmed());
+            }
+        }
+
+        DeviceRecord record;
+        record.source = "lshw";
+        for (QMap<QString, QString>::const_iterator it = mapInfo.begin(); it != mapInfo.end(); ++it) {
+            record.fields.append(qMakePair(it.key(), it.value()));
+        }
+        records.append(record);
+    }
+    return records;
+}
+
+QList<DeviceRecord> DeviceRecordStore::parseDmidecode(const QString &source, const QString &info)
+{
+    QList<DeviceRecord> records;
+    QStringList items = info.split("\n\n");
+    foreach (const QString &item, items) {
+        if (item.isEmpty())
+            continue;
+
+        QMap<QString, QString> mapInfo;
+        QStringList lines = item.split("\n");
+        QString lasKey;
+        foreach (const QString &line, lines) {
+            if (line.isEmpty())
+                continue;
+
+            QStringList words = line.split(": ");
+            if (1 ==  words.size() && words[0].endsWith(":")) {
+                lasKey = words[0].replace(QRegExp(":$"), "");
+                mapInfo.insert(lasKey.trimmed(), " ");
+            } else if (1 ==  words.size() && !lasKey.isEmpty()) {
+                mapInfo[lasKey.trimmed()] += words[0];
+                mapInfo[lasKey.trimmed()] += "  /  ";
+            } else if (2 ==  words.size()) {
+                lasKey = "";
+                mapInfo.insert(words[0].trimmed(), words[1].trimmed());
+            }
+        }
+
+        DeviceRecord record;
+        record.source = source;
+        for (QMap<QString, QString>::const_iterator it = mapInfo.begin(); it != mapInfo.end(); ++it) {
+            record.fields.append(qMakePair(it.key(), it.value()));
+        }
+        records.append(record);
+    }
+    return records;
+}
+
+void DeviceRecordStore::rebuildIndex()
+{
+    m_HashUniqueId.clear();
+    m_HashSysfsId.clear();
+    m_HashDeviceFile.clear();
+
+    const QList<DeviceRecord> records = m_MapRecords.value("hwinfo");
+    for (int i = 0; i < records.size(); ++i) {
+        QString uniqueId = records[i].value("Unique ID");
+        QString sysfsId = records[i].value("SysFS ID");
+        QString deviceFile = records[i].value("Device File");
+        if (!uniqueId.isEmpty())
+            m_HashUniqueId.insert(uniqueId, i);
+        if (!sysfsId.isEmpty())
+            m_HashSysfsId.insert(sysfsId, i);
+        if (!deviceFile.isEmpty())
+            m_HashDeviceFile.insert(deviceFile, i);
+    }
+}
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICERECORDSTORE_H
+#define DEVICERECORDSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QMap>
+#include <QHash>
+#include <QMutex>
+#include <QMetaType>
+
+#include <mutex>
+#include <atomic>
+
+class QDBusArgument;
+
+/**
+ * @brief The DeviceRecord struct : 一个设备的信息，由采集命令的输出解析一次得到
+ */
+struct DeviceRecord {
+    QString source;                             //<! hwinfo lshw dmidecode_4 ...
+    QList<QPair<QString, QString> > fields;     //<! 按原始顺序的 key : value，值保留原始格式
+
+    /**
+     * @brief value : key 的最后一个值，与把所有字段插入 map 的结果相同
+     * @param key
+     * @return
+     */
+    QString value(const QString &key) const;
+
+    /**
+     * @brief contains
+     * @param key
+     * @return
+     */
+    bool contains(const QString &key) const;
+
+    /**
+     * @brief toMap
+     * @return
+     */
+    QMap<QString, QString> toMap() const;
+};
+Q_DECLARE_METATYPE(DeviceRecord)
+
+// a(sa{ss}) 中的 (sa{ss})
+QDBusArgument &operator<<(QDBusArgument &argument, const DeviceRecord &record);
+const QDBusArgument &operator>>(const QDBusArgument &argument, DeviceRecord &record);
+
+/**
+ * @brief The DeviceRecordStore class
+ * 采集命令的输出发布到 DeviceInfoManager 时解析一次，按 Unique ID、SysFS ID 和设备文件建立索引，
+ * 服务内的模块和客户端直接使用解析后的记录，不再各自切分原始文本
+ */
+class DeviceRecordStore
+{
+public:
+    inline static DeviceRecordStore *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        DeviceRecordStore *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new DeviceRecordStore();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief isRecordSource : 该 key 的信息是否解析为记录
+     * @param key : hwinfo lshw dmidecode_N
+     * @return
+     */
+    static bool isRecordSource(const QString &key);
+
+    /**
+     * @brief update : 解析信息并替换该来源的记录
+     * @param source
+     * @param info : 为空时删除该来源的记录
+     */
+    void update(const QString &source, const QString &info);
+
+    /**
+     * @brief records
+     * @param source
+     * @return
+     */
+    QList<DeviceRecord> records(const QString &source);
+
+    /**
+     * @brief findByUniqueId : 按 hwinfo 的 Unique ID 查找
+     * @param id
+     * @param record
+     * @return
+     */
+    bool findByUniqueId(const QString &id, DeviceRecord &record);
+
+    /**
+     * @brief findBySysfsId : 按 hwinfo 的 SysFS ID 查找，如 /devices/pci0000:00/0000:00:14.0/usb1/1-1/1-1:1.0
+     * @param id
+     * @param record
+     * @return
+     */
+    bool findBySysfsId(const QString &id, DeviceRecord &record);
+
+    /**
+     * @brief findByDeviceFile : 按 hwinfo 的 Device File 查找，如 /dev/input/event3
+     * @param file
+     * @param record
+     * @return
+     */
+    bool findByDeviceFile(const QString &file, DeviceRecord &record);
+
+    /**
+     * @brief isSysfsPathExisted : 该 sysfs 路径或其下是否有 hwinfo 的设备
+     * @param path : /sys/devices/... 或 /devices/...
+     * @return
+     */
+    bool isSysfsPathExisted(const QString &path);
+
+    /**
+     * @brief parseHwinfo : hwinfo 的设备以空行分隔，每行为 key: value
+     * @param info
+     * @return
+     */
+    static QList<DeviceRecord> parseHwinfo(const QString &info);
+
+    /**
+     * @brief parseLshw : 与客户端相同，设备以 "*-" 分隔，设备的第一行保存为 "*-" 字段
+     * @param info
+     * @return
+     */
+    static QList<DeviceRecord> parseLshw(const QString &info);
+
+    /**
+     * @brief parseDmidecode : 与客户端相同，"Key:" 之后缩进的行以 "  /  " 连接
+     * @param source
+     * @param info
+     * @return
+     */
+    static QList<DeviceRecord> parseDmidecode(const QString &source, const QString &info);
+
+protected:
+    DeviceRecordStore();
+
+private:
+    /**
+     * @brief isUnderPath : sysfs id 是否为该路径或其下的路径，按完整的路径段比较
+     * @param id
+     * @param path
+     * @return
+     */
+    static bool isUnderPath(const QString &id, const QString &path);
+
+    /**
+     * @brief rebuildIndex : 重建 hwinfo 记录的索引，调用时需持有 m_Mutex
+     */
+    void rebuildIndex();
+
+private:
+    static std::atomic<DeviceRecordStore *> s_Instance;
+    static std::mutex m_mutex;
+
+    QMutex                                  m_Mutex;            //<! 以下成员的锁
+    QMap<QString, QList<DeviceRecord> >     m_MapRecords;       //<! 来源 -> 记录
+    QHash<QString, int>                     m_HashUniqueId;     //<! Unique ID -> hwinfo 记录的序号
+    QHash<QString, int>                     m_HashSysfsId;      //<! SysFS ID -> hwinfo 记录的序号
+    QHash<QString, int>                     m_HashDeviceFile;   //<! Device File -> hwinfo 记录的序号
+};
+
+#endif // DEVICERECORDSTORE_H
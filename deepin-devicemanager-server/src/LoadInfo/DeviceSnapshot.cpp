@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DeviceSnapshot.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QDebug>
+
+#define SNAPSHOT_MAGIC 0x444D5353    // DMSS
+#define SNAPSHOT_VERSION 4           // 快照格式变化时需要增加版本号
+
+/**
+ * @brief readSysFile : read a small sysfs file
+ */
+static QByteArray readSysFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QByteArray data = file.readAll();
+    file.close();
+    return data.trimmed();
+}
+
+/**
+ * @brief addTopology : add the device names and ids under a sysfs bus to the hash
+ */
+static void addTopology(QCryptographicHash &hash, const QString &path, const QStringList &idFiles)
+{
+    QDir dir(path);
+    QStringList names = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    foreach (const QString &name, names) {
+        hash.addData(name.toLatin1());
+        foreach (const QString &idFile, idFiles) {
+            hash.addData(readSysFile(dir.filePath(name + "/" + idFile)));
+        }
+    }
+}
+
+DeviceSnapshot::DeviceSnapshot(const QString &path)
+    : m_Path(path)
+    , m_SameBoot(false)
+{
+
+}
+
+bool DeviceSnapshot::load()
+{
+    m_MapInfo.clear();
+    m_SameBoot = false;
+
+    QFile file(m_Path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // 直接从文件流解析，指纹不一致时不再读取设备信息，不需要先将整个文件读入或映射到内存
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0, version = 0;
+    QByteArray fingerprint, boot;
+    stream >> magic >> version;
+    bool valid = false;
+    if (magic == SNAPSHOT_MAGIC && version == SNAPSHOT_VERSION) {
+        stream >> fingerprint >> boot;
+        // 硬件指纹不一致说明硬件发生了变化，快照无效
+        if (fingerprint == hardwareFingerprint()) {
+            stream >> m_MapInfo;
+            valid = stream.status() == QDataStream::Ok;
+        }
+    }
+    file.close();
+
+    if (!valid) {
+        m_MapInfo.clear();
+        return false;
+    }
+    m_SameBoot = !boot.isEmpty() && boot == bootId();
+    return true;
+}
+
+bool DeviceSnapshot::save(const QMap<QString, QString> &info)
+{
+    QDir().mkpath(QFileInfo(m_Path).absolutePath());
+
+    QSaveFile file(m_Path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    // 快照中包含序列号等信息，只允许root读取
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << quint32(SNAPSHOT_MAGIC) << quint32(SNAPSHOT_VERSION);
+    stream << hardwareFingerprint() << bootId();
+    stream << info;
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool DeviceSnapshot::sameBoot() const
+{
+    return m_SameBoot;
+}
+
+const QMap<QString, QString> &DeviceSnapshot::info() const
+{
+    return m_MapInfo;
+}
+
+QByteArray DeviceSnapshot::hardwareFingerprint()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // 1. DMI 表
+    QFile dmi("/sys/firmware/dmi/tables/DMI");
+    if (dmi.open(QIODevice::ReadOnly)) {
+        hash.addData(&dmi);
+        dmi.close();
+    }
+
+    // 2. PCI 拓扑
+    // USB 等热插拔总线不参与计算，插拔设备时快照仍然有效，由后台刷新更新热插拔设备的信息
+    addTopology(hash, "/sys/bus/pci/devices", QStringList() << "vendor" << "device");
+
+    return hash.result();
+}
+
+QByteArray DeviceSnapshot::usbTopology()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addTopology(hash, "/sys/bus/usb/devices", QStringList() << "idVendor" << "idProduct");
+    return hash.result();
+}
+
+QByteArray DeviceSnapshot::bootId()
+{
+    return readSysFile("/proc/sys/kernel/random/boot_id");
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICESNAPSHOT_H
+#define DEVICESNAPSHOT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+
+#define SNAPSHOT_PATH "/var/cache/deepin-devicemanager-server/device-info.snapshot"  // 设备信息快照文件
+
+/**
+ * @brief The DeviceSnapshot class
+ * 将 DeviceInfoManager 中的设备信息保存到磁盘，守护进程重启后直接加载，
+ * 通过 DMI 表和 PCI 拓扑生成的硬件指纹判断快照是否有效，不包含 USB 等热插拔总线
+ */
+class DeviceSnapshot
+{
+public:
+    explicit DeviceSnapshot(const QString &path = SNAPSHOT_PATH);
+
+    /**
+     * @brief load : read the snapshot file and check the version and the hardware fingerprint
+     * @return false if the snapshot does not exist or is out of date
+     */
+    bool load();
+
+    /**
+     * @brief save : write the snapshot atomically
+     * @param info : all info in DeviceInfoManager
+     * @return
+     */
+    bool save(const QMap<QString, QString> &info);
+
+    /**
+     * @brief sameBoot : whether the snapshot was saved in the current boot
+     * @return
+     */
+    bool sameBoot() const;
+
+    /**
+     * @brief info : the device info in the snapshot
+     * @return
+     */
+    const QMap<QString, QString> &info() const;
+
+    /**
+     * @brief hardwareFingerprint : sha1 of the DMI table and the PCI topology
+     * @return
+     */
+    static QByteArray hardwareFingerprint();
+
+    /**
+     * @brief usbTopology : sha1 of the USB topology, changes when a USB device is plugged or unplugged
+     * @return
+     */
+    static QByteArray usbTopology();
+
+    /**
+     * @brief bootId : /proc/sys/kernel/random/boot_id
+     * @return
+     */
+    static QByteArray bootId();
+
+private:
+    QString                     m_Path;             //<! snapshot file
+    bool                        m_SameBoot;         //<! saved in the current boot
+    QMap<QString, QString>      m_MapInfo;          //<! device info
+};
+
+#endif // DEVICESNAPSHOT_H
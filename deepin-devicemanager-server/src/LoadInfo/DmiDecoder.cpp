@@ -0,0 +1,853 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DmiDecoder.h"
+
+#include <QFile>
+#include <QMap>
+#include <QtEndian>
+#include <QDebug>
+
+#define OUT_OF_SPEC "<OUT OF SPEC>"
+#define TABLE_SIZE(table) static_cast<int>(sizeof(table) / sizeof(table[0]))
+
+static quint16 WORD(const uchar *p)
+{
+    return qFromLittleEndian<quint16>(p);
+}
+
+static quint32 DWORD(const uchar *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+static quint64 QWORD(const uchar *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+/**
+ * @brief tableValue 从以 base 开始编号的表中获取名称
+ */
+static QString tableValue(const char *const table[], int size, int code, int base = 1)
+{
+    int index = code - base;
+    if (index < 0 || index >= size || !table[index])
+        return OUT_OF_SPEC;
+    return table[index];
+}
+
+/**
+ * @brief flagLines 按位输出标识，每一位一行
+ */
+static QString flagLines(const char *const table[], int size, quint64 code, int firstBit = 0)
+{
+    QString lines;
+    for (int i = 0; i < size; ++i) {
+        if (table[i] && (code & (quint64(1) << (i + firstBit))))
+            lines += QString("\t\t%1\n").arg(table[i]);
+    }
+    return lines;
+}
+
+static const char *const s_BiosCharacteristics[] = {
+    "ISA is supported", "MCA is supported", "EISA is supported", "PCI is supported",
+    "PC Card (PCMCIA) is supported", "PNP is supported", "APM is supported", "BIOS is upgradeable",
+    "BIOS shadowing is allowed", "VLB is supported", "ESCD support is available", "Boot from CD is supported",
+    "Selectable boot is supported", "BIOS ROM is socketed", "Boot from PC Card (PCMCIA) is supported", "EDD is supported",
+    "Japanese floppy for NEC 9800 1.2 MB is supported (int 13h)", "Japanese floppy for Toshiba 1.2 MB is supported (int 13h)",
+    "5.25\"/360 kB floppy services are supported (int 13h)", "5.25\"/1.2 MB floppy services are supported (int 13h)",
+    "3.5\"/720 kB floppy services are supported (int 13h)", "3.5\"/2.88 MB floppy services are supported (int 13h)",
+    "Print screen service is supported (int 5h)", "8042 keyboard services are supported (int 9h)",
+    "Serial services are supported (int 14h)", "Printer services are supported (int 17h)",
+    "CGA/mono video services are supported (int 10h)", "NEC PC-98"
+};
+
+static const char *const s_BiosCharacteristicsX1[] = {
+    "ACPI is supported", "USB legacy is supported", "AGP is supported", "I2O boot is supported",
+    "LS-120 boot is supported", "ATAPI Zip drive boot is supported", "IEEE 1394 boot is supported", "Smart battery is supported"
+};
+
+static const char *const s_BiosCharacteristicsX2[] = {
+    "BIOS boot specification is supported", "Function key-initiated network boot is supported",
+    "Targeted content distribution is supported", "UEFI is supported", "System is a virtual machine"
+};
+
+static const char *const s_WakeUpType[] = {
+    "Reserved", "Other", "Unknown", "APM Timer", "Modem Ring", "LAN Remote", "Power Switch", "PCI PME#", "AC Power Restored"
+};
+
+static const char *const s_BoardFeatures[] = {
+    "Board is a hosting board", "Board requires at least one daughter board", "Board is removable",
+    "Board is replaceable", "Board is hot swappable"
+};
+
+static const char *const s_BoardType[] = {
+    "Unknown", "Other", "Server Blade", "Connectivity Switch", "System Management Module", "Processor Module",
+    "I/O Module", "Memory Module", "Daughter Board", "Motherboard", "Processor+Memory Module",
+    "Processor+I/O Module", "Interconnect Board"
+};
+
+static const char *const s_ChassisType[] = {
+    "Other", "Unknown", "Desktop", "Low Profile Desktop", "Pizza Box", "Mini Tower", "Tower", "Portable",
+    "Laptop", "Notebook", "Hand Held", "Docking Station", "All In One", "Sub Notebook", "Space-saving",
+    "Lunch Box", "Main Server Chassis", "Expansion Chassis", "Sub Chassis", "Bus Expansion Chassis",
+    "Peripheral Chassis", "RAID Chassis", "Rack Mount Chassis", "Sealed-case PC", "Multi-system",
+    "CompactPCI", "AdvancedTCA", "Blade", "Blade Enclosing", "Tablet", "Convertible", "Detachable",
+    "IoT Gateway", "Embedded PC", "Mini PC", "Stick PC"
+};
+
+static const char *const s_ChassisState[] = {
+    "Other", "Unknown", "Safe", "Warning", "Critical", "Non-recoverable"
+};
+
+static const char *const s_ChassisSecurity[] = {
+    "Other", "Unknown", "None", "External Interface Locked Out", "External Interface Enabled"
+};
+
+static const char *const s_ProcessorType[] = {
+    "Other", "Unknown", "Central Processor", "Math Processor", "DSP Processor", "Video Processor"
+};
+
+static const char *const s_ProcessorStatus[] = {
+    "Unknown", "Enabled", "Disabled By User", "Disabled By BIOS", "Idle", nullptr, nullptr, "Other"
+};
+
+static const char *const s_ProcessorUpgrade[] = {
+    "Other", "Unknown", "Daughter Board", "ZIF Socket", "Replaceable Piggy Back", "None", "LIF Socket",
+    "Slot 1", "Slot 2", "370-pin Socket", "Slot A", "Slot M", "Socket 423", "Socket A (Socket 462)",
+    "Socket 478", "Socket 754", "Socket 940", "Socket 939", "Socket mPGA604", "Socket LGA771",
+    "Socket LGA775", "Socket S1", "Socket AM2", "Socket F (1207)", "Socket LGA1366", "Socket G34",
+    "Socket AM3", "Socket C32", "Socket LGA1156", "Socket LGA1567", "Socket PGA988A", "Socket BGA1288",
+    "Socket rPGA988B", "Socket BGA1023", "Socket BGA1224", "Socket BGA1155", "Socket LGA1356",
+    "Socket LGA2011", "Socket FS1", "Socket FS2", "Socket FM1", "Socket FM2", "Socket LGA2011-3",
+    "Socket LGA1356-3", "Socket LGA1150", "Socket BGA1168", "Socket BGA1234", "Socket BGA1364",
+    "Socket AM4", "Socket LGA1151", "Socket BGA1356", "Socket BGA1440", "Socket BGA1515",
+    "Socket LGA3647-1", "Socket SP3", "Socket SP3r2", "Socket LGA2066", "Socket BGA1392",
+    "Socket BGA1510", "Socket BGA1528", "Socket LGA4189", "Socket LGA1200", "Socket LGA4677",
+    "Socket LGA1700", "Socket BGA1744", "Socket BGA1781", "Socket BGA1211", "Socket BGA2422",
+    "Socket LGA1211", "Socket LGA2422", "Socket LGA5773", "Socket BGA5773"
+};
+
+static const char *const s_ProcessorCharacteristics[] = {
+    "64-bit capable", "Multi-Core", "Hardware Thread", "Execute Protection", "Enhanced Virtualization",
+    "Power/Performance Control", "128-bit Capable", "Arm64 SoC ID"
+};
+
+static const char *const s_ProcessorFlags[] = {
+    "FPU (Floating-point unit on-chip)", "VME (Virtual mode extension)", "DE (Debugging extension)",
+    "PSE (Page size extension)", "TSC (Time stamp counter)", "MSR (Model specific registers)",
+    "PAE (Physical address extension)", "MCE (Machine check exception)", "CX8 (CMPXCHG8 instruction supported)",
+    "APIC (On-chip APIC hardware supported)", nullptr, "SEP (Fast system call)",
+    "MTRR (Memory type range registers)", "PGE (Page global enable)", "MCA (Machine check architecture)",
+    "CMOV (Conditional move instruction supported)", "PAT (Page attribute table)",
+    "PSE-36 (36-bit page size extension)", "PSN (Processor serial number present and enabled)",
+    "CLFSH (CLFLUSH instruction supported)", nullptr, "DS (Debug store)", "ACPI (ACPI supported)",
+    "MMX (MMX technology supported)", "FXSR (FXSAVE and FXSTOR instructions supported)",
+    "SSE (Streaming SIMD extensions)", "SSE2 (Streaming SIMD extensions 2)", "SS (Self-snoop)",
+    "HTT (Multi-threading)", "TM (Thermal monitor supported)", nullptr, "PBE (Pending break enabled)"
+};
+
+// 处理器家族，只包含常见的取值，其它取值按 dmidecode 的方式输出 <OUT OF SPEC>
+static const QMap<int, QString> s_ProcessorFamily = {
+    {0x01, "Other"}, {0x02, "Unknown"}, {0x0B, "Pentium"}, {0x0C, "Pentium Pro"}, {0x0D, "Pentium II"},
+    {0x0E, "Pentium MMX"}, {0x0F, "Celeron"}, {0x10, "Pentium II Xeon"}, {0x11, "Pentium III"},
+    {0x14, "Celeron M"}, {0x15, "Pentium 4 HT"}, {0x18, "Duron"}, {0x1D, "Athlon"},
+    {0x28, "Core Duo"}, {0x29, "Core Duo Mobile"}, {0x2A, "Core Solo Mobile"}, {0x2B, "Atom"},
+    {0x2C, "Core M"}, {0x2D, "Core m3"}, {0x2E, "Core m5"}, {0x2F, "Core m7"},
+    {0x3F, "FX"}, {0x66, "Athlon X4"}, {0x67, "Opteron X1000"}, {0x68, "Opteron X2000"},
+    {0x69, "Opteron A-Series"}, {0x6A, "Opteron X3000"}, {0x6B, "Zen"},
+    {0x83, "Athlon 64"}, {0x84, "Opteron"}, {0x85, "Sempron"}, {0x86, "Turion 64"},
+    {0x87, "Dual-Core Opteron"}, {0x88, "Athlon 64 X2"}, {0x89, "Turion 64 X2"},
+    {0x8A, "Quad-Core Opteron"}, {0x8B, "Third-Generation Opteron"}, {0x8C, "Phenom FX"},
+    {0x8D, "Phenom X4"}, {0x8E, "Phenom X2"}, {0x8F, "Athlon X2"},
+    {0xB0, "Pentium III Xeon"}, {0xB1, "Pentium III Speedstep"}, {0xB2, "Pentium 4"}, {0xB3, "Xeon"},
+    {0xB5, "Xeon MP"}, {0xB6, "Athlon XP"}, {0xB7, "Athlon MP"}, {0xB8, "Itanium 2"}, {0xB9, "Pentium M"},
+    {0xBA, "Celeron D"}, {0xBB, "Pentium D"}, {0xBC, "Pentium EE"}, {0xBD, "Core Solo"},
+    {0xBF, "Core 2 Duo"}, {0xC0, "Core 2 Solo"}, {0xC1, "Core 2 Extreme"}, {0xC2, "Core 2 Quad"},
+    {0xC3, "Core 2 Extreme Mobile"}, {0xC4, "Core 2 Duo Mobile"}, {0xC5, "Core 2 Solo Mobile"},
+    {0xC6, "Core i7"}, {0xC7, "Dual-Core Celeron"}, {0xCD, "Core i5"}, {0xCE, "Core i3"}, {0xCF, "Core i9"},
+    {0xD2, "C7-M"}, {0xD3, "C7-D"}, {0xD4, "C7"}, {0xD5, "Eden"}, {0xD6, "Multi-Core Xeon"},
+    {0xD7, "Dual-Core Xeon 3xxx"}, {0xD8, "Quad-Core Xeon 3xxx"}, {0xD9, "Nano"},
+    {0xDA, "Dual-Core Xeon 5xxx"}, {0xDB, "Quad-Core Xeon 5xxx"}, {0xDD, "Dual-Core Xeon 7xxx"},
+    {0xDE, "Quad-Core Xeon 7xxx"}, {0xDF, "Multi-Core Xeon 7xxx"}, {0xE0, "Multi-Core Xeon 3400"},
+    {0xE4, "Opteron 3000"}, {0xE5, "Sempron II"}, {0xE6, "Embedded Opteron Quad-Core"},
+    {0xE7, "Phenom Triple-Core"}, {0xE8, "Turion Ultra Dual-Core Mobile"}, {0xE9, "Turion Dual-Core Mobile"},
+    {0xEA, "Athlon Dual-Core"}, {0xEB, "Sempron SI"}, {0xEC, "Phenom II"}, {0xED, "Athlon II"},
+    {0xEE, "Six-Core Opteron"}, {0xEF, "Sempron M"},
+    {0x100, "ARMv7"}, {0x101, "ARMv8"}, {0x102, "ARMv9"}, {0x118, "ARM"}, {0x119, "StrongARM"},
+    {0x200, "RV32"}, {0x201, "RV64"}, {0x202, "RV128"}, {0x258, "LoongArch"}
+};
+
+static const char *const s_MemoryArrayLocation[] = {
+    "Other", "Unknown", "System Board Or Motherboard", "ISA Add-on Card", "EISA Add-on Card",
+    "PCI Add-on Card", "MCA Add-on Card", "PCMCIA Add-on Card", "Proprietary Add-on Card", "NuBus"
+};
+
+static const char *const s_MemoryArrayUse[] = {
+    "Other", "Unknown", "System Memory", "Video Memory", "Flash Memory", "Non-volatile RAM", "Cache Memory"
+};
+
+static const char *const s_MemoryArrayEcc[] = {
+    "Other", "Unknown", "None", "Parity", "Single-bit ECC", "Multi-bit ECC", "CRC"
+};
+
+static const char *const s_MemoryFormFactor[] = {
+    "Other", "Unknown", "SIMM", "SIP", "Chip", "DIP", "ZIP", "Proprietary Card", "DIMM", "TSOP",
+    "Row Of Chips", "RIMM", "SODIMM", "SRIMM", "FB-DIMM", "Die"
+};
+
+static const char *const s_MemoryType[] = {
+    "Other", "Unknown", "DRAM", "EDRAM", "VRAM", "SRAM", "RAM", "ROM", "Flash", "EEPROM", "FEPROM",
+    "EPROM", "CDRAM", "3DRAM", "SDRAM", "SGRAM", "RDRAM", "DDR", "DDR2", "DDR2 FB-DIMM", "Reserved",
+    "Reserved", "Reserved", "DDR3", "FBD2", "DDR4", "LPDDR", "LPDDR2", "LPDDR3", "LPDDR4",
+    "Logical non-volatile device", "HBM", "HBM2", "DDR5", "LPDDR5", "HBM3"
+};
+
+static const char *const s_MemoryTypeDetail[] = {
+    "Other", "Unknown", "Fast-paged", "Static Column", "Pseudo-static", "RAMBus", "Synchronous", "CMOS",
+    "EDO", "Window DRAM", "Cache DRAM", "Non-Volatile", "Registered (Buffered)", "Unbuffered (Unregistered)", "LRDIMM"
+};
+
+DmiDecoder::DmiDecoder(const QString &path)
+    : m_Path(path)
+    , m_Version("")
+    , m_Major(0)
+    , m_Minor(0)
+{
+
+}
+
+bool DmiDecoder::load()
+{
+    QFile entryFile(m_Path + "/smbios_entry_point");
+    if (!entryFile.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray entry = entryFile.readAll();
+    entryFile.close();
+
+    QFile tableFile(m_Path + "/DMI");
+    if (!tableFile.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray table = tableFile.readAll();
+    tableFile.close();
+
+    return loadFromData(entry, table);
+}
+
+bool DmiDecoder::loadFromData(const QByteArray &entry, const QByteArray &table)
+{
+    m_ListStructure.clear();
+    if (!parseEntryPoint(entry))
+        return false;
+    parseTable(table);
+    return !m_ListStructure.isEmpty();
+}
+
+const QString &DmiDecoder::version() const
+{
+    return m_Version;
+}
+
+const QList<DmiStructure> &DmiDecoder::structures() const
+{
+    return m_ListStructure;
+}
+
+QString DmiDecoder::typeInfo(int type) const
+{
+    // 与 dmidecode 从 sysfs 读取时的输出头一致，客户端依赖该段落的位置
+    QString info = "# dmidecode 3.3\nGetting SMBIOS data from sysfs.\n";
+    info += QString("SMBIOS %1 present.\n\n").arg(m_Version);
+
+    foreach (const DmiStructure &dmi, m_ListStructure) {
+        if (dmi.type != type)
+            continue;
+        info += QString("Handle 0x%1, DMI type %2, %3 bytes\n")
+                .arg(QString("%1").arg(dmi.handle, 4, 16, QChar('0')).toUpper()).arg(dmi.type).arg(dmi.length);
+        decode(dmi, info);
+        info += "\n";
+    }
+    return info;
+}
+
+QString DmiDecoder::systemProductName() const
+{
+    foreach (const DmiStructure &dmi, m_ListStructure) {
+        if (dmi.type == 1 && dmi.length >= 0x08)
+            return dmiString(dmi, static_cast<quint8>(dmi.data[0x05])) + "\n";
+    }
+    return "";
+}
+
+bool DmiDecoder::parseEntryPoint(const QByteArray &entry)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(entry.constData());
+    if (entry.size() >= 24 && entry.startsWith("_SM3_")) {
+        // SMBIOS 3.x 64位入口
+        m_Major = p[0x07];
+        m_Minor = p[0x08];
+        m_Version = QString("%1.%2.%3").arg(m_Major).arg(m_Minor).arg(p[0x09]);
+        return true;
+    }
+    if (entry.size() >= 31 && entry.startsWith("_SM_")) {
+        // SMBIOS 2.x 32位入口
+        m_Major = p[0x06];
+        m_Minor = p[0x07];
+        m_Version = QString("%1.%2").arg(m_Major).arg(m_Minor);
+        return true;
+    }
+    if (entry.size() >= 15 && entry.startsWith("_DMI_")) {
+        // 旧版本的 DMI 入口
+        m_Major = p[0x0E] >> 4;
+        m_Minor = p[0x0E] & 0x0F;
+        m_Version = QString("%1.%2").arg(m_Major).arg(m_Minor);
+        return true;
+    }
+    return false;
+}
+
+void DmiDecoder::parseTable(const QByteArray &table)
+{
+    const int size = table.size();
+    int offset = 0;
+    while (offset + 4 <= size) {
+        const uchar *p = reinterpret_cast<const uchar *>(table.constData()) + offset;
+        DmiStructure dmi;
+        dmi.type = p[0];
+        dmi.length = p[1];
+        dmi.handle = WORD(p + 2);
+        // 长度小于4的结构是损坏的，后续的数据无法解析
+        if (dmi.length < 4 || offset + dmi.length > size)
+            break;
+        dmi.data = table.mid(offset, dmi.length);
+
+        // 字符串区以两个连续的0结尾
+        int pos = offset + dmi.length;
+        int strStart = pos;
+        while (pos + 1 < size && !(table[pos] == 0 && table[pos + 1] == 0)) {
+            if (table[pos] == 0) {
+                dmi.strings.append(table.mid(strStart, pos - strStart));
+                strStart = pos + 1;
+            }
+            ++pos;
+        }
+        if (pos > strStart)
+            dmi.strings.append(table.mid(strStart, pos - strStart));
+
+        m_ListStructure.append(dmi);
+        offset = pos + 2;
+
+        // 127 : End Of Table
+        if (dmi.type == 127)
+            break;
+    }
+}
+
+void DmiDecoder::decode(const DmiStructure &dmi, QString &info) const
+{
+    switch (dmi.type) {
+    case 0:
+        decodeBios(dmi, info);
+        break;
+    case 1:
+        decodeSystem(dmi, info);
+        break;
+    case 2:
+        decodeBaseBoard(dmi, info);
+        break;
+    case 3:
+        decodeChassis(dmi, info);
+        break;
+    case 4:
+        decodeProcessor(dmi, info);
+        break;
+    case 13:
+        decodeLanguage(dmi, info);
+        break;
+    case 16:
+        decodeMemoryArray(dmi, info);
+        break;
+    case 17:
+        decodeMemoryDevice(dmi, info);
+        break;
+    default:
+        break;
+    }
+}
+
+void DmiDecoder::decodeBios(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "BIOS Information\n";
+    if (dmi.length < 0x12)
+        return;
+
+    info += QString("\tVendor: %1\n").arg(dmiString(dmi, p[0x04]));
+    info += QString("\tVersion: %1\n").arg(dmiString(dmi, p[0x05]));
+    info += QString("\tRelease Date: %1\n").arg(dmiString(dmi, p[0x08]));
+
+    // 地址为0时为UEFI固件，不输出地址和运行大小
+    quint16 address = WORD(p + 0x06);
+    if (address != 0) {
+        info += QString("\tAddress: 0x%1\n").arg(QString("%1").arg(address, 4, 16, QChar('0')).toUpper() + "0");
+        quint32 runtime = (0x10000 - address) << 4;
+        if (runtime & 0x000003FF)
+            info += QString("\tRuntime Size: %1 bytes\n").arg(runtime);
+        else
+            info += QString("\tRuntime Size: %1 kB\n").arg(runtime >> 10);
+    }
+
+    if (p[0x09] != 0xFF) {
+        info += QString("\tROM Size: %1\n").arg(memorySize(quint64(p[0x09] + 1) << 6, 1));
+    } else if (dmi.length >= 0x1A) {
+        quint16 code = WORD(p + 0x18);
+        info += QString("\tROM Size: %1 %2\n").arg(code & 0x3FFF).arg((code >> 14) == 0 ? "MB" : ((code >> 14) == 1 ? "GB" : OUT_OF_SPEC));
+    }
+
+    quint64 characteristics = QWORD(p + 0x0A);
+    if (characteristics & (1 << 3)) {
+        info += "\tCharacteristics:\n\t\tBIOS characteristics not supported\n";
+    } else {
+        info += "\tCharacteristics:\n";
+        info += flagLines(s_BiosCharacteristics, TABLE_SIZE(s_BiosCharacteristics), characteristics, 4);
+        if (dmi.length >= 0x13)
+            info += flagLines(s_BiosCharacteristicsX1, TABLE_SIZE(s_BiosCharacteristicsX1), p[0x12]);
+        if (dmi.length >= 0x14)
+            info += flagLines(s_BiosCharacteristicsX2, TABLE_SIZE(s_BiosCharacteristicsX2), p[0x13]);
+    }
+
+    if (dmi.length >= 0x18) {
+        if (p[0x14] != 0xFF && p[0x15] != 0xFF)
+            info += QString("\tBIOS Revision: %1.%2\n").arg(p[0x14]).arg(p[0x15]);
+        if (p[0x16] != 0xFF && p[0x17] != 0xFF)
+            info += QString("\tFirmware Revision: %1.%2\n").arg(p[0x16]).arg(p[0x17]);
+    }
+}
+
+void DmiDecoder::decodeSystem(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "System Information\n";
+    if (dmi.length < 0x08)
+        return;
+
+    info += QString("\tManufacturer: %1\n").arg(dmiString(dmi, p[0x04]));
+    info += QString("\tProduct Name: %1\n").arg(dmiString(dmi, p[0x05]));
+    info += QString("\tVersion: %1\n").arg(dmiString(dmi, p[0x06]));
+    info += QString("\tSerial Number: %1\n").arg(dmiString(dmi, p[0x07]));
+    if (dmi.length < 0x19)
+        return;
+
+    info += QString("\tUUID: %1\n").arg(uuid(p + 0x08));
+    info += QString("\tWake-up Type: %1\n").arg(tableValue(s_WakeUpType, TABLE_SIZE(s_WakeUpType), p[0x18], 0));
+    if (dmi.length < 0x1B)
+        return;
+
+    info += QString("\tSKU Number: %1\n").arg(dmiString(dmi, p[0x19]));
+    info += QString("\tFamily: %1\n").arg(dmiString(dmi, p[0x1A]));
+}
+
+void DmiDecoder::decodeBaseBoard(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "Base Board Information\n";
+    if (dmi.length < 0x08)
+        return;
+
+    info += QString("\tManufacturer: %1\n").arg(dmiString(dmi, p[0x04]));
+    info += QString("\tProduct Name: %1\n").arg(dmiString(dmi, p[0x05]));
+    info += QString("\tVersion: %1\n").arg(dmiString(dmi, p[0x06]));
+    info += QString("\tSerial Number: %1\n").arg(dmiString(dmi, p[0x07]));
+    if (dmi.length < 0x09)
+        return;
+
+    info += QString("\tAsset Tag: %1\n").arg(dmiString(dmi, p[0x08]));
+    if (dmi.length < 0x0A)
+        return;
+
+    if ((p[0x09] & 0x1F) == 0) {
+        info += "\tFeatures: None\n";
+    } else {
+        info += "\tFeatures:\n";
+        info += flagLines(s_BoardFeatures, TABLE_SIZE(s_BoardFeatures), p[0x09]);
+    }
+    if (dmi.length < 0x0E)
+        return;
+
+    info += QString("\tLocation In Chassis: %1\n").arg(dmiString(dmi, p[0x0A]));
+    info += QString("\tChassis Handle: 0x%1\n").arg(QString("%1").arg(WORD(p + 0x0B), 4, 16, QChar('0')).toUpper());
+    info += QString("\tType: %1\n").arg(tableValue(s_BoardType, TABLE_SIZE(s_BoardType), p[0x0D]));
+    if (dmi.length < 0x0F)
+        return;
+
+    int count = p[0x0E];
+    info += QString("\tContained Object Handles: %1\n").arg(count);
+    for (int i = 0; i < count && 0x0F + i * 2 + 2 <= dmi.length; ++i)
+        info += QString("\t\t0x%1\n").arg(QString("%1").arg(WORD(p + 0x0F + i * 2), 4, 16, QChar('0')).toUpper());
+}
+
+void DmiDecoder::decodeChassis(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "Chassis Information\n";
+    if (dmi.length < 0x09)
+        return;
+
+    info += QString("\tManufacturer: %1\n").arg(dmiString(dmi, p[0x04]));
+    info += QString("\tType: %1\n").arg(tableValue(s_ChassisType, TABLE_SIZE(s_ChassisType), p[0x05] & 0x7F));
+    info += QString("\tLock: %1\n").arg((p[0x05] & 0x80) ? "Present" : "Not Present");
+    info += QString("\tVersion: %1\n").arg(dmiString(dmi, p[0x06]));
+    info += QString("\tSerial Number: %1\n").arg(dmiString(dmi, p[0x07]));
+    info += QString("\tAsset Tag: %1\n").arg(dmiString(dmi, p[0x08]));
+    if (dmi.length < 0x0D)
+        return;
+
+    info += QString("\tBoot-up State: %1\n").arg(tableValue(s_ChassisState, TABLE_SIZE(s_ChassisState), p[0x09]));
+    info += QString("\tPower Supply State: %1\n").arg(tableValue(s_ChassisState, TABLE_SIZE(s_ChassisState), p[0x0A]));
+    info += QString("\tThermal State: %1\n").arg(tableValue(s_ChassisState, TABLE_SIZE(s_ChassisState), p[0x0B]));
+    info += QString("\tSecurity Status: %1\n").arg(tableValue(s_ChassisSecurity, TABLE_SIZE(s_ChassisSecurity), p[0x0C]));
+    if (dmi.length < 0x11)
+        return;
+
+    info += QString("\tOEM Information: 0x%1\n").arg(QString("%1").arg(DWORD(p + 0x0D), 8, 16, QChar('0')).toUpper());
+    if (dmi.length < 0x13)
+        return;
+
+    info += QString("\tHeight: %1\n").arg(p[0x11] == 0 ? QString("Unspecified") : QString("%1 U").arg(p[0x11]));
+    info += QString("\tNumber Of Power Cords: %1\n").arg(p[0x12] == 0 ? QString("Unspecified") : QString::number(p[0x12]));
+    if (dmi.length < 0x15)
+        return;
+
+    int count = p[0x13];
+    int recordLen = p[0x14];
+    info += QString("\tContained Elements: %1\n").arg(count);
+    int skuOffset = 0x15 + count * recordLen;
+    if (dmi.length >= skuOffset + 1)
+        info += QString("\tSKU Number: %1\n").arg(dmiString(dmi, p[skuOffset]));
+}
+
+void DmiDecoder::decodeProcessor(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "Processor Information\n";
+    if (dmi.length < 0x1A)
+        return;
+
+    info += QString("\tSocket Designation: %1\n").arg(dmiString(dmi, p[0x04]));
+    info += QString("\tType: %1\n").arg(tableValue(s_ProcessorType, TABLE_SIZE(s_ProcessorType), p[0x05]));
+
+    int family = p[0x06];
+    if (family == 0xFE && dmi.length >= 0x2A)
+        family = WORD(p + 0x28);
+    info += QString("\tFamily: %1\n").arg(s_ProcessorFamily.value(family, OUT_OF_SPEC));
+
+    QString manufacturer = dmiString(dmi, p[0x07]);
+    info += QString("\tManufacturer: %1\n").arg(manufacturer);
+
+    QStringList id;
+    for (int i = 0; i < 8; ++i)
+        id << QString("%1").arg(p[0x08 + i], 2, 16, QChar('0')).toUpper();
+    info += QString("\tID: %1\n").arg(id.join(" "));
+
+    // x86 处理器的 ID 为 CPUID 的 eax 和 edx
+    quint32 eax = DWORD(p + 0x08);
+    quint32 edx = DWORD(p + 0x0C);
+    bool isAmd = manufacturer.contains("AMD", Qt::CaseInsensitive) || manufacturer.contains("Hygon", Qt::CaseInsensitive);
+    bool isIntel = manufacturer.contains("Intel", Qt::CaseInsensitive) || manufacturer.contains("Zhaoxin", Qt::CaseInsensitive)
+                   || manufacturer.contains("Centaur", Qt::CaseInsensitive);
+    if (isIntel) {
+        info += QString("\tSignature: Type %1, Family %2, Model %3, Stepping %4\n")
+                .arg((eax >> 12) & 0x3)
+                .arg(((eax >> 20) & 0xFF) + ((eax >> 8) & 0x0F))
+                .arg(((eax >> 12) & 0xF0) + ((eax >> 4) & 0x0F))
+                .arg(eax & 0xF);
+    } else if (isAmd) {
+        quint32 baseFamily = (eax >> 8) & 0x0F;
+        info += QString("\tSignature: Family %1, Model %2, Stepping %3\n")
+                .arg(baseFamily + (baseFamily == 0x0F ? (eax >> 20) & 0xFF : 0))
+                .arg(((eax >> 4) & 0x0F) | (baseFamily == 0x0F ? (eax >> 12) & 0xF0 : 0))
+                .arg(eax & 0xF);
+    }
+    if (isIntel || isAmd) {
+        if ((edx & 0xBFEFFBFF) == 0) {
+            info += "\tFlags: None\n";
+        } else {
+            info += "\tFlags:\n";
+            info += flagLines(s_ProcessorFlags, TABLE_SIZE(s_ProcessorFlags), edx);
+        }
+    }
+
+    info += QString("\tVersion: %1\n").arg(dmiString(dmi, p[0x10]));
+
+    quint8 voltage = p[0x11];
+    if (voltage & 0x80) {
+        info += QString("\tVoltage: %1 V\n").arg(QString::number((voltage & 0x7F) / 10.0, 'f', 1));
+    } else {
+        QStringList volts;
+        if (voltage & 0x01)
+            volts << "5.0 V";
+        if (voltage & 0x02)
+            volts << "3.3 V";
+        if (voltage & 0x04)
+            volts << "2.9 V";
+        info += QString("\tVoltage: %1\n").arg(volts.isEmpty() ? QString("Unknown") : volts.join(" "));
+    }
+
+    quint16 clock = WORD(p + 0x12);
+    info += QString("\tExternal Clock: %1\n").arg(clock ? QString("%1 MHz").arg(clock) : QString("Unknown"));
+    quint16 maxSpeed = WORD(p + 0x14);
+    info += QString("\tMax Speed: %1\n").arg(maxSpeed ? QString("%1 MHz").arg(maxSpeed) : QString("Unknown"));
+    quint16 curSpeed = WORD(p + 0x16);
+    info += QString("\tCurrent Speed: %1\n").arg(curSpeed ? QString("%1 MHz").arg(curSpeed) : QString("Unknown"));
+
+    quint8 status = p[0x18];
+    if (status & (1 << 6))
+        info += QString("\tStatus: Populated, %1\n").arg(tableValue(s_ProcessorStatus, TABLE_SIZE(s_ProcessorStatus), status & 0x07, 0));
+    else
+        info += "\tStatus: Unpopulated\n";
+    info += QString("\tUpgrade: %1\n").arg(tableValue(s_ProcessorUpgrade, TABLE_SIZE(s_ProcessorUpgrade), p[0x19]));
+
+    if (dmi.length >= 0x20) {
+        const char *names[] = {"L1", "L2", "L3"};
+        for (int i = 0; i < 3; ++i) {
+            quint16 handle = WORD(p + 0x1A + i * 2);
+            if (handle == 0xFFFF)
+                info += QString("\t%1 Cache Handle: Not Provided\n").arg(names[i]);
+            else
+                info += QString("\t%1 Cache Handle: 0x%2\n").arg(names[i]).arg(QString("%1").arg(handle, 4, 16, QChar('0')).toUpper());
+        }
+    }
+
+    if (dmi.length >= 0x23) {
+        info += QString("\tSerial Number: %1\n").arg(dmiString(dmi, p[0x20]));
+        info += QString("\tAsset Tag: %1\n").arg(dmiString(dmi, p[0x21]));
+        info += QString("\tPart Number: %1\n").arg(dmiString(dmi, p[0x22]));
+    }
+
+    if (dmi.length >= 0x28) {
+        int coreCount = p[0x23];
+        int coreEnabled = p[0x24];
+        int threadCount = p[0x25];
+        if (dmi.length >= 0x30) {
+            if (coreCount == 0xFF)
+                coreCount = WORD(p + 0x2A);
+            if (coreEnabled == 0xFF)
+                coreEnabled = WORD(p + 0x2C);
+            if (threadCount == 0xFF)
+                threadCount = WORD(p + 0x2E);
+        }
+        if (coreCount)
+            info += QString("\tCore Count: %1\n").arg(coreCount);
+        if (coreEnabled)
+            info += QString("\tCore Enabled: %1\n").arg(coreEnabled);
+        if (threadCount)
+            info += QString("\tThread Count: %1\n").arg(threadCount);
+
+        quint16 characteristics = WORD(p + 0x26);
+        if (characteristics & 0x0002) {
+            info += "\tCharacteristics: Unknown\n";
+        } else if ((characteristics & 0x01FC) == 0) {
+            info += "\tCharacteristics: None\n";
+        } else {
+            info += "\tCharacteristics:\n";
+            info += flagLines(s_ProcessorCharacteristics, TABLE_SIZE(s_ProcessorCharacteristics), characteristics, 2);
+        }
+    }
+}
+
+void DmiDecoder::decodeLanguage(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "BIOS Language Information\n";
+    if (dmi.length < 0x16)
+        return;
+
+    info += QString("\tLanguage Description Format: %1\n").arg((p[0x05] & 0x01) ? "Abbreviated" : "Long");
+    info += QString("\tInstallable Languages: %1\n").arg(p[0x04]);
+    for (int i = 1; i <= p[0x04]; ++i)
+        info += QString("\t\t%1\n").arg(dmiString(dmi, static_cast<quint8>(i)));
+    info += QString("\tCurrently Installed Language: %1\n").arg(dmiString(dmi, p[0x15]));
+}
+
+void DmiDecoder::decodeMemoryArray(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "Physical Memory Array\n";
+    if (dmi.length < 0x0F)
+        return;
+
+    info += QString("\tLocation: %1\n").arg(tableValue(s_MemoryArrayLocation, TABLE_SIZE(s_MemoryArrayLocation), p[0x04]));
+    info += QString("\tUse: %1\n").arg(tableValue(s_MemoryArrayUse, TABLE_SIZE(s_MemoryArrayUse), p[0x05]));
+    info += QString("\tError Correction Type: %1\n").arg(tableValue(s_MemoryArrayEcc, TABLE_SIZE(s_MemoryArrayEcc), p[0x06]));
+
+    quint32 capacity = DWORD(p + 0x07);
+    if (capacity == 0x80000000 && dmi.length >= 0x17)
+        info += QString("\tMaximum Capacity: %1\n").arg(memorySize(QWORD(p + 0x0F), 0));
+    else
+        info += QString("\tMaximum Capacity: %1\n").arg(memorySize(capacity, 1));
+
+    quint16 handle = WORD(p + 0x0B);
+    if (handle == 0xFFFE)
+        info += "\tError Information Handle: Not Provided\n";
+    else if (handle == 0xFFFF)
+        info += "\tError Information Handle: No Error\n";
+    else
+        info += QString("\tError Information Handle: 0x%1\n").arg(QString("%1").arg(handle, 4, 16, QChar('0')).toUpper());
+    info += QString("\tNumber Of Devices: %1\n").arg(WORD(p + 0x0D));
+}
+
+void DmiDecoder::decodeMemoryDevice(const DmiStructure &dmi, QString &info) const
+{
+    const uchar *p = reinterpret_cast<const uchar *>(dmi.data.constData());
+    info += "Memory Device\n";
+    if (dmi.length < 0x15)
+        return;
+
+    info += QString("\tArray Handle: 0x%1\n").arg(QString("%1").arg(WORD(p + 0x04), 4, 16, QChar('0')).toUpper());
+    quint16 errHandle = WORD(p + 0x06);
+    if (errHandle == 0xFFFE)
+        info += "\tError Information Handle: Not Provided\n";
+    else if (errHandle == 0xFFFF)
+        info += "\tError Information Handle: No Error\n";
+    else
+        info += QString("\tError Information Handle: 0x%1\n").arg(QString("%1").arg(errHandle, 4, 16, QChar('0')).toUpper());
+
+    quint16 totalWidth = WORD(p + 0x08);
+    info += QString("\tTotal Width: %1\n").arg(totalWidth == 0xFFFF || totalWidth == 0 ? QString("Unknown") : QString("%1 bits").arg(totalWidth));
+    quint16 dataWidth = WORD(p + 0x0A);
+    info += QString("\tData Width: %1\n").arg(dataWidth == 0xFFFF || dataWidth == 0 ? QString("Unknown") : QString("%1 bits").arg(dataWidth));
+
+    quint16 size = WORD(p + 0x0C);
+    if (size == 0)
+        info += "\tSize: No Module Installed\n";
+    else if (size == 0xFFFF)
+        info += "\tSize: Unknown\n";
+    else if (size == 0x7FFF && dmi.length >= 0x20)
+        info += QString("\tSize: %1\n").arg(memorySize(DWORD(p + 0x1C) & 0x7FFFFFFF, 2));
+    else if (size & 0x8000)
+        info += QString("\tSize: %1\n").arg(memorySize(size & 0x7FFF, 1));
+    else
+        info += QString("\tSize: %1\n").arg(memorySize(size, 2));
+
+    info += QString("\tForm Factor: %1\n").arg(tableValue(s_MemoryFormFactor, TABLE_SIZE(s_MemoryFormFactor), p[0x0E]));
+    quint8 set = p[0x0F];
+    info += QString("\tSet: %1\n").arg(set == 0 ? QString("None") : (set == 0xFF ? QString("Unknown") : QString::number(set)));
+    info += QString("\tLocator: %1\n").arg(dmiString(dmi, p[0x10]));
+    info += QString("\tBank Locator: %1\n").arg(dmiString(dmi, p[0x11]));
+    info += QString("\tType: %1\n").arg(tableValue(s_MemoryType, TABLE_SIZE(s_MemoryType), p[0x12]));
+
+    quint16 detail = WORD(p + 0x13);
+    if ((detail & 0xFFFE) == 0) {
+        info += "\tType Detail: None\n";
+    } else {
+        QStringList details;
+        for (int i = 0; i < TABLE_SIZE(s_MemoryTypeDetail); ++i) {
+            if (detail & (1 << (i + 1)))
+                details << s_MemoryTypeDetail[i];
+        }
+        info += QString("\tType Detail: %1\n").arg(details.join(" "));
+    }
+    if (dmi.length < 0x17)
+        return;
+
+    quint16 speed = WORD(p + 0x15);
+    info += QString("\tSpeed: %1\n").arg(speed ? QString("%1 MT/s").arg(speed) : QString("Unknown"));
+    if (dmi.length < 0x1B)
+        return;
+
+    info += QString("\tManufacturer: %1\n").arg(dmiString(dmi, p[0x17]));
+    info += QString("\tSerial Number: %1\n").arg(dmiString(dmi, p[0x18]));
+    info += QString("\tAsset Tag: %1\n").arg(dmiString(dmi, p[0x19]));
+    info += QString("\tPart Number: %1\n").arg(dmiString(dmi, p[0x1A]));
+    if (dmi.length < 0x1C)
+        return;
+
+    quint8 rank = p[0x1B] & 0x0F;
+    info += QString("\tRank: %1\n").arg(rank ? QString::number(rank) : QString("Unknown"));
+    if (dmi.length < 0x22)
+        return;
+
+    quint16 confSpeed = WORD(p + 0x20);
+    info += QString("\tConfigured Memory Speed: %1\n").arg(confSpeed ? QString("%1 MT/s").arg(confSpeed) : QString("Unknown"));
+    if (dmi.length < 0x28)
+        return;
+
+    const char *voltNames[] = {"Minimum Voltage", "Maximum Voltage", "Configured Voltage"};
+    for (int i = 0; i < 3; ++i) {
+        quint16 mv = WORD(p + 0x22 + i * 2);
+        if (mv == 0)
+            info += QString("\t%1: Unknown\n").arg(voltNames[i]);
+        else
+            info += QString("\t%1: %2 V\n").arg(voltNames[i]).arg(QString::number(mv / 1000.0, 'f', mv % 100 ? 3 : 1));
+    }
+}
+
+QString DmiDecoder::dmiString(const DmiStructure &dmi, quint8 index)
+{
+    if (index == 0)
+        return "Not Specified";
+    if (index > dmi.strings.size())
+        return "<BAD INDEX>";
+
+    // 与 dmidecode 一致，不可打印字符替换为 '.'
+    QByteArray str = dmi.strings[index - 1];
+    for (int i = 0; i < str.size(); ++i) {
+        uchar c = static_cast<uchar>(str[i]);
+        if (c < 32 || c == 127)
+            str[i] = '.';
+    }
+    return QString::fromLatin1(str);
+}
+
+QString DmiDecoder::memorySize(quint64 value, int shift)
+{
+    const char *units[] = {"bytes", "kB", "MB", "GB", "TB", "PB", "EB", "ZB"};
+    quint64 split[7];
+    for (int i = 0; i < 7; ++i)
+        split[i] = (value >> (i * 10)) & 0x3FF;
+
+    // 找到最高的非0单位，如果下一个单位也非0，则使用下一个单位
+    int i = 6;
+    for (; i > 0; --i) {
+        if (split[i])
+            break;
+    }
+    quint64 capacity = split[i];
+    if (i > 0 && split[i - 1]) {
+        --i;
+        capacity = split[i] + (split[i + 1] << 10);
+    }
+    return QString("%1 %2").arg(capacity).arg(units[i + shift]);
+}
+
+QString DmiDecoder::uuid(const uchar *p) const
+{
+    bool allZero = true, allFF = true;
+    for (int i = 0; i < 16; ++i) {
+        if (p[i] != 0x00)
+            allZero = false;
+        if (p[i] != 0xFF)
+            allFF = false;
+    }
+    if (allFF)
+        return "Not Present";
+    if (allZero)
+        return "Not Settable";
+
+    // SMBIOS 2.6 之后前三个字段为小端序
+    QString str;
+    int order[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    if (m_Major > 2 || (m_Major == 2 && m_Minor >= 6)) {
+        int le[8] = {3, 2, 1, 0, 5, 4, 7, 6};
+        for (int i = 0; i < 8; ++i)
+            order[i] = le[i];
+    }
+    for (int i = 0; i < 16; ++i) {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            str += "-";
+        str += QString("%1").arg(p[order[i]], 2, 16, QChar('0')).toUpper();
+    }
+    return str;
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DMIDECODER_H
+#define DMIDECODER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QList>
+
+/**
+ * @brief The DmiStructure struct : one SMBIOS structure
+ */
+struct DmiStructure {
+    quint8 type = 0;                //<! structure type
+    quint8 length = 0;              //<! length of the formatted area
+    quint16 handle = 0;             //<! handle
+    QByteArray data;                //<! formatted area, include the header
+    QList<QByteArray> strings;      //<! string set, index 1 is strings[0]
+};
+
+/**
+ * @brief The DmiDecoder class
+ * 一次读取 /sys/firmware/dmi/tables 下的 smbios_entry_point 和 DMI 并解析所有结构，
+ * 生成与 dmidecode -t N 和 dmidecode -s system-product-name 相同格式的信息
+ */
+class DmiDecoder
+{
+public:
+    explicit DmiDecoder(const QString &path = "/sys/firmware/dmi/tables");
+
+    /**
+     * @brief load : read and parse smbios_entry_point and DMI
+     * @return false if the tables can not be read
+     */
+    bool load();
+
+    /**
+     * @brief loadFromData : parse the entry point and table from memory
+     * @param entry : content of smbios_entry_point
+     * @param table : content of DMI
+     * @return
+     */
+    bool loadFromData(const QByteArray &entry, const QByteArray &table);
+
+    /**
+     * @brief version : SMBIOS version, such as 3.2.0
+     * @return
+     */
+    const QString &version() const;
+
+    /**
+     * @brief structures
+     * @return
+     */
+    const QList<DmiStructure> &structures() const;
+
+    /**
+     * @brief typeInfo : the same output as dmidecode -t type
+     * @param type
+     * @return
+     */
+    QString typeInfo(int type) const;
+
+    /**
+     * @brief systemProductName : the same output as dmidecode -s system-product-name
+     * @return
+     */
+    QString systemProductName() const;
+
+private:
+    /**
+     * @brief parseEntryPoint
+     * @param entry
+     * @return
+     */
+    bool parseEntryPoint(const QByteArray &entry);
+
+    /**
+     * @brief parseTable
+     * @param table
+     */
+    void parseTable(const QByteArray &table);
+
+    /**
+     * @brief decode : decode one structure
+     * @param dmi
+     * @param info
+     */
+    void decode(const DmiStructure &dmi, QString &info) const;
+
+    void decodeBios(const DmiStructure &dmi, QString &info) const;
+    void decodeSystem(const DmiStructure &dmi, QString &info) const;
+    void decodeBaseBoard(const DmiStructure &dmi, QString &info) const;
+    void decodeChassis(const DmiStructure &dmi, QString &info) const;
+    void decodeProcessor(const DmiStructure &dmi, QString &info) const;
+    void decodeLanguage(const DmiStructure &dmi, QString &info) const;
+    void decodeMemoryArray(const DmiStructure &dmi, QString &info) const;
+    void decodeMemoryDevice(const DmiStructure &dmi, QString &info) const;
+
+    /**
+     * @brief dmiString : get string by index, 0 is Not Specified
+     * @param dmi
+     * @param index
+     * @return
+     */
+    static QString dmiString(const DmiStructure &dmi, quint8 index);
+
+    /**
+     * @brief memorySize : the same as dmi_print_memory_size of dmidecode
+     * @param value
+     * @param shift : 0 bytes, 1 kB, 2 MB
+     * @return
+     */
+    static QString memorySize(quint64 value, int shift);
+
+    /**
+     * @brief uuid
+     * @param p
+     * @return
+     */
+    QString uuid(const uchar *p) const;
+
+private:
+    QString                 m_Path;            //<! /sys/firmware/dmi/tables
+    QString                 m_Version;         //<! SMBIOS version
+    int                     m_Major;           //<! major version
+    int                     m_Minor;           //<! minor version
+    QList<DmiStructure>     m_ListStructure;   //<! all structures
+};
+
+#endif // DMIDECODER_H
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "KernelConfig.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDateTime>
+#include <QDebug>
+
+#include <algorithm>
+
+#include <string.h>
+
+#include <sys/utsname.h>
+#include <zlib.h>
+
+#define CONFIG_LINE_SIZE 4096
+
+std::atomic<KernelConfig *> KernelConfig::s_Instance;
+std::mutex KernelConfig::m_mutex;
+
+KernelConfig::KernelConfig(const QString &cachePath, const QString &procPath, const QString &bootDir)
+    : m_CachePath(cachePath)
+    , m_ProcPath(procPath)
+    , m_BootDir(bootDir)
+{
+
+}
+
+bool KernelConfig::isBuiltIn(const QString &symbol)
+{
+    QByteArray name = symbol.trimmed().toLatin1();
+    if (name.startsWith("CONFIG_"))
+        name = name.mid(7);
+
+    load();
+    QMutexLocker locker(&m_Mutex);
+    return std::binary_search(m_Symbols.constBegin(), m_Symbols.constEnd(), name);
+}
+
+QVector<QByteArray> KernelConfig::symbols()
+{
+    load();
+    QMutexLocker locker(&m_Mutex);
+    return m_Symbols;
+}
+
+bool KernelConfig::load()
+{
+    struct utsname name;
+    QByteArray release = uname(&name) == 0 ? QByteArray(name.release) : QByteArray();
+
+    // /proc/config.gz 由内核生成，修改时间没有意义，只用内核版本区分
+    QString path;
+    bool gzip = QFile::exists(m_ProcPath);
+    QByteArray stamp = release;
+    if (gzip) {
+        path = m_ProcPath;
+        stamp += " proc";
+    } else {
+        path = m_BootDir + "/config-" + QString::fromLatin1(release);
+        QFileInfo info(path);
+        if (!info.exists())
+            return false;
+        stamp += " " + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+    }
+
+    QMutexLocker locker(&m_Mutex);
+    if (stamp == m_Stamp)
+        return true;
+    if (loadCache(stamp))
+        return true;
+
+    QVector<QByteArray> symbols;
+    bool ok = gzip ? readGzip(path, symbols) : readPlain(path, symbols);
+    if (!ok)
+        return false;
+
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    m_Symbols = symbols;
+    m_Stamp = stamp;
+    saveCache(stamp);
+    return true;
+}
+
+void KernelConfig::parseLine(const char *line, int len, QVector<QByteArray> &symbols)
+{
+    // CONFIG_USB_STORAGE=y
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+        --len;
+    if (len < 10 || strncmp(line, "CONFIG_", 7) != 0 || line[len - 2] != '=' || line[len - 1] != 'y')
+        return;
+    symbols.append(QByteArray(line + 7, len - 9));
+}
+
+bool KernelConfig::readGzip(const QString &path, QVector<QByteArray> &symbols)
+{
+    gzFile file = gzopen(path.toLocal8Bit().constData(), "rb");
+    if (!file)
+        return false;
+
+    // 逐行解压，不需要先把整个配置解压到内存
+    char line[CONFIG_LINE_SIZE];
+    while (gzgets(file, line, sizeof(line))) {
+        parseLine(line, static_cast<int>(strlen(line)), symbols);
+    }
+
+    // gzgets 在结束和出错时都返回空，截断或损坏的文件只得到部分符号，不能缓存
+    int err = Z_OK;
+    gzerror(file, &err);
+    int ret = gzclose(file);
+    if (err != Z_OK || ret != Z_OK) {
+        qWarning() << "Failed to read kernel config" << path << ":" << err << ret;
+        return false;
+    }
+    return true;
+}
+
+bool KernelConfig::readPlain(const QString &path, QVector<QByteArray> &symbols)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    char line[CONFIG_LINE_SIZE];
+    qint64 len = 0;
+    while ((len = file.readLine(line, sizeof(line))) > 0) {
+        parseLine(line, static_cast<int>(len), symbols);
+    }
+    file.close();
+    return true;
+}
+
+bool KernelConfig::loadCache(const QByteArray &stamp)
+{
+    QFile file(m_CachePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // 第一行为内核版本和修改时间，之后每行一个符号，已经排序
+    QList<QByteArray> lines = file.readAll().split('\n');
+    file.close();
+    if (lines.isEmpty() || lines.first() != stamp)
+        return false;
+
+    QVector<QByteArray> symbols;
+    symbols.reserve(lines.size());
+    for (int i = 1; i < lines.size(); ++i) {
+        if (!lines[i].isEmpty())
+            symbols.append(lines[i]);
+    }
+    m_Symbols = symbols;
+    m_Stamp = stamp;
+    return true;
+}
+
+void KernelConfig::saveCache(const QByteArray &stamp)
+{
+    QDir().mkpath(QFileInfo(m_CachePath).absolutePath());
+
+    QSaveFile file(m_CachePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    file.write(stamp + "\n");
+    foreach (const QByteArray &symbol, m_Symbols) {
+        file.write(symbol + "\n");
+    }
+    if (!file.commit())
+        qWarning() << "Failed to save kernel config cache";
+}
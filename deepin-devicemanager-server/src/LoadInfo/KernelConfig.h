@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef KERNELCONFIG_H
+#define KERNELCONFIG_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QMutex>
+
+#include <mutex>
+#include <atomic>
+
+#define KERNEL_CONFIG_CACHE_PATH "/var/cache/deepin-devicemanager-server/kernel-config.cache"  // 内置符号的缓存
+
+/**
+ * @brief The KernelConfig class
+ * 在进程内读取内核配置，优先使用 /proc/config.gz，否则读取 /boot/config-$(uname -r)，
+ * 只保留 =y 的符号并排序，按内核版本和配置文件的修改时间缓存到磁盘
+ */
+class KernelConfig
+{
+public:
+    inline static KernelConfig *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        KernelConfig *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new KernelConfig();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief isBuiltIn : whether the symbol is built into the running kernel
+     * @param symbol : CONFIG_USB_STORAGE or USB_STORAGE
+     * @return
+     */
+    bool isBuiltIn(const QString &symbol);
+
+    /**
+     * @brief symbols : all built in symbols, sorted, without the CONFIG_ prefix
+     * @return
+     */
+    QVector<QByteArray> symbols();
+
+    /**
+     * @brief load : reload the config if the kernel release or the config file changed
+     * @return false if no config is found
+     */
+    bool load();
+
+protected:
+    explicit KernelConfig(const QString &cachePath = KERNEL_CONFIG_CACHE_PATH,
+                          const QString &procPath = "/proc/config.gz",
+                          const QString &bootDir = "/boot");
+
+private:
+    /**
+     * @brief parseLine : add the symbol if the line is CONFIG_XXX=y
+     * @param line
+     * @param len
+     * @param symbols
+     */
+    static void parseLine(const char *line, int len, QVector<QByteArray> &symbols);
+
+    /**
+     * @brief readGzip : stream the gzip config through zlib
+     * @param path
+     * @param symbols
+     * @return false if the file is truncated or corrupted
+     */
+    static bool readGzip(const QString &path, QVector<QByteArray> &symbols);
+
+    /**
+     * @brief readPlain
+     * @param path
+     * @param symbols
+     * @return
+     */
+    static bool readPlain(const QString &path, QVector<QByteArray> &symbols);
+
+    /**
+     * @brief loadCache : load the cache if it was made from the same config
+     * @param stamp : kernel release and mtime of the config
+     * @return
+     */
+    bool loadCache(const QByteArray &stamp);
+
+    /**
+     * @brief saveCache
+     * @param stamp
+     */
+    void saveCache(const QByteArray &stamp);
+
+private:
+    static std::atomic<KernelConfig *> s_Instance;
+    static std::mutex m_mutex;
+
+    QString                     m_CachePath;        //<! cache file
+    QString                     m_ProcPath;         //<! /proc/config.gz
+    QString                     m_BootDir;          //<! /boot
+    QMutex                      m_Mutex;            //<! lock of the following members
+    QByteArray                  m_Stamp;            //<! 当前符号对应的内核版本和修改时间
+    QVector<QByteArray>         m_Symbols;          //<! sorted built in symbols
+};
+
+#endif // KERNELCONFIG_H
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "KmsgReader.h"
+
+#include <QRegExp>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#define KMSG_RECORD_SIZE 8192    // 单条记录的最大长度，缓冲区不足时 read 返回 EINVAL
+
+std::atomic<KmsgReader *> KmsgReader::s_Instance;
+std::mutex KmsgReader::m_mutex;
+
+KmsgReader::KmsgReader(const QString &path)
+    : m_Path(path)
+    , m_Fd(-1)
+    , m_Seq(-1)
+{
+
+}
+
+KmsgReader::~KmsgReader()
+{
+    if (m_Fd >= 0)
+        close(m_Fd);
+}
+
+bool KmsgReader::readNew()
+{
+    QMutexLocker locker(&m_Mutex);
+    if (m_Fd < 0) {
+        m_Fd = open(m_Path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (m_Fd < 0) {
+            qWarning() << "Failed to open" << m_Path << ":" << strerror(errno);
+            return false;
+        }
+    }
+
+    // 每次 read 返回一条记录，没有新记录时返回 EAGAIN
+    char buf[KMSG_RECORD_SIZE];
+    while (true) {
+        ssize_t n = read(m_Fd, buf, sizeof(buf));
+        if (n > 0) {
+            parseRecord(QByteArray::fromRawData(buf, static_cast<int>(n)));
+            continue;
+        }
+        if (n < 0 && (errno == EINTR || errno == EPIPE))    // EPIPE : 未读取的记录已被覆盖，继续读取之后的记录
+            continue;
+        break;
+    }
+    return true;
+}
+
+QString KmsgReader::facts()
+{
+    QMutexLocker locker(&m_Mutex);
+    QString info;
+
+    // 没有 pci 地址的显存信息适用于所有显卡，放在最前面，之后按地址覆盖
+    if (m_MapVram.contains("null"))
+        info += QString("VRAM: null=%1\n").arg(m_MapVram.value("null"));
+    for (QMap<QString, QString>::const_iterator it = m_MapVram.begin(); it != m_MapVram.end(); ++it) {
+        if (it.key() != "null")
+            info += QString("VRAM: %1=%2\n").arg(it.key()).arg(it.value());
+    }
+    if (!m_AudioChip.isEmpty())
+        info += QString("AudioChip: %1\n").arg(m_AudioChip);
+    return info;
+}
+
+void KmsgReader::mergeFacts(const QString &facts)
+{
+    QMutexLocker locker(&m_Mutex);
+    foreach (const QString &line, facts.split("\n", QString::SkipEmptyParts)) {
+        if (line.startsWith("VRAM: ")) {
+            // VRAM: 0000:01:00.0=4GB
+            QString fact = line.mid(6);
+            int equal = fact.lastIndexOf('=');
+            if (equal > 0 && !m_MapVram.contains(fact.left(equal)))
+                m_MapVram.insert(fact.left(equal), fact.mid(equal + 1));
+        } else if (line.startsWith("AudioChip: ") && m_AudioChip.isEmpty()) {
+            m_AudioChip = line.mid(11);
+        }
+    }
+}
+
+void KmsgReader::parseRecord(const QByteArray &record)
+{
+    // 头部 : 优先级,序号,时间戳,标志;
+    int semicolon = record.indexOf(';');
+    if (semicolon < 0)
+        return;
+    QList<QByteArray> header = record.left(semicolon).split(',');
+    if (header.size() < 3)
+        return;
+
+    // 重新打开设备后跳过已经处理过的记录
+    qint64 seq = header[1].toLongLong();
+    if (seq <= m_Seq)
+        return;
+    m_Seq = seq;
+
+    // 消息到第一个换行为止，之后是 KEY=value 形式的附加信息
+    int end = record.indexOf('\n', semicolon + 1);
+    if (end < 0)
+        end = record.size();
+    QByteArray message = record.mid(semicolon + 1, end - semicolon - 1);
+
+    // 只有少数记录包含需要的信息，先做简单的字符串判断，避免对每条记录执行正则表达式
+    if (message.contains("VRAM") || message.contains("autoconfig for"))
+        parseMessage(QString::fromUtf8(message));
+}
+
+void KmsgReader::parseMessage(const QString &message)
+{
+    // amdgpu 0000:03:00.0: amdgpu: VRAM: 4096M 0x0000008000000000 - 0x00000080FFFFFFFF (4096M used)
+    QRegExp reg(".*([0-9a-z]{4}:[0-9a-z]{2}:[0-9a-z]{2}.[0-9]{1}):.*VRAM([=:]{1}) ([0-9]*)[\\s]{0,1}M.*");
+    if (reg.exactMatch(message)) {
+        double size = reg.cap(3).toDouble();
+        m_MapVram.insert(reg.cap(1), QString("%1GB").arg(size / 1024));
+    }
+
+    // Bug-85049 JJW 显存特殊处理
+    QRegExp regJJW(".*VRAM Size ([0-9]*)M.*");
+    if (regJJW.exactMatch(message)) {
+        double size = regJJW.cap(1).toDouble();
+        m_MapVram.insert("null", QString("%1GB").arg(size / 1024));
+    }
+
+    // snd_hda_codec_realtek hdaudioC0D0: autoconfig for ALC887-VD: line_outs=1 ...
+    QRegExp regChip(".*autoconfig for ([A-Za-z0-9]{6}( [A-Za-z0-9]+|-[A-Za-z0-9]+|)):.*");
+    if (regChip.exactMatch(message))
+        m_AudioChip = regChip.cap(1);
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef KMSGREADER_H
+#define KMSGREADER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+
+#include <mutex>
+#include <atomic>
+
+#define KMSG_PATH "/dev/kmsg"  // 内核日志设备
+
+/**
+ * @brief The KmsgReader class
+ * 保持 /dev/kmsg 打开，每次只读取上次之后新增的日志记录，
+ * 读取时提取客户端需要的显存大小和声卡芯片型号，不再保存整个内核日志
+ */
+class KmsgReader
+{
+public:
+    inline static KmsgReader *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        KmsgReader *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new KmsgReader();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief readNew : read the records after the cursor, never blocks
+     * @return false if the device can not be opened
+     */
+    bool readNew();
+
+    /**
+     * @brief facts : the extracted info, one fact per line
+     * VRAM: 0000:01:00.0=4GB
+     * VRAM: null=2GB
+     * AudioChip: ALC887-VD
+     * @return
+     */
+    QString facts();
+
+    /**
+     * @brief mergeFacts : add the facts restored from the snapshot, the facts read from kmsg are kept
+     * 守护进程在同一次开机中重启时，开机时的记录可能已经从环形缓冲区中覆盖
+     * @param facts : the same format as facts()
+     */
+    void mergeFacts(const QString &facts);
+
+protected:
+    explicit KmsgReader(const QString &path = KMSG_PATH);
+    ~KmsgReader();
+
+private:
+    /**
+     * @brief parseRecord : parse one record, such as "6,1234,5678901,-;message\n KEY=value\n"
+     * @param record
+     */
+    void parseRecord(const QByteArray &record);
+
+    /**
+     * @brief parseMessage : extract the facts from the message text
+     * @param message
+     */
+    void parseMessage(const QString &message);
+
+private:
+    static std::atomic<KmsgReader *> s_Instance;
+    static std::mutex m_mutex;
+
+    QString                     m_Path;             //<! kmsg device
+    int                         m_Fd;               //<! 保持打开，内核为每个打开的描述符维护读取位置
+    qint64                      m_Seq;              //<! 已经处理的最后一条记录的序号
+    QMutex                      m_Mutex;            //<! lock of the following facts
+    QMap<QString, QString>      m_MapVram;          //<! pci address or null -> vram size
+    QString                     m_AudioChip;        //<! audio codec chip
+};
+
+#endif // KMSGREADER_H
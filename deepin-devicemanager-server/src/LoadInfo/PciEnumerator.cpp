@@ -0,0 +1,322 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "PciEnumerator.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+#define IORESOURCE_IO       0x00000100
+#define IORESOURCE_MEM      0x00000200
+#define IORESOURCE_PREFETCH 0x00002000
+#define IORESOURCE_MEM_64   0x00100000
+
+// pci.ids 不存在时使用的类名，与 pci.ids 中的名称一致
+static const QHash<quint32, QString> s_BuiltinClass = {
+    {0x0100, "SCSI storage controller"}, {0x0101, "IDE interface"},
+    {0x0104, "RAID bus controller"}, {0x0106, "SATA controller"},
+    {0x0107, "Serial Attached SCSI controller"}, {0x0108, "Non-Volatile memory controller"},
+    {0x0200, "Ethernet controller"}, {0x0280, "Network controller"},
+    {0x0300, "VGA compatible controller"}, {0x0302, "3D controller"},
+    {0x0380, "Display controller"}, {0x0401, "Multimedia audio controller"},
+    {0x0403, "Audio device"}, {0x0500, "RAM memory"}, {0x0580, "Memory controller"},
+    {0x0600, "Host bridge"}, {0x0601, "ISA bridge"}, {0x0604, "PCI bridge"},
+    {0x0680, "Bridge"}, {0x0700, "Serial controller"}, {0x0780, "Communication controller"},
+    {0x0880, "System peripheral"}, {0x0c03, "USB controller"}, {0x0c05, "SMBus"},
+    {0x0c80, "Serial bus controller"}, {0x0d11, "Bluetooth"}, {0x1180, "Signal processing controller"},
+    {0x1300, "Non-Essential Instrumentation"}
+};
+
+/**
+ * @brief readAttr 读取sysfs属性文件
+ */
+static QString readAttr(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return "";
+    QString info = file.readAll();
+    file.close();
+    return info.trimmed();
+}
+
+PciEnumerator::PciEnumerator(const QString &sysfsPath, const QString &idsPath)
+    : m_SysfsPath(sysfsPath)
+    , m_IdsPath(idsPath)
+    , m_ShowDomain(false)
+{
+    if (m_IdsPath.isEmpty()) {
+        if (QFile::exists("/usr/share/misc/pci.ids"))
+            m_IdsPath = "/usr/share/misc/pci.ids";
+        else
+            m_IdsPath = "/usr/share/hwdata/pci.ids";
+    }
+}
+
+bool PciEnumerator::enumerate()
+{
+    m_ListDevice.clear();
+    m_ShowDomain = false;
+
+    QDir dir(m_SysfsPath);
+    if (!dir.exists())
+        return false;
+
+    // 目录名即为 domain:bus:slot.func，按名称排序与 lspci 的输出顺序一致
+    QStringList slots = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    foreach (const QString &slot, slots) {
+        PciDevice dev;
+        dev.slot = slot;
+        if (!readDevice(dir.filePath(slot), dev))
+            continue;
+        if (!slot.startsWith("0000:"))
+            m_ShowDomain = true;
+        m_ListDevice.append(dev);
+    }
+
+    loadNames();
+    return true;
+}
+
+const QList<PciDevice> &PciEnumerator::devices() const
+{
+    return m_ListDevice;
+}
+
+QString PciEnumerator::lspciInfo() const
+{
+    QString info;
+    foreach (const PciDevice &dev, m_ListDevice) {
+        info += deviceLine(dev);
+        info += "\n";
+    }
+    return info;
+}
+
+QString PciEnumerator::lspciVSInfo() const
+{
+    QString info;
+    foreach (const PciDevice &dev, m_ListDevice) {
+        // 只需要 ISA bridge 的信息，用于获取主板芯片组
+        if ((dev.classCode >> 8) != 0x0601)
+            continue;
+
+        info += deviceLine(dev) + "\n";
+        if (dev.subVendor != 0 || dev.subDevice != 0)
+            info += QString("\tSubsystem: %1\n").arg(subsystemName(dev));
+        if (dev.numaNode >= 0)
+            info += QString("\tNUMA node: %1\n").arg(dev.numaNode);
+        foreach (const PciResource &res, dev.resources) {
+            if (res.end <= res.start)
+                continue;
+            quint64 size = res.end - res.start + 1;
+            if (res.flags & IORESOURCE_MEM) {
+                info += QString("\tMemory at %1 (%2-bit, %3prefetchable) [size=%4]\n")
+                        .arg(res.start, 8, 16, QChar('0'))
+                        .arg((res.flags & IORESOURCE_MEM_64) ? 64 : 32)
+                        .arg((res.flags & IORESOURCE_PREFETCH) ? "" : "non-")
+                        .arg(sizeString(size));
+            } else if (res.flags & IORESOURCE_IO) {
+                info += QString("\tI/O ports at %1 [size=%2]\n").arg(res.start, 4, 16, QChar('0')).arg(sizeString(size));
+            }
+        }
+        if (!dev.driver.isEmpty())
+            info += QString("\tKernel driver in use: %1\n").arg(dev.driver);
+        info += "\n";
+        break;
+    }
+    return info;
+}
+
+QString PciEnumerator::widthInfo() const
+{
+    QString info;
+    foreach (const PciDevice &dev, m_ListDevice) {
+        // 0x03 : Display controller
+        if ((dev.classCode >> 16) != 0x03)
+            continue;
+        info += QString("%1-%2\n").arg(shortSlot(dev)).arg(memoryWidth(dev));
+    }
+    return info;
+}
+
+bool PciEnumerator::readDevice(const QString &path, PciDevice &dev)
+{
+    bool ok = false;
+    dev.classCode = readAttr(path + "/class").toUInt(&ok, 16);
+    if (!ok)
+        return false;
+    dev.vendor = static_cast<quint16>(readAttr(path + "/vendor").toUInt(nullptr, 16));
+    dev.device = static_cast<quint16>(readAttr(path + "/device").toUInt(nullptr, 16));
+    dev.subVendor = static_cast<quint16>(readAttr(path + "/subsystem_vendor").toUInt(nullptr, 16));
+    dev.subDevice = static_cast<quint16>(readAttr(path + "/subsystem_device").toUInt(nullptr, 16));
+    dev.revision = static_cast<int>(readAttr(path + "/revision").toUInt(nullptr, 16));
+
+    QString numa = readAttr(path + "/numa_node");
+    dev.numaNode = numa.isEmpty() ? -1 : numa.toInt();
+
+    QFileInfo driver(path + "/driver");
+    if (driver.isSymLink())
+        dev.driver = QFileInfo(driver.symLinkTarget()).fileName();
+
+    // resource 每行为 start end flags，前6行为BAR
+    QStringList lines = readAttr(path + "/resource").split("\n");
+    for (int i = 0; i < lines.size() && i < 6; ++i) {
+        QStringList words = lines[i].split(" ", QString::SkipEmptyParts);
+        if (words.size() != 3)
+            continue;
+        PciResource res;
+        res.start = words[0].toULongLong(nullptr, 16);
+        res.end = words[1].toULongLong(nullptr, 16);
+        res.flags = words[2].toULongLong(nullptr, 16);
+        dev.resources.append(res);
+    }
+    return true;
+}
+
+void PciEnumerator::loadNames()
+{
+    m_MapClass.clear();
+    m_MapVendor.clear();
+    m_MapDevice.clear();
+    m_MapSubsystem.clear();
+
+    // 只保存本机设备用到的名称，避免将整个 pci.ids 加载到内存
+    QSet<quint32> vendors;
+    QSet<quint64> devices;
+    QSet<quint64> subsystems;
+    foreach (const PciDevice &dev, m_ListDevice) {
+        vendors.insert(dev.vendor);
+        vendors.insert(dev.subVendor);
+        devices.insert((quint64(dev.vendor) << 16) | dev.device);
+        subsystems.insert((quint64(dev.vendor) << 48) | (quint64(dev.device) << 32) | (quint64(dev.subVendor) << 16) | dev.subDevice);
+    }
+
+    QFile file(m_IdsPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    quint32 curVendor = 0xffffffff;
+    quint32 curDevice = 0xffffffff;
+    quint32 curClass = 0xffffffff;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.endsWith('\n'))
+            line.chop(1);
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        if (line.startsWith("C ")) {
+            // C 06  Bridge
+            curVendor = 0xffffffff;
+            curClass = line.mid(2, 2).toUInt(nullptr, 16);
+            continue;
+        }
+        if (line.startsWith("\t\t")) {
+            // 子系统: \t\tssss dddd  name
+            if (curVendor == 0xffffffff || curDevice == 0xffffffff)
+                continue;
+            quint64 subKey = (quint64(curVendor) << 48) | (quint64(curDevice) << 32)
+                             | (quint64(line.mid(2, 4).toUInt(nullptr, 16)) << 16) | line.mid(7, 4).toUInt(nullptr, 16);
+            if (subsystems.contains(subKey))
+                m_MapSubsystem.insert(subKey, QString::fromUtf8(line.mid(13)));
+            continue;
+        }
+        if (line.startsWith('\t')) {
+            if (curClass != 0xffffffff && curVendor == 0xffffffff) {
+                // 子类: \txx  name
+                m_MapClass.insert((curClass << 8) | line.mid(1, 2).toUInt(nullptr, 16), QString::fromUtf8(line.mid(5)));
+                continue;
+            }
+            // 设备: \tdddd  name
+            curDevice = line.mid(1, 4).toUInt(nullptr, 16);
+            quint64 devKey = (quint64(curVendor) << 16) | curDevice;
+            if (devices.contains(devKey))
+                m_MapDevice.insert(devKey, QString::fromUtf8(line.mid(7)));
+            continue;
+        }
+
+        // 厂商: vvvv  name
+        curClass = 0xffffffff;
+        curDevice = 0xffffffff;
+        curVendor = line.left(4).toUInt(nullptr, 16);
+        if (vendors.contains(curVendor))
+            m_MapVendor.insert(curVendor, QString::fromUtf8(line.mid(6)));
+    }
+    file.close();
+}
+
+QString PciEnumerator::shortSlot(const PciDevice &dev) const
+{
+    if (m_ShowDomain || dev.slot.size() < 5)
+        return dev.slot;
+    return dev.slot.mid(5);
+}
+
+QString PciEnumerator::deviceLine(const PciDevice &dev) const
+{
+    QString line = QString("%1 %2: %3 %4").arg(shortSlot(dev))
+                   .arg(className(dev.classCode))
+                   .arg(vendorName(dev.vendor))
+                   .arg(deviceName(dev.vendor, dev.device));
+    if (dev.revision != 0)
+        line += QString(" (rev %1)").arg(dev.revision, 2, 16, QChar('0'));
+    return line;
+}
+
+QString PciEnumerator::className(quint32 classCode) const
+{
+    quint32 key = classCode >> 8;
+    if (m_MapClass.contains(key))
+        return m_MapClass[key];
+    if (s_BuiltinClass.contains(key))
+        return s_BuiltinClass[key];
+    return QString("Class %1").arg(key, 4, 16, QChar('0'));
+}
+
+QString PciEnumerator::vendorName(quint16 vendor) const
+{
+    if (m_MapVendor.contains(vendor))
+        return m_MapVendor[vendor];
+    return QString("Device %1").arg(vendor, 4, 16, QChar('0'));
+}
+
+QString PciEnumerator::deviceName(quint16 vendor, quint16 device) const
+{
+    quint64 key = (quint64(vendor) << 16) | device;
+    if (m_MapDevice.contains(key))
+        return m_MapDevice[key];
+    return QString("Device %1").arg(device, 4, 16, QChar('0'));
+}
+
+QString PciEnumerator::subsystemName(const PciDevice &dev) const
+{
+    quint64 key = (quint64(dev.vendor) << 48) | (quint64(dev.device) << 32) | (quint64(dev.subVendor) << 16) | dev.subDevice;
+    QString name = m_MapSubsystem.contains(key) ? m_MapSubsystem[key] : QString("Device %1").arg(dev.subDevice, 4, 16, QChar('0'));
+    return vendorName(dev.subVendor) + " " + name;
+}
+
+int PciEnumerator::memoryWidth(const PciDevice &dev)
+{
+    // 与 lspci -v 中第一个 Memory at 的位宽一致，没有内存BAR时默认64位
+    foreach (const PciResource &res, dev.resources) {
+        if (!(res.flags & IORESOURCE_MEM) || res.end <= res.start)
+            continue;
+        return (res.flags & IORESOURCE_MEM_64) ? 64 : 32;
+    }
+    return 64;
+}
+
+QString PciEnumerator::sizeString(quint64 size)
+{
+    const char *units[] = {"", "K", "M", "G", "T"};
+    int i = 0;
+    while (i < 4 && size >= 1024 && (size % 1024) == 0) {
+        size /= 1024;
+        ++i;
+    }
+    return QString::number(size) + units[i];
+}
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PCIENUMERATOR_H
+#define PCIENUMERATOR_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+
+/**
+ * @brief The PciResource struct : one line of /sys/bus/pci/devices/xxx/resource
+ */
+struct PciResource {
+    quint64 start = 0;
+    quint64 end = 0;
+    quint64 flags = 0;
+};
+
+/**
+ * @brief The PciDevice struct : the pci device info read from sysfs
+ */
+struct PciDevice {
+    QString slot;                   //<! 0000:00:1f.0
+    quint32 classCode = 0;          //<! 0x060100
+    quint16 vendor = 0;             //<! vendor id
+    quint16 device = 0;             //<! device id
+    quint16 subVendor = 0;          //<! subsystem vendor id
+    quint16 subDevice = 0;          //<! subsystem device id
+    int revision = 0;               //<! revision
+    int numaNode = -1;              //<! numa node, -1 means unknown
+    QString driver;                 //<! kernel driver in use
+    QList<PciResource> resources;   //<! BARs
+};
+
+/**
+ * @brief The PciEnumerator class
+ * 直接读取 /sys/bus/pci/devices 获取pci设备信息，生成与 lspci 和 lspci -v -s 相同格式的信息，避免启动子进程
+ */
+class PciEnumerator
+{
+public:
+    explicit PciEnumerator(const QString &sysfsPath = "/sys/bus/pci/devices", const QString &idsPath = "");
+
+    /**
+     * @brief enumerate : read all pci devices from sysfs
+     * @return false if the sysfs path can not be read
+     */
+    bool enumerate();
+
+    /**
+     * @brief devices
+     * @return
+     */
+    const QList<PciDevice> &devices() const;
+
+    /**
+     * @brief lspciInfo : the same format as lspci
+     * @return
+     */
+    QString lspciInfo() const;
+
+    /**
+     * @brief lspciVSInfo : the same format as lspci -v -s of the ISA bridge
+     * @return
+     */
+    QString lspciVSInfo() const;
+
+    /**
+     * @brief widthInfo : memory width of display devices, one "00:02.0-64" per line
+     * @return
+     */
+    QString widthInfo() const;
+
+private:
+    /**
+     * @brief readDevice : read /sys/bus/pci/devices/xxx
+     * @param path
+     * @param dev
+     * @return
+     */
+    bool readDevice(const QString &path, PciDevice &dev);
+
+    /**
+     * @brief loadNames : load the names of all enumerated ids from pci.ids
+     */
+    void loadNames();
+
+    /**
+     * @brief shortSlot : 0000:00:1f.0 -> 00:1f.0 if all devices are in domain 0
+     * @param dev
+     * @return
+     */
+    QString shortSlot(const PciDevice &dev) const;
+
+    /**
+     * @brief deviceLine : the line of the device in lspci
+     * @param dev
+     * @return
+     */
+    QString deviceLine(const PciDevice &dev) const;
+
+    /**
+     * @brief className
+     * @param classCode
+     * @return
+     */
+    QString className(quint32 classCode) const;
+
+    /**
+     * @brief vendorName
+     * @param vendor
+     * @return
+     */
+    QString vendorName(quint16 vendor) const;
+
+    /**
+     * @brief deviceName
+     * @param vendor
+     * @param device
+     * @return
+     */
+    QString deviceName(quint16 vendor, quint16 device) const;
+
+    /**
+     * @brief subsystemName
+     * @param dev
+     * @return
+     */
+    QString subsystemName(const PciDevice &dev) const;
+
+    /**
+     * @brief memoryWidth : 32 or 64, the width of the first memory BAR
+     * @param dev
+     * @return
+     */
+    static int memoryWidth(const PciDevice &dev);
+
+    /**
+     * @brief sizeString : 4096 -> 4K
+     * @param size
+     * @return
+     */
+    static QString sizeString(quint64 size);
+
+private:
+    QString                     m_SysfsPath;        //<! /sys/bus/pci/devices
+    QString                     m_IdsPath;          //<! pci.ids
+    QList<PciDevice>            m_ListDevice;       //<! all pci devices
+    bool                        m_ShowDomain;       //<! 存在非0 domain时显示domain
+    QHash<quint32, QString>     m_MapClass;         //<! class/subclass -> name
+    QHash<quint32, QString>     m_MapVendor;        //<! vendor -> name
+    QHash<quint64, QString>     m_MapDevice;        //<! vendor/device -> name
+    QHash<quint64, QString>     m_MapSubsystem;     //<! vendor/device/subvendor/subdevice -> name
+};
+
+#endif // PCIENUMERATOR_H
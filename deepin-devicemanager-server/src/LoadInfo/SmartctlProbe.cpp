@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "SmartctlProbe.h"
+#include "ProcessLauncher.h"
+#include "CollectorQuarantine.h"
+#include "CollectorMetrics.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFile>
+#include <QRegExp>
+#include <QDebug>
+
+// smartctl --all 输出中身份信息之后的数据段，SATA/SCSI 与 NVMe 的标题不同
+static const char *const s_DataSections[] = {
+    "=== START OF READ SMART DATA SECTION ===",
+    "=== START OF SMART DATA SECTION ==="
+};
+
+QMutex SmartctlProbe::s_CacheMutex;
+QMap<QString, QString> SmartctlProbe::s_MapIdentity;
+
+/**
+ * @brief The SmartctlRunnable class : probe one device in the thread pool
+ */
+class SmartctlRunnable : public QRunnable
+{
+public:
+    SmartctlRunnable(SmartctlProbe *probe, const QString &name)
+        : m_Probe(probe)
+        , m_Name(name)
+    {
+    }
+
+    void run() override
+    {
+        m_Probe->setResult(m_Name, m_Probe->probeDevice(m_Name));
+    }
+
+private:
+    SmartctlProbe *m_Probe;
+    QString m_Name;
+};
+
+SmartctlProbe::SmartctlProbe(int maxThread, int timeout)
+    : m_MaxThread(maxThread)
+    , m_Timeout(timeout)
+{
+
+}
+
+void SmartctlProbe::probe(const QStringList &names)
+{
+    m_MapResult.clear();
+    if (names.isEmpty())
+        return;
+
+    // 每个设备一个任务，同时运行的 smartctl 数量受 m_MaxThread 限制
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, qMin(m_MaxThread, names.size())));
+    foreach (const QString &name, names) {
+        // 之前超时过的硬盘不再执行，保留已有的信息
+        if (CollectorQuarantine::getInstance()->isQuarantined(quarantineEntry(name, sysfsKeys(name))))
+            continue;
+        SmartctlRunnable *task = new SmartctlRunnable(this, name);
+        task->setAutoDelete(true);
+        pool.start(task);
+    }
+    pool.waitForDone();
+}
+
+const QMap<QString, QString> &SmartctlProbe::results() const
+{
+    return m_MapResult;
+}
+
+QString SmartctlProbe::identitySection(const QString &info)
+{
+    for (const char *section : s_DataSections) {
+        int index = info.indexOf(section);
+        if (index > 0)
+            return info.left(index);
+    }
+    return "";
+}
+
+QString SmartctlProbe::dataSection(const QString &info)
+{
+    for (const char *section : s_DataSections) {
+        int index = info.indexOf(section);
+        if (index >= 0)
+            return info.mid(index);
+    }
+    return "";
+}
+
+QStringList SmartctlProbe::identityKeys(const QString &identity)
+{
+    QStringList keys;
+    QStringList lines = identity.split("\n");
+    foreach (const QString &line, lines) {
+        int index = line.indexOf(":");
+        if (index <= 0)
+            continue;
+
+        QString name = line.left(index).trimmed();
+        QString value = line.mid(index + 1).trimmed();
+        if (value.isEmpty())
+            continue;
+
+        // SATA/NVMe 为 Serial Number，SCSI 为 Serial number
+        if (name.compare("Serial Number", Qt::CaseInsensitive) == 0)
+            keys << "serial:" + value;
+        else if (name == "LU WWN Device Id" || name == "Logical Unit id")
+            keys << "wwn:" + normalizeWwn(value);
+    }
+    return keys;
+}
+
+void SmartctlProbe::clearCache()
+{
+    QMutexLocker locker(&s_CacheMutex);
+    s_MapIdentity.clear();
+}
+
+QString SmartctlProbe::probeDevice(const QString &name)
+{
+    QString device = "/dev/" + name;
+    QStringList keys = sysfsKeys(name);
+    QString entry = quarantineEntry(name, keys);
+
+    // 1. 身份信息已经缓存时，只读取健康状态和属性
+    QString identity = cachedIdentity(keys);
+    if (!identity.isEmpty()) {
+        QString info;
+        if (!runSmartctl(QStringList() << "-H" << "-A" << device, info)) {
+            CollectorQuarantine::getInstance()->add(entry);
+            return identity;
+        }
+        CollectorQuarantine::getInstance()->release(entry);
+        QString data = dataSection(info);
+        if (!data.isEmpty())
+            return identity + data;
+    }
+
+    // 2. 读取全部信息
+    QString info;
+    bool finished = runSmartctl(QStringList() << "--all" << device, info);
+    // 在使用smartctl的时候会出现对 /dev/sda 出现判断错误的情况，此时可以对/dev/sda1进行处理
+    if (finished && info.contains("Read Device Identity failed:"))
+        finished = runSmartctl(QStringList() << "--all" << device + "1", info);
+
+    // 3. 缓存身份信息，超时的结果可能不完整，不缓存，并隔离该设备
+    if (!finished) {
+        CollectorQuarantine::getInstance()->add(entry);
+    } else {
+        CollectorQuarantine::getInstance()->release(entry);
+        identity = identitySection(info);
+        if (!identity.isEmpty())
+            cacheIdentity(keys + identityKeys(identity), identity);
+    }
+    return info;
+}
+
+void SmartctlProbe::setResult(const QString &name, const QString &info)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_MapResult.insert(name, info);
+}
+
+bool SmartctlProbe::runSmartctl(const QStringList &args, QString &info)
+{
+    // 按设备分别统计
+    ProcessStat stat;
+    bool finished = ProcessLauncher::run("smartctl", args, m_Timeout, info, &stat);
+    CollectorMetrics::getInstance()->record("smartctl:" + args.last().section('/', -1), stat);
+    // 没有安装 smartctl 时输出为空，不作为超时隔离
+    return finished || !stat.started;
+}
+
+QStringList SmartctlProbe::sysfsKeys(const QString &name)
+{
+    QStringList keys;
+    QString devPath = name.startsWith("sg") ? "/sys/class/scsi_generic/" + name + "/device"
+                      : "/sys/class/block/" + name + "/device";
+
+    // WWN : SCSI/SATA 在 device/wwid，NVMe 在块设备目录下的 wwid
+    QStringList wwidFiles;
+    wwidFiles << devPath + "/wwid" << "/sys/class/block/" + name + "/wwid";
+    foreach (const QString &path, wwidFiles) {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly)) {
+            QString wwn = normalizeWwn(QString::fromLatin1(file.readAll()));
+            file.close();
+            if (!wwn.isEmpty()) {
+                keys << "wwn:" + wwn;
+                break;
+            }
+        }
+    }
+
+    // 序列号 : NVMe 在 device/serial，SCSI/SATA 在 VPD 0x80 页，前4个字节为页头
+    QFile serialFile(devPath + "/serial");
+    if (serialFile.open(QIODevice::ReadOnly)) {
+        QString serial = QString::fromLatin1(serialFile.readAll()).trimmed();
+        serialFile.close();
+        if (!serial.isEmpty())
+            keys << "serial:" + serial;
+    } else {
+        QFile vpdFile(devPath + "/vpd_pg80");
+        if (vpdFile.open(QIODevice::ReadOnly)) {
+            QByteArray vpd = vpdFile.readAll();
+            vpdFile.close();
+            QString serial = QString::fromLatin1(vpd.mid(4)).remove(QChar('\0')).trimmed();
+            if (!serial.isEmpty())
+                keys << "serial:" + serial;
+        }
+    }
+    return keys;
+}
+
+QString SmartctlProbe::quarantineEntry(const QString &name, const QStringList &keys)
+{
+    // 设备名在插拔后可能变化，有序列号或WWN时按硬盘隔离
+    return "smartctl:" + (keys.isEmpty() ? name : keys.first());
+}
+
+QString SmartctlProbe::normalizeWwn(const QString &wwn)
+{
+    QString value = wwn.trimmed().toLower();
+    value.remove(QRegExp("^(naa|eui|t10)\\."));
+    value.remove(QRegExp("^0x"));
+    value.remove(QRegExp("\\s"));
+    return value;
+}
+
+QString SmartctlProbe::cachedIdentity(const QStringList &keys)
+{
+    QMutexLocker locker(&s_CacheMutex);
+    foreach (const QString &key, keys) {
+        if (s_MapIdentity.contains(key))
+            return s_MapIdentity[key];
+    }
+    return "";
+}
+
+void SmartctlProbe::cacheIdentity(const QStringList &keys, const QString &identity)
+{
+    QMutexLocker locker(&s_CacheMutex);
+    foreach (const QString &key, keys) {
+        s_MapIdentity.insert(key, identity);
+    }
+}
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SMARTCTLPROBE_H
+#define SMARTCTLPROBE_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QMutex>
+
+class SmartctlRunnable;
+
+/**
+ * @brief The SmartctlProbe class
+ * 并发执行 smartctl，每个设备有独立的超时时间，
+ * 硬盘的静态身份信息按序列号和WWN缓存，刷新时只重新读取健康状态和属性，
+ * 超时的硬盘按序列号或WWN加入 CollectorQuarantine，之后不再探测
+ */
+class SmartctlProbe
+{
+    friend class SmartctlRunnable;
+public:
+    /**
+     * @brief SmartctlProbe
+     * @param maxThread : max number of smartctl running at the same time
+     * @param timeout : timeout of each smartctl in msec
+     */
+    explicit SmartctlProbe(int maxThread = 8, int timeout = 10000);
+
+    /**
+     * @brief probe : run smartctl for all devices, block until all are finished
+     * @param names : sda nvme0n1 sg0 ...
+     */
+    void probe(const QStringList &names);
+
+    /**
+     * @brief results : device name -> output of smartctl --all
+     * @return
+     */
+    const QMap<QString, QString> &results() const;
+
+    /**
+     * @brief identitySection : the part before the SMART data section
+     * @param info : output of smartctl
+     * @return empty if the output has no SMART data section
+     */
+    static QString identitySection(const QString &info);
+
+    /**
+     * @brief dataSection : the part from the SMART data section to the end
+     * @param info : output of smartctl
+     * @return
+     */
+    static QString dataSection(const QString &info);
+
+    /**
+     * @brief identityKeys : serial and WWN in the identity section, such as serial:XXX wwn:5000c500a1b2c3d4
+     * @param identity
+     * @return
+     */
+    static QStringList identityKeys(const QString &identity);
+
+    /**
+     * @brief clearCache
+     */
+    static void clearCache();
+
+private:
+    /**
+     * @brief probeDevice : get the smartctl info of one device
+     * @param name
+     * @return
+     */
+    QString probeDevice(const QString &name);
+
+    /**
+     * @brief setResult
+     * @param name
+     * @param info
+     */
+    void setResult(const QString &name, const QString &info);
+
+    /**
+     * @brief runSmartctl : run smartctl with timeout
+     * @param args
+     * @param info
+     * @return false if timeout
+     */
+    bool runSmartctl(const QStringList &args, QString &info);
+
+    /**
+     * @brief sysfsKeys : serial and WWN read from sysfs, no process needed
+     * @param name
+     * @return
+     */
+    static QStringList sysfsKeys(const QString &name);
+
+    /**
+     * @brief quarantineEntry : smartctl:wwn:XXX or smartctl:serial:XXX, smartctl:sdb if neither is found
+     * @param name
+     * @param keys : keys from sysfsKeys
+     * @return
+     */
+    static QString quarantineEntry(const QString &name, const QStringList &keys);
+
+    /**
+     * @brief normalizeWwn : naa.5000C500A1B2C3D4 and 5 000c50 0a1b2c3d4 -> 5000c500a1b2c3d4
+     * @param wwn
+     * @return
+     */
+    static QString normalizeWwn(const QString &wwn);
+
+    /**
+     * @brief cachedIdentity
+     * @param keys
+     * @return
+     */
+    static QString cachedIdentity(const QStringList &keys);
+
+    /**
+     * @brief cacheIdentity
+     * @param keys
+     * @param identity
+     */
+    static void cacheIdentity(const QStringList &keys, const QString &identity);
+
+private:
+    int                         m_MaxThread;        //<! max thread count
+    int                         m_Timeout;          //<! timeout of each device
+    QMutex                      m_Mutex;            //<! lock of m_MapResult
+    QMap<QString, QString>      m_MapResult;        //<! device name -> smartctl info
+
+    static QMutex               s_CacheMutex;       //<! lock of s_MapIdentity
+    static QMap<QString, QString> s_MapIdentity;    //<! serial/wwn -> identity section
+};
+
+#endif // SMARTCTLPROBE_H
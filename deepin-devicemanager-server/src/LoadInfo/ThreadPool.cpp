@@ -7,154 +7,167 @@
 #include "DeviceInfoManager.h"
 
 #include <QObjectCleanupHandler>
-#include <QProcess>
-#include <QDir>
-#include <QDateTime>
+#include <QMap>
 #include <QDebug>
 
 ThreadPool::ThreadPool(QObject *parent)
     : QThreadPool(parent)
 {
     initCmd();
-
-    QDir dir;
-    dir.mkdir(PATH);
 }
 
-void ThreadPool::loadDeviceInfo()
+void ThreadPool::loadDeviceInfo(bool force)
 {
     // 根据m_ListCmd生成所有设备信息
-    QList<Cmd>::iterator it = m_ListCmd.begin();
-    for (; it != m_ListCmd.end(); ++it) {
-        ThreadPoolTask *task = new ThreadPoolTask((*it).cmd, (*it).file, (*it).canNotReplace, (*it).waitingTime);
-        task->setAutoDelete(true);
-        start(task);
+    if (!force) {
+        runCmdGraph(m_ListCmd);
+        return;
     }
 
-    // 当所有设备执行完毕之后，开始执行生成其它设备的任务
-    // 这里是为了确保其它设备在最后一个生成
-    qint64 beginMSecond = QDateTime::currentMSecsSinceEpoch();
-    while (true) {
-        qint64 curMSecond = QDateTime::currentMSecsSinceEpoch();
-        if (activeThreadCount() == 0 || curMSecond - beginMSecond > 10000) {
-            break;
-        }
+    QList<Cmd> cmds = m_ListCmd;
+    for (Cmd &cmd : cmds) {
+        cmd.canNotReplace = false;
     }
+    runCmdGraph(cmds);
 }
 
 void ThreadPool::updateDeviceInfo()
 {
-    // 根据m_ListCmd生成所有设备信息
-    QList<Cmd>::iterator it = m_ListUpdate.begin();
-    for (; it != m_ListUpdate.end(); ++it) {
+    // 根据m_ListUpdate刷新设备信息
+    runCmdGraph(m_ListUpdate);
+}
+
+void ThreadPool::updateDeviceInfo(const QStringList &keys)
+{
+    // 选出需要刷新的命令，以及依赖这些命令输出的命令，如 lsblk_d -> smartctl
+    QSet<QString> setKey = keys.toSet();
+    bool added = true;
+    while (added) {
+        added = false;
+        foreach (const Cmd &cmd, m_ListUpdate) {
+            if (setKey.contains(cmd.key()))
+                continue;
+            foreach (const QString &depend, cmd.depends) {
+                if (setKey.contains(depend)) {
+                    setKey.insert(cmd.key());
+                    added = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    QList<Cmd> cmds;
+    foreach (const Cmd &cmd, m_ListUpdate) {
+        if (setKey.contains(cmd.key()))
+            cmds.append(cmd);
+    }
+    runCmdGraph(cmds);
+}
+
+QStringList ThreadPool::keysOfCategories(const QStringList &categories)
+{
+    // 热插拔设备类别与需要刷新的信息，hwinfo 和 lshw 包含所有外设，总是需要刷新
+    static const QMap<QString, QStringList> mapCategory = {
+        {"storage",   {"lsblk_d", "ls_sg"}},
+        {"printer",   {"lpstat"}},
+        {"bluetooth", {"hciconfig", "bt_device", "upower_dump"}},
+        {"input",     {"upower_dump"}},
+    };
+
+    QStringList keys;
+    keys << "hwinfo" << "lshw";
+    foreach (const QString &category, categories) {
+        foreach (const QString &key, mapCategory.value(category)) {
+            if (!keys.contains(key))
+                keys << key;
+        }
+    }
+    return keys;
+}
+
+void ThreadPool::runCmdGraph(const QList<Cmd> &cmds)
+{
+    m_Mutex.lock();
+    m_ListPending = cmds;
+    m_SetScheduled.clear();
+    m_SetFinished.clear();
+    foreach (const Cmd &cmd, cmds) {
+        m_SetScheduled.insert(cmd.key());
+    }
+    startReadyCmd();
+    bool done = m_SetScheduled.isEmpty();
+    m_Mutex.unlock();
+
+    // 信号不能在持锁时发出，避免槽函数重新调度时死锁
+    if (done) {
+        emit finished();
+    }
+}
+
+void ThreadPool::startReadyCmd()
+{
+    // 依赖的命令不在本轮调度中时，直接使用缓存中已有的信息
+    QList<Cmd>::iterator it = m_ListPending.begin();
+    while (it != m_ListPending.end()) {
+        bool ready = true;
+        foreach (const QString &depend, (*it).depends) {
+            if (m_SetScheduled.contains(depend) && !m_SetFinished.contains(depend)) {
+                ready = false;
+                break;
+            }
+        }
+        if (!ready) {
+            ++it;
+            continue;
+        }
+
         ThreadPoolTask *task = new ThreadPoolTask((*it).cmd, (*it).file, (*it).canNotReplace, (*it).waitingTime);
         task->setAutoDelete(true);
+        QString key = (*it).key();
+        // 任务在工作线程中发出信号，直接连接以便在同一线程内立即调度后续命令
+        connect(task, &ThreadPoolTask::finished, this, [this, key]() {
+            onCmdFinished(key);
+        }, Qt::DirectConnection);
         start(task);
-    }
-    // 当所有设备执行完毕之后，开始执行生成其它设备的任务
-    // 这里是为了确保其它设备在最后一个生成
-    qint64 beginMSecond = QDateTime::currentMSecsSinceEpoch();
-    while (true) {
-        qint64 curMSecond = QDateTime::currentMSecsSinceEpoch();
-        if (activeThreadCount() == 0 || curMSecond - beginMSecond > 10000) {
-            break;
-        }
+        it = m_ListPending.erase(it);
     }
 }
 
-void ThreadPool::runCmdToCache(const Cmd &cmd)
+void ThreadPool::onCmdFinished(const QString &key)
 {
-    QString key = cmd.file;
-    key.replace(".txt", "");
-
-    // 2. 执行命令获取设备信息
-    QString info;
-    QProcess process;
-    QString cmdT = cmd.cmd;
-    QStringList options;
-    options << "-c" << cmdT.replace(QString(" >  ") + PATH + cmd.file, "");
-    process.start("/bin/bash", options);
-    process.waitForFinished(-1);
-    info = process.readAllStandardOutput();
-    DeviceInfoManager::getInstance()->addInfo(key, info);
+    m_Mutex.lock();
+    m_SetFinished.insert(key);
+    startReadyCmd();
+    bool done = m_SetFinished.size() == m_SetScheduled.size();
+    m_Mutex.unlock();
+
+    if (done) {
+        emit finished();
+    }
 }
 
 void ThreadPool::initCmd()
 {
     // 添加lshw命令
     Cmd cmdLshw;
-    cmdLshw.cmd = QString("%1 %2%3").arg("lshw > ").arg(PATH).arg("lshw.txt");
+    cmdLshw.cmd = "lshw";
     cmdLshw.file = "lshw.txt";
     cmdLshw.canNotReplace = false;
+    cmdLshw.waitingTime = 60000;
     m_ListCmd.append(cmdLshw);
     m_ListUpdate.append(cmdLshw);
 
-    // 添加dmidecode -s system-product-name命令
-    Cmd cmdDmiSPN;
-    cmdDmiSPN.cmd = QString("%1 %2%3").arg("dmidecode -s system-product-name > ").arg(PATH).arg("dmidecode_spn.txt");
-    cmdDmiSPN.file = "dmidecode_spn.txt";
-    cmdDmiSPN.canNotReplace = true;
-    m_ListCmd.append(cmdDmiSPN);
-
-    // 添加dmidecode -t 0命令
-    Cmd cmdDmi0;
-    cmdDmi0.cmd = QString("%1 %2%3").arg("dmidecode -t 0 > ").arg(PATH).arg("dmidecode_0.txt");
-    cmdDmi0.file = "dmidecode_0.txt";
-    cmdDmi0.canNotReplace = true;
-    m_ListCmd.append(cmdDmi0);
-
-    // 添加dmidecode -t 1命令
-    Cmd cmdDmi1;
-    cmdDmi1.cmd = QString("%1 %2%3").arg("dmidecode -t 1 > ").arg(PATH).arg("dmidecode_1.txt");
-    cmdDmi1.file = "dmidecode_1.txt";
-    cmdDmi1.canNotReplace = true;
-    m_ListCmd.append(cmdDmi1);
-
-    // 添加dmidecode -t 2命令
-    Cmd cmdDmi2;
-    cmdDmi2.cmd = QString("%1 %2%3").arg("dmidecode -t 2 > ").arg(PATH).arg("dmidecode_2.txt");
-    cmdDmi2.file = "dmidecode_2.txt";
-    cmdDmi2.canNotReplace = true;
-    m_ListCmd.append(cmdDmi2);
-
-    // 添加dmidecode -t 3命令
-    Cmd cmdDmi3;
-    cmdDmi3.cmd = QString("%1 %2%3").arg("dmidecode -t 3 > ").arg(PATH).arg("dmidecode_3.txt");
-    cmdDmi3.file = "dmidecode_3.txt";
-    cmdDmi3.canNotReplace = true;
-    m_ListCmd.append(cmdDmi3);
-
-    // 添加dmidecode -t 4命令
-    Cmd cmdDmi4;
-    cmdDmi4.cmd = QString("%1 %2%3").arg("dmidecode -t 4 > ").arg(PATH).arg("dmidecode_4.txt");
-    cmdDmi4.file = "dmidecode_4.txt";
-    cmdDmi4.canNotReplace = true;
-    m_ListCmd.append(cmdDmi4);
-
-    // 添加dmidecode -t 13命令
-    Cmd cmdDmi13;
-    cmdDmi13.cmd = QString("%1 %2%3").arg("dmidecode -t 13 > ").arg(PATH).arg("dmidecode_13.txt");
-    cmdDmi13.file = "dmidecode_13.txt";
-    cmdDmi13.canNotReplace = true;
-    m_ListCmd.append(cmdDmi13);
-
-    // 添加dmidecode -t 16命令
-    Cmd cmdDmi16;
-    cmdDmi16.cmd = QString("%1 %2%3").arg("dmidecode -t 16 > ").arg(PATH).arg("dmidecode_16.txt");
-    cmdDmi16.file = "dmidecode_16.txt";
-    cmdDmi16.canNotReplace = true;
-    m_ListCmd.append(cmdDmi16);
-
-    // 添加dmidecode -t 17命令
-    Cmd cmdDmi17;
-    cmdDmi17.cmd = QString("%1 %2%3").arg("dmidecode -t 17 > ").arg(PATH).arg("dmidecode_17.txt");
-    cmdDmi17.file = "dmidecode_17.txt";
-    cmdDmi17.canNotReplace = true;
-    m_ListCmd.append(cmdDmi17);
+    // 添加dmidecode命令,一次解析SMBIOS表生成dmidecode_spn及dmidecode_0/1/2/3/4/13/16/17信息
+    Cmd cmdDmi;
+    cmdDmi.cmd = "dmidecode";
+    cmdDmi.file = "dmidecode.txt";
+    cmdDmi.canNotReplace = true;
+    m_ListCmd.append(cmdDmi);
 
     // 添加hwinfo --power命令
     Cmd cmdUpower;
-    cmdUpower.cmd = QString("%1 %2%3").arg("upower --dump > ").arg(PATH).arg("upower_dump.txt");
+    cmdUpower.cmd = "upower --dump";
     cmdUpower.file = "upower_dump.txt";
     cmdUpower.canNotReplace = true;
     m_ListCmd.append(cmdUpower);
@@ -162,7 +175,7 @@ void ThreadPool::initCmd()
 
     // 添加lscpu命令
     Cmd cmdLscpu;
-    cmdLscpu.cmd = "lscpu";//QString("%1 %2%3").arg("lscpu > ").arg(PATH).arg("lscpu.txt");
+    cmdLscpu.cmd = "lscpu";
     cmdLscpu.file = "lscpu.txt";
     cmdLscpu.canNotReplace = true;
     m_ListCmd.append(cmdLscpu);
@@ -170,23 +183,41 @@ void ThreadPool::initCmd()
 
     // 添加lsblk -d -o name,rota命令
     Cmd cmdLsblk;
-    cmdLsblk.cmd = QString("%1 %2%3").arg("lsblk -d -o name,rota > ").arg(PATH).arg("lsblk_d.txt");
+    cmdLsblk.cmd = "lsblk -d -o name,rota";
     cmdLsblk.file = "lsblk_d.txt";
     cmdLsblk.canNotReplace = false;
     m_ListCmd.append(cmdLsblk);
     m_ListUpdate.append(cmdLsblk);
 
-    // 添加lsblk -d -o name,rota命令
+    // 添加smartctl --all /dev/***命令,依赖lsblk的输出
+    Cmd cmdSmartctl;
+    cmdSmartctl.cmd = "smartctl";
+    cmdSmartctl.file = "smartctl.txt";
+    cmdSmartctl.canNotReplace = false;
+    cmdSmartctl.depends << cmdLsblk.key();
+    m_ListCmd.append(cmdSmartctl);
+    m_ListUpdate.append(cmdSmartctl);
+
+    // 添加/dev/sg*设备列表,在进程内读取
     Cmd cmdLssg;
-    cmdLssg.cmd = QString("%1 %2%3").arg("ls /dev/sg* > ").arg(PATH).arg("ls_sg.txt");
+    cmdLssg.cmd = "ls_sg";
     cmdLssg.file = "ls_sg.txt";
     cmdLssg.canNotReplace = false;
     m_ListCmd.append(cmdLssg);
     m_ListUpdate.append(cmdLssg);
 
-    // 添加lspci命令
+    // 添加smartctl --all /dev/sg*命令,依赖ls /dev/sg*的输出
+    Cmd cmdSgSmartctl;
+    cmdSgSmartctl.cmd = "smartctl_sg";
+    cmdSgSmartctl.file = "smartctl_sg.txt";
+    cmdSgSmartctl.canNotReplace = false;
+    cmdSgSmartctl.depends << cmdLssg.key();
+    m_ListCmd.append(cmdSgSmartctl);
+    m_ListUpdate.append(cmdSgSmartctl);
+
+    // 添加lspci命令,直接读取sysfs,同时生成lspci_vs和width信息
     Cmd cmdLspci;
-    cmdLspci.cmd = QString("%1 %2%3").arg("lspci > ").arg(PATH).arg("lspci.txt");
+    cmdLspci.cmd = "lspci";
     cmdLspci.file = "lspci.txt";
     cmdLspci.canNotReplace = false;
     m_ListCmd.append(cmdLspci);
@@ -194,23 +225,23 @@ void ThreadPool::initCmd()
 
     // 添加lpstat -a命令
     Cmd cmdLpstate;
-    cmdLpstate.cmd = QString("%1 %2%3").arg("lpstat -a > ").arg(PATH).arg("lpstat.txt");
+    cmdLpstate.cmd = "lpstat -a";
     cmdLpstate.file = "lpstat.txt";
     cmdLpstate.canNotReplace = false;
     m_ListCmd.append(cmdLpstate);
     m_ListUpdate.append(cmdLpstate);
 
-    // 添加dmesg命令
+    // 添加dmesg信息,增量读取/dev/kmsg,只生成dmesg_facts
     Cmd cmdDmesg;
-    cmdDmesg.cmd = QString("%1 %2%3").arg("dmesg > ").arg(PATH).arg("dmesg.txt");
+    cmdDmesg.cmd = "dmesg";
     cmdDmesg.file = "dmesg.txt";
-    cmdDmesg.canNotReplace = true;
+    cmdDmesg.canNotReplace = false;
     m_ListCmd.append(cmdDmesg);
     m_ListUpdate.append(cmdDmesg);
 
     // 添加hciconfig -a命令
     Cmd cmdHciconfig;
-    cmdHciconfig.cmd = QString("%1 %2%3").arg("hciconfig -a > ").arg(PATH).arg("hciconfig.txt");
+    cmdHciconfig.cmd = "hciconfig -a";
     cmdHciconfig.file = "hciconfig.txt";
     cmdHciconfig.canNotReplace = false;
     m_ListCmd.append(cmdHciconfig);
@@ -218,24 +249,25 @@ void ThreadPool::initCmd()
 
     // 添加bluetoothctl paired-devices命令
     Cmd cmdBluetooth;
-    cmdBluetooth.cmd = QString("%1 %2%3").arg("bluetoothctl paired-devices > ").arg(PATH).arg("bt_device.txt");
+    cmdBluetooth.cmd = "bluetoothctl paired-devices";
     cmdBluetooth.file = "bt_device.txt";
     cmdBluetooth.canNotReplace = false;
-    cmdBluetooth.waitingTime = 500;
+    cmdBluetooth.waitingTime = 2000;
     m_ListCmd.append(cmdBluetooth);
     m_ListUpdate.append(cmdBluetooth);
 
-    // 获取cat /boot/config* | grep '=y'信息
+    // 读取内核配置中'=y'的符号,在进程内解析/proc/config.gz或/boot/config-$(uname -r)
     Cmd cmdLsMod;
-    cmdLsMod.cmd = QString("%1 %2%3").arg("cat /boot/config* | grep '=y' > ").arg(PATH).arg("dr_config.txt");
+    cmdLsMod.cmd = "dr_config";
     cmdLsMod.file = "dr_config.txt";
     cmdLsMod.canNotReplace = true;
     m_ListCmd.append(cmdLsMod);
 
     Cmd cmdHwinfo;
-    cmdHwinfo.cmd = QString("%1 %2%3").arg("hwinfo --sound --network --keyboard --cdrom --disk --display --mouse --usb --fingerprint > ").arg(PATH).arg("hwinfo.txt");
+    cmdHwinfo.cmd = "hwinfo --sound --network --keyboard --cdrom --disk --display --mouse --usb --fingerprint";
     cmdHwinfo.file = "hwinfo.txt";
     cmdHwinfo.canNotReplace = false;
+    cmdHwinfo.waitingTime = 60000;
     m_ListCmd.append(cmdHwinfo);
     m_ListUpdate.append(cmdHwinfo);
 }
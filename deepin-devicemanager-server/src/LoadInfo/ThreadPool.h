@@ -10,18 +10,34 @@
 #include <QThreadPool>
 #include <QList>
 #include <QVector>
+#include <QStringList>
+#include <QSet>
+#include <QMutex>
+
+#include "ProcessLauncher.h"
 
 /**
  * @brief The Cmd struct
  */
 struct Cmd {
-    Cmd():cmd(""),file(""),canNotReplace(false),waitingTime(-1)
+    Cmd():cmd(""),file(""),canNotReplace(false),waitingTime(DEFAULT_CMD_TIMEOUT)
     {}
 
     QString cmd;         //<! the cmd
     QString file;        //<! the file
     bool canNotReplace;  //<! mark can replace or not
-    int waitingTime;     //<! waiting time
+    int waitingTime;     //<! deadline in msec, the process group is killed when expired
+    QStringList depends; //<! keys of the cmds whose output this cmd consumes
+
+    /**
+     * @brief key : the cache key of this cmd in DeviceInfoManager
+     * @return
+     */
+    QString key() const
+    {
+        QString k = file;
+        return k.replace(".txt", "");
+    }
 };
 
 /**
@@ -35,20 +51,53 @@ public:
 
     /**
      * @brief generateDeviceFile : load device info
+     * 按依赖关系调度所有命令，不阻塞调用线程，全部完成后发出 finished 信号
+     * @param force : 重新获取 canNotReplace 的信息，用于快照不是本次开机生成的情况
      */
-    void loadDeviceInfo();
+    void loadDeviceInfo(bool force = false);
 
     /**
      * @brief updateDeviceFile
+     * 按依赖关系调度需要刷新的命令，不阻塞调用线程，全部完成后发出 finished 信号
      */
     void updateDeviceInfo();
 
+    /**
+     * @brief updateDeviceInfo : only refresh the given keys and the cmds depending on them
+     * @param keys : cache keys, such as hwinfo lsblk_d
+     */
+    void updateDeviceInfo(const QStringList &keys);
+
+    /**
+     * @brief keysOfCategories : the cache keys invalidated by the hotplug categories
+     * @param categories : usb storage input printer bluetooth ...
+     * @return
+     */
+    static QStringList keysOfCategories(const QStringList &categories);
+
+signals:
+    /**
+     * @brief finished : all cmds of the current run are finished
+     */
+    void finished();
+
 private:
     /**
-     * @brief runCmdToCache
-     * @param cmd
+     * @brief runCmdGraph : schedule a list of cmds according to their depends
+     * @param cmds
+     */
+    void runCmdGraph(const QList<Cmd> &cmds);
+
+    /**
+     * @brief startReadyCmd : start every pending cmd whose depends are all finished, m_Mutex must be held
      */
-    void runCmdToCache(const Cmd &cmd);
+    void startReadyCmd();
+
+    /**
+     * @brief onCmdFinished : called in the worker thread when a cmd is finished
+     * @param key
+     */
+    void onCmdFinished(const QString &key);
 
     /**
      * @brief initCmd init all cmd
@@ -58,6 +107,11 @@ private:
 private:
     QList<Cmd>        m_ListCmd;             // all cmd
     QList<Cmd>        m_ListUpdate;          // update cmd
+
+    QMutex            m_Mutex;               // 保护以下调度状态
+    QList<Cmd>        m_ListPending;         // 依赖尚未满足的命令
+    QSet<QString>     m_SetScheduled;        // 本轮调度的所有命令
+    QSet<QString>     m_SetFinished;         // 本轮已经完成的命令
 };
 
 #endif // THREADPOOL_H
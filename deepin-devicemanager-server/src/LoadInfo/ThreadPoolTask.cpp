@@ -5,13 +5,25 @@
 #include "ThreadPoolTask.h"
 
 #include <QTime>
-#include <QProcess>
 #include <QFile>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QRegExp>
+#include <QSet>
 #include <unistd.h>
+#include <sys/resource.h>
 
 #include "DeviceInfoManager.h"
+#include "PciEnumerator.h"
+#include "DmiDecoder.h"
+#include "SmartctlProbe.h"
+#include "KmsgReader.h"
+#include "KernelConfig.h"
+#include "ProcessLauncher.h"
+#include "CollectorQuarantine.h"
+#include "CollectorMetrics.h"
+#include "CollectorBundle.h"
 #include "cpu/CpuInfo.h"
 
 ThreadPoolTask::ThreadPoolTask(QString cmd, QString file, bool replace, int waiting, QObject *parent)
@@ -19,7 +31,8 @@ ThreadPoolTask::ThreadPoolTask(QString cmd, QString file, bool replace, int wait
       m_Cmd(cmd),
       m_File(file),
       m_CanNotReplace(replace),
-      m_Waiting(waiting)
+      m_Waiting(waiting),
+      m_Spawned(false)
 {
 
 }
@@ -29,36 +42,86 @@ ThreadPoolTask::~ThreadPoolTask()
 
 }
 
+/**
+ * @brief threadCpuUsec : cpu time of the calling thread
+ */
+static qint64 threadCpuUsec()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+        return 0;
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
 void ThreadPoolTask::run()
 {
+    // 进程内的采集记录线程的耗时和cpu时间，外部命令在 runCmd 和 SmartctlProbe 中按子进程记录，同一个命令只在一层记录
+    QElapsedTimer timer;
+    timer.start();
+    qint64 cpuUsec = threadCpuUsec();
+    bool inProcess = true;
+
     if (m_Cmd == "lscpu") {
         loadCpuInfo();
-        return;
+    } else if (m_Cmd == "smartctl") {
+        // 依赖 lsblk 的输出，每个设备记录为 smartctl:<dev>
+        QString info = DeviceInfoManager::getInstance()->getInfo("lsblk_d");
+        loadSmartCtlInfoToCache(info);
+        inProcess = false;
+    } else if (m_Cmd == "smartctl_sg") {
+        // 依赖 ls /dev/sg* 的输出
+        QString info = DeviceInfoManager::getInstance()->getInfo("ls_sg");
+        loadSgSmartCtlInfoToCache(info);
+        inProcess = false;
+    } else if (m_Cmd == "lspci") {
+        loadPciInfo();
+    } else if (m_Cmd == "dmidecode") {
+        loadDmidecodeInfo();
+    } else if (m_Cmd == "ls_sg") {
+        loadSgDeviceInfo();
+    } else if (m_Cmd == "dr_config") {
+        loadKernelConfigInfo();
+    } else if (m_Cmd == "dmesg") {
+        loadKmsgInfo();
+    } else {
+        runCmdToCache(m_Cmd);
+        inProcess = false;
     }
-    runCmdToCache(m_Cmd);
-}
 
-void ThreadPoolTask::runCmd(const QString &cmd)
-{
-    QProcess process;
-    QStringList options;
-    options << "-c" << cmd;
-    process.start("/bin/bash", options);
-    process.waitForFinished(m_Waiting);
+    // 回退到外部命令时，如 dmidecode_N，已经按子进程记录
+    if (inProcess && !m_Spawned) {
+        ProcessStat stat;
+        stat.started = true;
+        stat.exitCode = 0;
+        stat.wallMsec = timer.elapsed();
+        stat.cpuUsec = threadCpuUsec() - cpuUsec;
+        CollectorMetrics::getInstance()->record(m_Cmd, stat);
+    }
+
+    // 通知调度器该命令已完成，可以开始执行依赖它的命令
+    emit finished();
 }
 
-void ThreadPoolTask::runCmd(const QString &cmd, QString &info)
+bool ThreadPoolTask::runCmd(const QString &cmd, const QString &collector, QString &info, bool *started)
 {
-    QProcess process;
-    QString cmdT = cmd;
-//    process.start(cmdT.replace(QString(" >  ") + PATH + m_File, ""));
+    if (started)
+        *started = true;
 
-    QStringList options;
-    options << "-c" << cmdT.replace(QString(" >  ") + PATH + m_File, "");
-    process.start("/bin/bash", options);
+    // 回放时读取录制的输出
+    if (CollectorBundle::getInstance()->isReplaying()) {
+        CollectorBundle::getInstance()->replayInfo(collector, info);
+        return true;
+    }
 
-    process.waitForFinished(m_Waiting);
-    info = process.readAllStandardOutput();
+    // 直接执行命令，不经过 bash，超时后结束整个进程组
+    ProcessStat stat;
+    bool finished = ProcessLauncher::runCommand(cmd, m_Waiting, info, &stat);
+    CollectorMetrics::getInstance()->record(collector, stat);
+    m_Spawned = true;
+    if (started)
+        *started = stat.started;
+    return finished;
 }
 
 void ThreadPoolTask::runCmdToCache(const QString &cmd)
@@ -72,34 +135,83 @@ void ThreadPoolTask::runCmdToCache(const QString &cmd)
         return;
     }
 
-    // 2. 执行命令获取设备信息
-    QString info;
-    runCmd(cmd, info);
-    // 3. 管理设备信息
-    // 如果命令是 lsblk  , 则需要执行 smartctl --all /dev/***命令
-    if (m_File == "lsblk_d.txt") {
-        loadSmartCtlInfoToCache(info);
+    // 2. 之前超时过的命令不再执行，保留已有的信息，回放时不受本机隔离的影响
+    if (!CollectorBundle::getInstance()->isReplaying() && CollectorQuarantine::getInstance()->isQuarantined(key)) {
+        // hwinfo 包含所有外设，改为按类别获取
+        if (key == "hwinfo") {
+            loadHwinfoByClass(cmd);
+            return;
+        }
+        qInfo() << "Skip quarantined collector :" << key;
+        return;
     }
 
-    // 如果命令是 ls /dev/sg* ,则需要执行 smartctl --all /dev/*** 命令
-    if (m_File == "ls_sg.txt") {
-        loadSgSmartCtlInfoToCache(info);
+    // 3. 执行命令获取设备信息
+    // smartctl 等后续命令由 ThreadPool 根据依赖关系调度
+    QString info;
+    bool started = true;
+    if (!runCmd(cmd, key, info, &started)) {
+        // 命令不存在或无法启动时没有任何输出，保留已有的信息，也不隔离
+        if (!started)
+            return;
+        CollectorQuarantine::getInstance()->add(key);
+        // 超时的输出可能不完整，已有信息时不替换
+        if (existed)
+            return;
+    } else {
+        CollectorQuarantine::getInstance()->release(key);
     }
 
-    // 如果命令是 lspci  , 则需要执行 lspci -v -s %1 > lspci_vs.txt 命令
-    if (m_File == "lspci.txt") {
-        loadLspciVSInfoToCache(info);
-    }
+    // 4. 管理设备信息
+    DeviceInfoManager::getInstance()->addInfo(key, info);
+}
 
-    if ("hwinfo_display.txt" == m_File) {
-        loadDisplayWidth(info);
+void ThreadPoolTask::loadHwinfoByClass(const QString &cmd)
+{
+    // 每个类别单独执行，超时时间较短，超时的类别加入隔离，如 hwinfo:display
+    QStringList classes = cmd.split(" ", QString::SkipEmptyParts).mid(1);
+    int waiting = m_Waiting;
+    m_Waiting = qMin(m_Waiting, HWINFO_CLASS_TIMEOUT);
+
+    QStringList blocks;
+    QSet<QString> ids;
+    bool loaded = false;
+    QRegExp reId("Unique ID: (\\S+)");
+    foreach (const QString &cls, classes) {
+        QString collector = "hwinfo:" + QString(cls).remove(QRegExp("^--"));
+        if (CollectorQuarantine::getInstance()->isQuarantined(collector))
+            continue;
+
+        QString info;
+        bool started = true;
+        if (!runCmd("hwinfo " + cls, collector, info, &started)) {
+            if (started)
+                CollectorQuarantine::getInstance()->add(collector);
+            continue;
+        }
+        CollectorQuarantine::getInstance()->release(collector);
+        loaded = true;
+
+        // 同一个设备可能属于多个类别，如USB鼠标，按 Unique ID 去重
+        foreach (const QString &block, info.split("\n\n", QString::SkipEmptyParts)) {
+            if (reId.indexIn(block) >= 0) {
+                if (ids.contains(reId.cap(1)))
+                    continue;
+                ids.insert(reId.cap(1));
+            }
+            blocks << block.trimmed();
+        }
     }
+    m_Waiting = waiting;
 
-    DeviceInfoManager::getInstance()->addInfo(key, info);
+    // 所有类别都超时时保留已有的信息
+    if (loaded)
+        DeviceInfoManager::getInstance()->addInfo("hwinfo", blocks.join("\n\n") + "\n");
 }
 
 void ThreadPoolTask::loadSmartCtlInfoToCache(const QString &info)
 {
+    QStringList names;
     QStringList lines = info.split("\n");
     foreach (QString line, lines) {
         QStringList words = line.replace(QRegExp("[\\s]+"), " ").split(" ");
@@ -107,171 +219,232 @@ void ThreadPoolTask::loadSmartCtlInfoToCache(const QString &info)
         if (words.size() != 2 || words[0] == "NAME") {
             continue;
         }
-
-        QString smartCmd = QString("smartctl --all /dev/%1").arg(words[0].trimmed());
-        QString sInfo;
-        runCmd(smartCmd, sInfo);
-        // 在使用smartctl的时候会出现对 /dev/sda 出现判断错误的情况，此时可以对/dev/sda1进行处理
-        if(sInfo.contains("Read Device Identity failed:")){
-            smartCmd = smartCmd + "1";
-            runCmd(smartCmd, sInfo);
-        }
-        DeviceInfoManager::getInstance()->addInfo(QString("smartctl_%1").arg(words[0].trimmed()), sInfo);
+        names.append(words[0].trimmed());
     }
+
+    loadSmartCtlInfo(names);
 }
 
 void ThreadPoolTask::loadCpuInfo()
 {
-    CpuInfo cpu;
+    CollectorBundle *bundle = CollectorBundle::getInstance();
+    CpuInfo cpu(bundle->sysPath("/sys/devices/system/cpu"), bundle->sysPath("/proc/cpuinfo"));
     if (cpu.loadCpuInfo()) {
         QString info;
         cpu.logicalCpus(info);
-        DeviceInfoManager::getInstance()->addInfo("lscpu", info);
 
         QString numInfo;
         numInfo += QString("%1 : %2\n").arg("physical").arg(cpu.physicalNum());
         numInfo += QString("%1 : %2\n").arg("core").arg(cpu.coreNum());
         numInfo += QString("%1 : %2\n").arg("logical").arg(cpu.logicalNum());
-        DeviceInfoManager::getInstance()->addInfo("lscpu_num", numInfo);
+
+        QMap<QString, QString> infos;
+        infos.insert("lscpu", info);
+        infos.insert("lscpu_num", numInfo);
+        DeviceInfoManager::getInstance()->addInfos(infos);
     }
 }
 
 void ThreadPoolTask::loadSgSmartCtlInfoToCache(const QString &info)
 {
+    QStringList names;
     QStringList lines = info.split("\n");
-
     foreach (QString line, lines) {
-        if (line.isEmpty()) {
+        QStringList words = line.split("/");
+        if (words.size() < 3) {
             continue;
         }
+        names.append(words[2].trimmed());
+    }
 
-        QStringList words = line.split("/");
+    loadSmartCtlInfo(names);
+}
+
+void ThreadPoolTask::loadSmartCtlInfo(const QStringList &names)
+{
+    QMap<QString, QString> infos;
+    if (CollectorBundle::getInstance()->isReplaying()) {
+        foreach (const QString &name, names) {
+            QString key = QString("smartctl_%1").arg(name);
+            QString info;
+            if (CollectorBundle::getInstance()->replayInfo(key, info))
+                infos.insert(key, info);
+        }
+        DeviceInfoManager::getInstance()->addInfos(infos);
+        return;
+    }
+
+    // 所有设备并发执行 smartctl，单个设备超时不会阻塞其它设备
+    SmartctlProbe probe;
+    probe.probe(names);
 
-        QString smartCmd = QString("smartctl --all /dev/%1").arg(words[2].trimmed());
-        QString sInfo;
-        runCmd(smartCmd, sInfo);
-        DeviceInfoManager::getInstance()->addInfo(QString("smartctl_%1").arg(words[2]), sInfo);
+    const QMap<QString, QString> &results = probe.results();
+    for (QMap<QString, QString>::const_iterator it = results.begin(); it != results.end(); ++it) {
+        infos.insert(QString("smartctl_%1").arg(it.key()), it.value());
     }
+    DeviceInfoManager::getInstance()->addInfos(infos);
 }
 
-void ThreadPoolTask::loadLspciVSInfoToCache(const QString &info)
+void ThreadPoolTask::loadPciInfo()
 {
-    QStringList lines = info.split("\n");
-    foreach (const QString &line, lines) {
-        QStringList words = line.split(" ");
-        if (words.size() < 2) {
-            continue;
-        }
-        if (words[1] == QString("ISA")) {
-            QString cmd = QString("lspci -v -s %1").arg(words[0].trimmed()); //  > /tmp/device-info/lspci_vs.txt
-            QString sInfo;
-            runCmd(cmd, sInfo);
-            DeviceInfoManager::getInstance()->addInfo("lspci_vs", sInfo);
-            break;
-        }
+    // 直接读取 /sys/bus/pci/devices，不再启动 lspci 和 lspci -v -s 子进程
+    PciEnumerator pci(CollectorBundle::getInstance()->sysPath("/sys/bus/pci/devices"));
+    if (!pci.enumerate() || pci.devices().isEmpty()) {
+        // 容器等环境中sysfs不可读时使用 lspci 命令
+        loadLspciCmdInfo();
+        return;
     }
+
+    QMap<QString, QString> infos;
+    infos.insert("lspci", pci.lspciInfo());
+    infos.insert("lspci_vs", pci.lspciVSInfo());
+    infos.insert("width", pci.widthInfo());
+    DeviceInfoManager::getInstance()->addInfos(infos);
 }
 
-void ThreadPoolTask::loadDisplayWidth(const QString &info)
+void ThreadPoolTask::loadLspciCmdInfo()
 {
-    QString widthS;
-    QStringList params = info.split("\n\n");
-    foreach (const QString &param, params) {
+    if (!CollectorBundle::getInstance()->isReplaying() && CollectorQuarantine::getInstance()->isQuarantined("lspci")) {
+        qInfo() << "Skip quarantined collector : lspci";
+        return;
+    }
+
+    QString info;
+    bool started = true;
+    if (!runCmd("lspci", "lspci", info, &started)) {
+        // 没有安装 lspci 时不隔离，保留已有的信息
+        if (started)
+            CollectorQuarantine::getInstance()->add("lspci");
+        return;
+    }
+    CollectorQuarantine::getInstance()->release("lspci");
 
-        QStringList lines = param.split("\n");
-        if (lines.size() < 5)
+    // ISA bridge 的 lspci -v -s 用于获取主板芯片组，显示设备的用于获取显存位宽
+    QMap<QString, QString> infos;
+    QString width;
+    foreach (const QString &line, info.split("\n")) {
+        QStringList words = line.split(" ");
+        if (words.size() < 2)
             continue;
-        foreach (const QString &line, lines) {
-            if (line.contains("SysFS ID")) {
-                QString pci = line.right(7);
-                int width = getDisplayWidthFromLspci(pci);
-                widthS += pci;
-                widthS += "-";
-                widthS += QString::number(width);
-                widthS += "\n";
-                break;
+        QString slot = words[0].trimmed();
+        bool isa = (words[1] == "ISA" && !infos.contains("lspci_vs"));
+        bool display = line.contains("VGA compatible controller") || line.contains("3D controller")
+                       || line.contains("Display controller");
+        if (!isa && !display)
+            continue;
+
+        QString vsInfo;
+        if (!runCmd(QString("lspci -v -s %1").arg(slot), isa ? "lspci_vs" : QString("lspci_vs_%1").arg(slot), vsInfo))
+            continue;
+        if (isa)
+            infos.insert("lspci_vs", vsInfo);
+        if (display) {
+            // 与 PciEnumerator::widthInfo 相同，没有 Memory at 时默认64位
+            int bits = 64;
+            foreach (const QString &vsLine, vsInfo.split("\n")) {
+                if (vsLine.contains("Memory at")) {
+                    bits = vsLine.contains("32-bit") ? 32 : 64;
+                    break;
+                }
             }
+            width += QString("%1-%2\n").arg(slot).arg(bits);
         }
-
-        DeviceInfoManager::getInstance()->addInfo("width", widthS);
     }
+
+    infos.insert("lspci", info);
+    infos.insert("width", width);
+    DeviceInfoManager::getInstance()->addInfos(infos);
 }
 
-int ThreadPoolTask::getDisplayWidthFromLspci(const QString &info)
+void ThreadPoolTask::loadDmidecodeInfo()
 {
-    QString cmd = QString("lspci -v -s %1").arg(info);
-    QString sInfo;
-    runCmd(cmd, sInfo);
-    QStringList lines = sInfo.split("\n");
-    foreach (const QString &line, lines) {
-        if (!line.contains("Memory at")) {
-            continue;
+    // 主板、内存等信息只需要开机获取一次
+    if (m_CanNotReplace && DeviceInfoManager::getInstance()->isInfoExisted("dmidecode_0")) {
+        return;
+    }
+
+    static const int types[] = {0, 1, 2, 3, 4, 13, 16, 17};
+
+    // 一次读取 /sys/firmware/dmi/tables 生成所有类型的信息
+    QMap<QString, QString> infos;
+    CollectorBundle *bundle = CollectorBundle::getInstance();
+    DmiDecoder dmi(bundle->sysPath("/sys/firmware/dmi/tables"));
+    if (dmi.load()) {
+        infos.insert("dmidecode_spn", dmi.systemProductName());
+        for (int type : types) {
+            infos.insert(QString("dmidecode_%1").arg(type), dmi.typeInfo(type));
+        }
+    } else if (bundle->isReplaying() || !CollectorQuarantine::getInstance()->isQuarantined("dmidecode")) {
+        // 内核未导出SMBIOS表时使用dmidecode命令
+        QString info;
+        bool started = true;
+        bool finished = runCmd("dmidecode -s system-product-name", "dmidecode_spn", info, &started);
+        // 没有安装 dmidecode 时不隔离，保留已有的信息
+        if (!started)
+            return;
+        // 超时的输出不完整，与 runCmdToCache 一样保留已有的信息
+        if (finished)
+            infos.insert("dmidecode_spn", info);
+        for (int type : types) {
+            if (!finished)
+                break;
+            finished = runCmd(QString("dmidecode -t %1").arg(type), QString("dmidecode_%1").arg(type), info);
+            if (finished)
+                infos.insert(QString("dmidecode_%1").arg(type), info);
         }
-        if (line.contains("32-bit"))
-            return 32;
+        if (!finished)
+            CollectorQuarantine::getInstance()->add("dmidecode");
         else
-            return 64;
+            CollectorQuarantine::getInstance()->release("dmidecode");
     }
-    return 64;
+    DeviceInfoManager::getInstance()->addInfos(infos);
 }
 
-void ThreadPoolTask::runCmdToFile(const QString &cmd)
+void ThreadPoolTask::loadSgDeviceInfo()
 {
-    // 1. 先判断通过该命令获取的信息是不是需要刷新的,如果是cpu，内存条，主板等信息则只需要开机获取即可
-    QString path = PATH + m_File;
-    QFile file(path);
-    if (m_CanNotReplace && file.exists()) {
+    QString info;
+    if (CollectorBundle::getInstance()->isReplaying()) {
+        CollectorBundle::getInstance()->replayInfo("ls_sg", info);
+        DeviceInfoManager::getInstance()->addInfo("ls_sg", info);
         return;
     }
 
-    // 2. 执行命令获取设备信息
-    runCmd(cmd);
-
-    if (m_File == "lsblk_d.txt") {
-        // 如果命令是 lsblk  , 则需要执行 smartctl --all /dev/***命令
-        loadSmartctlInfoToFile(file);
-    } else if (m_File == "lspci.txt") {
-        // 如果命令是 lspci  , 则需要执行 lspci -v -s %1 > lspci_vs.txt 命令
-        loadLspciVSInfoToFile(file);
+    // 代替 ls /dev/sg*，输出格式相同
+    QStringList names = QDir("/dev").entryList(QStringList() << "sg*", QDir::System | QDir::Files, QDir::Name);
+    foreach (const QString &name, names) {
+        info += "/dev/" + name + "\n";
     }
+    DeviceInfoManager::getInstance()->addInfo("ls_sg", info);
 }
 
-
-void ThreadPoolTask::loadSmartctlInfoToFile(QFile &file)
+void ThreadPoolTask::loadKernelConfigInfo()
 {
-    if (file.open(QIODevice::ReadOnly)) {
-        QString info = file.readAll();
-        QStringList lines = info.split("\n");
-        foreach (QString line, lines) {
-            QStringList words = line.replace(QRegExp("[\\s]+"), " ").split(" ");
-            // NAME ROTA
-            if (words.size() != 2 || words[0] == "NAME") {
-                continue;
-            }
-
-            QString smartCmd = QString("smartctl --all /dev/%1 > /tmp/device-info/smartctl_%2.txt").arg(words[0].trimmed()).arg(words[0].trimmed());
-            runCmd(smartCmd);
-        }
-        file.close();
-    }
+    // 只在进程内读取并缓存 =y 的符号，客户端通过 isKernelConfigBuiltIn 查询，不再保存整个配置
+    if (!KernelConfig::getInstance()->load())
+        qInfo() << "Kernel config not found";
 }
 
-void ThreadPoolTask::loadLspciVSInfoToFile(QFile &file)
+void ThreadPoolTask::loadKmsgInfo()
 {
-    if (file.open(QIODevice::ReadOnly)) {
-        QString info = file.readAll();
-        QStringList lines = info.split("\n");
-        foreach (const QString &line, lines) {
-            QStringList words = line.split(" ");
-            if (words.size() < 2) {
-                continue;
-            }
-            if (words[1] == QString("ISA")) {
-                QString cmd = QString("lspci -v -s %1 > /tmp/device-info/lspci_vs.txt").arg(words[0].trimmed());
-                runCmd(cmd);
-                break;
-            }
-        }
-        file.close();
+    // 回放录制时提取的信息，不读取本机的内核日志
+    if (CollectorBundle::getInstance()->isReplaying()) {
+        QString facts;
+        CollectorBundle::getInstance()->replayInfo("dmesg_facts", facts);
+        DeviceInfoManager::getInstance()->addInfo("dmesg_facts", facts);
+        return;
     }
+
+    // 只读取上次之后新增的内核日志，缓存中只保存提取出的显存和声卡芯片信息
+    // 合并快照中恢复的信息，同一次开机中重启后读不到开机时的记录，不能用空的信息覆盖
+    DeviceInfoManager *manager = DeviceInfoManager::getInstance();
+    QString cached = manager->getInfo("dmesg_facts");
+    KmsgReader *reader = KmsgReader::getInstance();
+    reader->mergeFacts(cached);
+    if (!reader->readNew())
+        return;
+
+    // 只在信息变化时发布，避免增加版本号
+    QString facts = reader->facts();
+    if (!facts.isEmpty() && facts != cached)
+        manager->addInfo("dmesg_facts", facts);
 }
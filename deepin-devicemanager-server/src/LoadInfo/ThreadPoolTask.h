@@ -8,10 +8,8 @@
 
 #include <QObject>
 #include <QRunnable>
-#include <QFile>
 
-//#define PATH "/home/liujun/device-info/"
-#define PATH "/tmp/device-info/"  // 设备文件存放的目录
+#define HWINFO_CLASS_TIMEOUT 10000      // 按类别获取 hwinfo 时每个类别的超时时间
 
 /**
  * @brief The ThreadPoolTask class
@@ -34,17 +32,14 @@ protected:
 
 private:
     /**
-     * @brief runCmd : running a command
-     * @param cmd : the command
-     */
-    void runCmd(const QString &cmd);
-
-    /**
-     * @brief runCmd
-     * @param cmd
+     * @brief runCmd : run the cmd directly without shell
+     * @param cmd : such as "lsblk -d -o name,rota"
+     * @param collector : name of the cmd in CollectorMetrics
      * @param info
+     * @param started : false if the cmd could not be started, may be null
+     * @return false if the cmd could not be started or timed out and was killed
      */
-    void runCmd(const QString &cmd, QString &info);
+    bool runCmd(const QString &cmd, const QString &collector, QString &info, bool *started = nullptr);
 
     /**
      * @brief runCmdToCache
@@ -52,6 +47,12 @@ private:
      */
     void runCmdToCache(const QString &cmd);
 
+    /**
+     * @brief loadHwinfoByClass : run hwinfo for each class with a short deadline after the full hwinfo timed out
+     * @param cmd : such as "hwinfo --sound --network"
+     */
+    void loadHwinfoByClass(const QString &cmd);
+
     /**
      * @brief loadSmartCtlInfoToCache
      * @param info
@@ -70,47 +71,47 @@ private:
     void loadSgSmartCtlInfoToCache(const QString &info);
 
     /**
-     * @brief loadLspciVSInfoToCache
-     * @param info
+     * @brief loadSmartCtlInfo : run smartctl for the devices concurrently
+     * @param names : sda nvme0n1 sg0 ...
      */
-    void loadLspciVSInfoToCache(const QString &info);
+    void loadSmartCtlInfo(const QStringList &names);
 
     /**
-     * @brief loadDisplayWidth
-     * @param info
+     * @brief loadPciInfo : load lspci, lspci_vs and width info from sysfs
      */
-    void loadDisplayWidth(const QString &info);
+    void loadPciInfo();
 
     /**
-     * @brief getDisplayWidthFromLspci
-     * @param info
-     * @return
+     * @brief loadLspciCmdInfo : load lspci, lspci_vs and width info by the lspci cmd when sysfs is not readable
      */
-    int getDisplayWidthFromLspci(const QString &info);
+    void loadLspciCmdInfo();
 
     /**
-     * @brief runCmdToTxt
-     * @param cmd
+     * @brief loadDmidecodeInfo : load dmidecode_spn and dmidecode_N info from the SMBIOS tables
+     */
+    void loadDmidecodeInfo();
+
+    /**
+     * @brief loadSgDeviceInfo : list /dev/sg* in process
      */
-    void runCmdToFile(const QString &cmd);
+    void loadSgDeviceInfo();
 
     /**
-     * @brief loadSmartctlInfoToFile
-     * @param file
+     * @brief loadKernelConfigInfo : load the built in symbols of the running kernel into KernelConfig
      */
-    void loadSmartctlInfoToFile(QFile &file);
+    void loadKernelConfigInfo();
 
     /**
-     * @brief loadLspciVSInfoToFile
-     * @param file
+     * @brief loadKmsgInfo : read the new records of /dev/kmsg and publish dmesg_facts
      */
-    void loadLspciVSInfoToFile(QFile &file);
+    void loadKmsgInfo();
 
 private:
     QString   m_Cmd;                  //<! cmd
     QString   m_File;                 //<! file name
     bool      m_CanNotReplace;        //<! Whether to replace if file existed
-    int       m_Waiting;              //<! waiting time
+    int       m_Waiting;              //<! deadline of the cmd in msec
+    bool      m_Spawned;              //<! whether a child process was started, its runs are recorded by runCmd
 };
 
 #endif // THREADPOOLTASK_H
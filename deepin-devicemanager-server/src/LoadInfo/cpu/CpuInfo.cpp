@@ -5,18 +5,82 @@
 #include "CpuInfo.h"
 
 #include <QFile>
-#include <QDir>
+#include <QVector>
+#include <QPair>
 #include <QDebug>
 
 #include <sys/utsname.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+
+/**
+ * @brief readAttr : 读取目录下的 sysfs 属性，去掉结尾的换行
+ * @return 长度，失败返回 -1
+ */
+static int readAttr(int dirFd, const char *name, char *buf, int size)
+{
+    int fd = openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    ssize_t len;
+    do {
+        len = read(fd, buf, static_cast<size_t>(size - 1));
+    } while (len < 0 && EINTR == errno);
+    close(fd);
+    if (len < 0)
+        return -1;
+    while (len > 0 && isspace(static_cast<unsigned char>(buf[len - 1])))
+        --len;
+    buf[len] = '\0';
+    return static_cast<int>(len);
+}
 
-CpuInfo::CpuInfo()
+/**
+ * @brief parseCpuList : 0-3,8,10-11
+ */
+static QVector<int> parseCpuList(const char *list)
+{
+    QVector<int> cpus;
+    const char *p = list;
+    while (*p) {
+        char *end = nullptr;
+        long first = strtol(p, &end, 10);
+        if (end == p)
+            break;
+        long last = first;
+        if ('-' == *end) {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p)
+                break;
+        }
+        for (long i = first; i <= last; ++i)
+            cpus.append(static_cast<int>(i));
+        if (',' != *end)
+            break;
+        p = end + 1;
+    }
+    return cpus;
+}
+
+CpuInfo::CpuInfo(const QString &sysCpuPath, const QString &cpuinfoPath)
     : m_Arch("unknow")
+    , m_SysCpuPath(sysCpuPath)
+    , m_CpuinfoPath(cpuinfoPath)
+    , m_CacheIndexNum(-1)
 {
 }
 CpuInfo::~CpuInfo()
 {
     // clear physicalcpu
+    m_HashLogicalCpu.clear();
     m_MapPhysicalCpu.clear();
 }
 
@@ -29,26 +93,7 @@ bool CpuInfo::loadCpuInfo()
     readSysCpu();
 
     // read the file /proc/cpuinfo
-    if (!readProcCpuinfo())
-        return false;
-
-    // 重新编号
-    QMap<int, PhysicalCpu> curMapPhysicalCpu = m_MapPhysicalCpu;
-    m_MapPhysicalCpu.clear();
-    foreach (int id, curMapPhysicalCpu.keys()) {
-        PhysicalCpu physical = PhysicalCpu(id);
-
-        PhysicalCpu &curPhysical = curMapPhysicalCpu[id];
-        QList<int> curCoreNums = curPhysical.coreNums();
-        for (int i = 0; i < curCoreNums.size(); ++i) {
-            CoreCpu curCoreCpu = curPhysical.coreCpu(curCoreNums[i]);
-            curCoreCpu.setCoreId(i);
-            physical.addCoreCpu(i, curCoreCpu);
-        }
-        m_MapPhysicalCpu.insert(id, physical);
-    }
-
-    return true;
+    return readProcCpuinfo();
 }
 
 const QString &CpuInfo::arch() const
@@ -107,98 +152,77 @@ void CpuInfo::readCpuArchitecture()
 
 bool CpuInfo::readProcCpuinfo()
 {
-    QFile file("/proc/cpuinfo");
+    QFile file(m_CpuinfoPath);
     if (!file.open(QIODevice::ReadOnly))
         return false;
-
-    QString cpuInfo = file.readAll();
-    QStringList infos = cpuInfo.split("\n\n");
-    foreach (const QString &info, infos) {
-        if (info.isEmpty())
-            continue;
-        parseInfo(info);
-    }
-
+    const QByteArray data = file.readAll();
     file.close();
-    return true;
-}
-
-bool CpuInfo::parseInfo(const QString &info)
-{
-    if (info.isEmpty())
-        return false;
-    // 解析段落信息，获取逻辑id号
-    QMap<QString, QString> mapInfo;
-    int logical_id = -1;
-    QStringList lines = info.split("\n");
-    foreach (const QString &line, lines) {
-        if (line.isEmpty())
-            continue;
-        QStringList words = line.split(QRegExp("[\\s]*:[\\s]*"));
-        if (words.size() != 2)
-            continue;
-        if ("core" == words[0]) {
-            mapInfo.insert("core id", words[1]);
-        } else if ("package" == words[0]) {
-            mapInfo.insert("physical id", words[1]);
-        } else {
-            mapInfo.insert(words[0].toLower(), words[1]);
-        }
-        if (words[0].contains("processor"))
-            logical_id = words[1].toInt();
-    }
 
-    if (logical_id < 0)
-        return false;
+    // 只保留需要的字段，其它行不创建字符串; core package 为部分架构上的名称
+    static const char *const keys[][2] = {
+        {"processor", "processor"}, {"physical id", "physical id"}, {"core id", "core id"},
+        {"package", "physical id"}, {"core", "core id"}, {"flags", "flags"},
+        {"model", "model"}, {"model name", "model name"}, {"vendor_id", "vendor_id"},
+        {"stepping", "stepping"}, {"cpu family", "cpu family"}, {"bogomips", "bogomips"},
+        {"cpu mhz", "cpu mhz"}, {"cpu model", "cpu model"}, {"features", "features"},
+    };
 
-    // 找到逻辑cpu
-    if (mapInfo.find("physical id") != mapInfo.end()
-            && mapInfo.find("core id") != mapInfo.end()) {
-        int physical_id = mapInfo["physical id"].toInt();
-        if (m_MapPhysicalCpu.find(physical_id) == m_MapPhysicalCpu.end())
-            return false;
-        PhysicalCpu &physical = m_MapPhysicalCpu[physical_id];
-        int core_id = mapInfo["core id"].toInt();
-        if (!physical.coreIsExisted(core_id)) {
-            if (physical.logicalIsExisted(logical_id)) {
-                LogicalCpu &logical = physical.logicalCpu(logical_id);
-                if (logical.logicalID() >= 0)
-                    setProcCpuinfo(logical, mapInfo);
-            }
+    QMap<QString, QString> mapInfo;
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol)
+            eol = end;
+
+        if (eol == p) {
+            // 空行为一个逻辑cpu的结束
+            if (!mapInfo.isEmpty())
+                parseInfo(mapInfo);
+            mapInfo.clear();
         } else {
-            CoreCpu &core = physical.coreCpu(core_id);
-            if (!core.logicalIsExisted(logical_id)) {
-                if (physical.logicalIsExisted(logical_id)) {
-                    LogicalCpu &logical = physical.logicalCpu(logical_id);
-                    if (logical.logicalID() >= 0)
-                        setProcCpuinfo(logical, mapInfo);
+            const char *colon = static_cast<const char *>(memchr(p, ':', static_cast<size_t>(eol - p)));
+            if (colon) {
+                const char *keyEnd = colon;
+                while (keyEnd > p && isspace(static_cast<unsigned char>(keyEnd[-1])))
+                    --keyEnd;
+                const char *value = colon + 1;
+                const char *valueEnd = eol;
+                while (value < valueEnd && isspace(static_cast<unsigned char>(*value)))
+                    ++value;
+                while (valueEnd > value && isspace(static_cast<unsigned char>(valueEnd[-1])))
+                    --valueEnd;
+
+                size_t keyLen = static_cast<size_t>(keyEnd - p);
+                for (const auto &key : keys) {
+                    if (strlen(key[0]) == keyLen && 0 == strncasecmp(p, key[0], keyLen)) {
+                        mapInfo.insert(key[1], QString::fromLatin1(value, static_cast<int>(valueEnd - value)));
+                        break;
+                    }
                 }
-            } else {
-                LogicalCpu &logical = core.logicalCpu(logical_id);
-                if (logical.logicalID() >= 0)
-                    setProcCpuinfo(logical, mapInfo);
             }
         }
-    } else {
-        LogicalCpu &logical = logicalCpu(logical_id);
-        if (logical.logicalID() >= 0)
-            setProcCpuinfo(logical, mapInfo);
+        p = eol + 1;
     }
+    if (!mapInfo.isEmpty())
+        parseInfo(mapInfo);
 
     return true;
 }
 
-LogicalCpu &CpuInfo::logicalCpu(int logical_id)
+bool CpuInfo::parseInfo(const QMap<QString, QString> &mapInfo)
 {
-    foreach (int physical_id, m_MapPhysicalCpu.keys()) {
-        if (physical_id < 0)
-            continue;
-        PhysicalCpu &physical = m_MapPhysicalCpu[physical_id];
-        if (physical.logicalIsExisted(logical_id)) {
-            return physical.logicalCpu(logical_id);
-        }
-    }
-    return m_MapPhysicalCpu[-1].logicalCpu(-1);
+    if (!mapInfo.contains("processor"))
+        return false;
+
+    // sysfs 中已建立拓扑，按逻辑id直接找到逻辑cpu
+    int logical_id = mapInfo.value("processor").toInt();
+    LogicalCpu *logical = m_HashLogicalCpu.value(logical_id, nullptr);
+    if (!logical)
+        return false;
+
+    setProcCpuinfo(*logical, mapInfo);
+    return true;
 }
 
 void CpuInfo::setProcCpuinfo(LogicalCpu &logical, const QMap<QString, QString> &mapInfo)
@@ -224,186 +248,177 @@ void CpuInfo::setProcCpuinfo(LogicalCpu &logical, const QMap<QString, QString> &
 void CpuInfo::readSysCpu()
 {
     // /sys/devices/system/cpu/cpu*
-    QDir dir("/sys/devices/system/cpu");
-    dir.setFilter(QDir::Dirs);
-    QRegExp reg("cpu([0-9]{1,4})");
-    foreach (const QFileInfo &info, dir.entryInfoList()) {
-        const QString &name = info.fileName();
-        if (! reg.exactMatch(name))
+    DIR *dir = opendir(m_SysCpuPath.toLocal8Bit().constData());
+    if (!dir)
+        return;
+
+    QVector<int> ids;
+    while (struct dirent *entry = readdir(dir)) {
+        const char *name = entry->d_name;
+        if (0 != strncmp(name, "cpu", 3))
+            continue;
+        size_t len = strlen(name + 3);
+        if (len < 1 || len > 4 || strspn(name + 3, "0123456789") != len)
             continue;
-        readSysCpuN(reg.cap(1).toInt(), info.filePath());
+        ids.append(atoi(name + 3));
     }
-}
+    // 按编号顺序读取，共享缓存在第一个cpu处读取
+    std::sort(ids.begin(), ids.end());
+
+    QVector<QPair<int, LogicalCpu> > logicals;
+    QMap<int, QMap<int, int> > mapCoreIndex;    // physical id -> thread_siblings_list -> core id
+    foreach (int id, ids) {
+        char name[16];
+        snprintf(name, sizeof(name), "cpu%d", id);
+        int fd = openat(dirfd(dir), name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
 
-void CpuInfo::readSysCpuN(int N, const QString &path)
-{
-    // 第一步先读取物理cpu
-    // /sys/devices/system/cpu/cpu0/topology/physical_package_id
-    QString physicalPath = path + "/topology/physical_package_id";
-    int physical_id = readPhysicalID(physicalPath);
-    if (physical_id < 0) {
-        return;
+        LogicalCpu lcpu;
+        lcpu.setLogicalID(id);
+        lcpu.setArch(m_Arch);
+        int tsl = -1;
+        if (readSysCpuN(fd, lcpu, tsl)) {
+            logicals.append(qMakePair(tsl, lcpu));
+            mapCoreIndex[lcpu.physicalID()].insert(tsl, 0);
+        }
+        close(fd);
     }
-    if (m_MapPhysicalCpu.find(physical_id) == m_MapPhysicalCpu.end()) {
-        PhysicalCpu physical = PhysicalCpu(physical_id);
-        m_MapPhysicalCpu.insert(physical_id, physical);
+    closedir(dir);
+    m_HashSharedCache.clear();
+
+    // 每个物理cpu内按 thread_siblings_list 的顺序从0编号
+    for (QMap<int, QMap<int, int> >::iterator it = mapCoreIndex.begin(); it != mapCoreIndex.end(); ++it) {
+        int index = 0;
+        for (QMap<int, int>::iterator core = it.value().begin(); core != it.value().end(); ++core)
+            core.value() = index++;
     }
 
-    // 第二步读取core id
-    // /sys/devices/system/cpu/cpu0/topology/core_id
-    QString corePath = path + "/topology/core_id";
-    QString thread_siblings_list_patch = path + "/topology/thread_siblings_list";
-    int tsl = readThreadSiblingsListPath(thread_siblings_list_patch);
-    if (tsl < 0) {
-        return;
-    }
-    PhysicalCpu &cpu = m_MapPhysicalCpu[physical_id];
-    if (!cpu.coreIsExisted(tsl)) {
-        CoreCpu core = CoreCpu(tsl);
-        cpu.addCoreCpu(tsl, core);
-    }
+    for (int i = 0; i < logicals.size(); ++i) {
+        LogicalCpu &lcpu = logicals[i].second;
+        int physical_id = lcpu.physicalID();
+        int core_id = mapCoreIndex[physical_id].value(logicals[i].first);
+        lcpu.setCoreID(core_id);
 
-    // 第三步读取逻辑cpu
-    LogicalCpu lcpu;
-    lcpu.setLogicalID(N);
-    lcpu.setCoreID(tsl);
-    lcpu.setPhysicalID(physical_id);
-    lcpu.setArch(m_Arch);
-    QDir dir(path);
-    // get cpu cache
-    if (dir.exists("cache"))
-        readCpuCache(dir.filePath("cache"), lcpu);
-    // get cpu freq
-    if (dir.exists("cpufreq"))
-        readCpuFreq(dir.filePath("cpufreq"), lcpu);
-    CoreCpu &corecpu = cpu.coreCpu(tsl);
-    corecpu.addLogicalCpu(N, lcpu);
-}
+        if (m_MapPhysicalCpu.find(physical_id) == m_MapPhysicalCpu.end())
+            m_MapPhysicalCpu.insert(physical_id, PhysicalCpu(physical_id));
+        PhysicalCpu &physical = m_MapPhysicalCpu[physical_id];
+        if (!physical.coreIsExisted(core_id))
+            physical.addCoreCpu(core_id, CoreCpu(core_id));
+        physical.coreCpu(core_id).addLogicalCpu(lcpu.logicalID(), lcpu);
+    }
 
-int CpuInfo::readPhysicalID(const QString &path)
-{
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly))
-        return -1;
-    QString info = file.readAll();
-    file.close();
-    if ("sw_64" == m_Arch && -1 == info.toInt()) {
-        return 0;
+    // 拓扑建立完成后不再插入，节点地址不变
+    for (int i = 0; i < logicals.size(); ++i) {
+        LogicalCpu &lcpu = logicals[i].second;
+        int id = lcpu.logicalID();
+        m_HashLogicalCpu.insert(id, &m_MapPhysicalCpu[lcpu.physicalID()].coreCpu(lcpu.coreID()).logicalCpu(id));
     }
-    return info.toInt();
 }
 
-int CpuInfo::readCoreID(const QString &path)
+bool CpuInfo::readSysCpuN(int cpuFd, LogicalCpu &lcpu, int &tsl)
 {
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return -1;
-    }
-    QString info = file.readAll();
+    char buf[256];
 
-    file.close();
-    return info.toInt();
-}
+    // 第一步先读取物理cpu
+    // /sys/devices/system/cpu/cpu0/topology/physical_package_id
+    if (readAttr(cpuFd, "topology/physical_package_id", buf, sizeof(buf)) < 0)
+        return false;
+    int physical_id = atoi(buf);
+    if ("sw_64" == m_Arch && -1 == physical_id)
+        physical_id = 0;
+    if (physical_id < 0)
+        return false;
 
-int CpuInfo::readThreadSiblingsListPath(const QString &path)
-{
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return -1;
-    }
-    QString info = file.readAll();
-    file.close();
+    // 第二步读取 thread_siblings_list 中的第一个cpu，作为核心的标识
+    // /sys/devices/system/cpu/cpu0/topology/thread_siblings_list
+    if (readAttr(cpuFd, "topology/thread_siblings_list", buf, sizeof(buf)) < 0)
+        return false;
+    tsl = atoi(buf);
 
-    QStringList words = info.split(QRegExp("\\D"));
+    lcpu.setPhysicalID(physical_id);
 
-    return words.isEmpty() ? 0 : words.first().toInt();
+    // get cpu cache
+    readCpuCache(cpuFd, lcpu);
+    // get cpu freq
+    readCpuFreq(cpuFd, lcpu);
+    return true;
 }
 
-void CpuInfo::readCpuCache(const QString &path, LogicalCpu &lcpu)
+void CpuInfo::readCpuCache(int cpuFd, LogicalCpu &lcpu)
 {
-    QDir dir(path);
-    dir.setFilter(QDir::Dirs);
-    foreach (const QFileInfo &fileInfo, dir.entryInfoList()) {
-        QString tpath = fileInfo.absoluteFilePath();
-        if (!tpath.contains(QRegExp("index[0-9]")))
+    int cpu = lcpu.logicalID();
+    const QMap<int, CpuCache> shared = m_HashSharedCache.take(cpu);
+
+    for (int i = 0; ; ++i) {
+        QMap<int, CpuCache>::const_iterator it = shared.constFind(i);
+        if (it != shared.constEnd()) {
+            setCpuCache(it.value(), lcpu);
             continue;
-        readCpuCacheIndex(tpath, lcpu);
+        }
+        if (m_CacheIndexNum >= 0 && i >= m_CacheIndexNum)
+            break;
+
+        // /sys/devices/system/cpu/cpu0/cache/index0
+        char name[32];
+        snprintf(name, sizeof(name), "cache/index%d", i);
+        int fd = openat(cpuFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            if (i > 0 && m_CacheIndexNum < 0)
+                m_CacheIndexNum = i;
+            break;
+        }
+
+        CpuCache cache;
+        char buf[256];
+        if (readAttr(fd, "level", buf, sizeof(buf)) > 0)
+            cache.level = atoi(buf);
+        if (readAttr(fd, "type", buf, sizeof(buf)) > 0)
+            cache.type = QString::fromLatin1(buf);
+        if (readAttr(fd, "size", buf, sizeof(buf)) > 0)
+            cache.size = QString::fromLatin1(buf);
+        int len = readAttr(fd, "shared_cpu_list", buf, sizeof(buf));
+        close(fd);
+
+        setCpuCache(cache, lcpu);
+        if (len <= 0)
+            continue;
+        foreach (int other, parseCpuList(buf)) {
+            if (other != cpu)
+                m_HashSharedCache[other].insert(i, cache);
+        }
     }
 }
 
-void CpuInfo::readCpuCacheIndex(const QString &path, LogicalCpu &lcpu)
+void CpuInfo::setCpuCache(const CpuCache &cache, LogicalCpu &lcpu)
 {
-    int level = -1;
-    QString type, value;
-
-    // get level
-    QString levelPath = path + "/level";
-    QFile file(levelPath);
-    if (file.open(QIODevice::ReadOnly)) {
-        QString info = file.readAll();
-        level = info.toInt();
-    }
-    file.close();
-
-    // get type
-    QString typePath = path + "/type";
-    QFile fileT(typePath);
-    if (fileT.open(QIODevice::ReadOnly)) {
-        type = fileT.readAll();
-    }
-    fileT.close();
-
-    // get size
-    QString valuePath = path + "/size";
-    QFile fileV(valuePath);
-    if (fileV.open(QIODevice::ReadOnly)) {
-        value = fileV.readAll();
-    }
-    fileV.close();
-
-    if (level == 2) {
-        lcpu.setL2Cache(value);
-    } else if (level == 3) {
-        lcpu.setL3Cache(value);
-    } else if (level == 1) {
-        if (type.contains("Data", Qt::CaseInsensitive))
-            lcpu.setL1dCache(value);
+    if (cache.level == 2) {
+        lcpu.setL2Cache(cache.size);
+    } else if (cache.level == 3) {
+        lcpu.setL3Cache(cache.size);
+    } else if (cache.level == 1) {
+        if (cache.type.contains("Data", Qt::CaseInsensitive))
+            lcpu.setL1dCache(cache.size);
         else
-            lcpu.setL1iCache(value);
+            lcpu.setL1iCache(cache.size);
     }
 }
 
-void CpuInfo::readCpuFreq(const QString &path, LogicalCpu &lcpu)
+void CpuInfo::readCpuFreq(int cpuFd, LogicalCpu &lcpu)
 {
+    char buf[64];
+
     // min freq
-    QString minFreqPath = path + "/cpuinfo_min_freq";
-    QFile minFile(minFreqPath);
-    if (minFile.open(QIODevice::ReadOnly)) {
-        QString info = minFile.readAll();
-        int value = info.toInt() / 1000;
-        lcpu.setMinFreq(QString::number(value) + "MHz");
-    }
-    minFile.close();
+    if (readAttr(cpuFd, "cpufreq/cpuinfo_min_freq", buf, sizeof(buf)) >= 0)
+        lcpu.setMinFreq(QString::number(atoi(buf) / 1000) + "MHz");
 
     // cur freq
-    QString curFreqPath = path + "/scaling_cur_freq";
-    QFile curFile(curFreqPath);
-    if (curFile.open(QIODevice::ReadOnly)) {
-        QString info = curFile.readAll();
-        int value = info.toInt() / 1000;
-        lcpu.setCurFreq(QString::number(value) + "MHz");
-    }
-    curFile.close();
+    if (readAttr(cpuFd, "cpufreq/scaling_cur_freq", buf, sizeof(buf)) >= 0)
+        lcpu.setCurFreq(QString::number(atoi(buf) / 1000) + "MHz");
 
     // maxFreq
-    QString maxFreqPath = path + "/cpuinfo_max_freq";
-    QFile maxFile(maxFreqPath);
-    if (maxFile.open(QIODevice::ReadOnly)) {
-        QString info = maxFile.readAll();
-        int value = info.toInt() / 1000;
-        lcpu.setMaxFreq(QString::number(value) + "MHz");
-    }
-    maxFile.close();
+    if (readAttr(cpuFd, "cpufreq/cpuinfo_max_freq", buf, sizeof(buf)) >= 0)
+        lcpu.setMaxFreq(QString::number(atoi(buf) / 1000) + "MHz");
 }
 
 void CpuInfo::diagPrintInfo()
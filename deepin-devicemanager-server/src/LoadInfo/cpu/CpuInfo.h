@@ -7,7 +7,7 @@
 #define CPUINFO_H
 
 #include<QMap>
-#include<QDir>
+#include<QHash>
 
 #include "PhysicalCpu.h"
 #include "CoreCpu.h"
@@ -16,7 +16,7 @@
 class CpuInfo
 {
 public:
-    CpuInfo();
+    explicit CpuInfo(const QString &sysCpuPath = "/sys/devices/system/cpu", const QString &cpuinfoPath = "/proc/cpuinfo");
     ~CpuInfo();
 
     /**
@@ -60,32 +60,32 @@ public:
     int logicalNum();
 
 private:
+    /**
+     * @brief The CpuCache struct : /sys/devices/system/cpu/cpu0/cache/index*
+     */
+    struct CpuCache {
+        int     level = -1;
+        QString type;
+        QString size;
+    };
+
     /**
      * @brief readCpuArchitecture
      */
     void readCpuArchitecture();
 
     /**
-     * @brief readProcCpuinfo
+     * @brief readProcCpuinfo : 逐行扫描，只为需要的字段创建字符串
      * @return
      */
     bool readProcCpuinfo();
 
     /**
      * @brief parseInfo
-     * @param info
+     * @param mapInfo : 一个逻辑cpu的信息，key 为小写
      * @return
      */
-    bool parseInfo(const QString &info);
-
-    /**
-     * @brief logicalCpu
-     * @param logical_id
-     * @param core_id
-     * @param physical_id
-     * @return
-     */
-    LogicalCpu &logicalCpu(int logical_id);
+    bool parseInfo(const QMap<QString, QString> &mapInfo);
 
     /**
      * @brief setProcCpuinfo
@@ -96,61 +96,50 @@ private:
 
     /**
      * @brief readSysCpu : /sys/devices/system/cpu
+     * 先读取所有逻辑cpu，再按 thread_siblings_list 的顺序给核心编号，直接建立拓扑，不再复制后重新编号
      */
     void readSysCpu();
 
     /**
      * @brief readSysCpuN : /sys/devices/system/cpu/cpu* (cpu0 cpu1 cpu2 cpu3 cpu4)
-     * @param path : /sys/devices/system/cpu
-     */
-    void readSysCpuN(int N, const QString &path);
-
-    /**
-     * @brief readPhysicalID
-     * @param path
-     * @return
-     */
-    int readPhysicalID(const QString &path);
-
-    /**
-     * @brief readCoreID
-     * @param path
+     * @param cpuFd : 打开的 cpuN 目录，属性文件相对该目录读取
+     * @param lcpu
+     * @param tsl : thread_siblings_list 中的第一个cpu
      * @return
      */
-    int readCoreID(const QString &path);
-
-    /**
-        * @brief readThreadSiblingsListPath
-        * @param path
-        * @return
-        */
-    int readThreadSiblingsListPath(const QString &path);
+    bool readSysCpuN(int cpuFd, LogicalCpu &lcpu, int &tsl);
 
     /**
      * @brief readCpuCache : /sys/devices/system/cpu/cpu0/cache
-     * @param path : /sys/devices/system/cpu/cpu0
+     * 共享的缓存只读取一次，结果按 shared_cpu_list 记录给共享该缓存的其它cpu
+     * @param cpuFd : 打开的 cpuN 目录
      * @param lcpu
      */
-    void readCpuCache(const QString &path, LogicalCpu &lcpu);
+    void readCpuCache(int cpuFd, LogicalCpu &lcpu);
 
     /**
-     * @brief readCpuCacheIndex : /sys/devices/system/cpu/cpu0/cache/index* (index0 index1 index2 index3)
-     * @param path : /sys/devices/system/cpu/cpu0/cache/index0
+     * @brief setCpuCache
+     * @param cache
      * @param lcpu
      */
-    void readCpuCacheIndex(const QString &path, LogicalCpu &lcpu);
+    void setCpuCache(const CpuCache &cache, LogicalCpu &lcpu);
 
     /**
      * @brief readCpuFreq
-     * @param path
+     * @param cpuFd : 打开的 cpuN 目录
      * @param lcpu
      */
-    void readCpuFreq(const QString &path, LogicalCpu &lcpu);
+    void readCpuFreq(int cpuFd, LogicalCpu &lcpu);
 
 
 private:
-    QMap<int, PhysicalCpu>     m_MapPhysicalCpu;
-    QString                    m_Arch;
+    QMap<int, PhysicalCpu>              m_MapPhysicalCpu;
+    QString                             m_Arch;
+    QString                             m_SysCpuPath;       //<! /sys/devices/system/cpu
+    QString                             m_CpuinfoPath;      //<! /proc/cpuinfo
+    QHash<int, LogicalCpu *>            m_HashLogicalCpu;   //<! logical id -> m_MapPhysicalCpu 中的逻辑cpu
+    QHash<int, QMap<int, CpuCache> >    m_HashSharedCache;  //<! logical id -> index -> 其它cpu已读取的共享缓存
+    int                                 m_CacheIndexNum;    //<! 第一个cpu的 cache/index* 数量
 };
 
 #endif // CPUINFO_H
@@ -11,6 +11,12 @@
 #include "DBusEnableInterface.h"
 #include "DBusWakeupInterface.h"
 #include "DeviceInfoManager.h"
+#include "DeviceRecordStore.h"
+#include "DmiDecoder.h"
+#include "DeviceSnapshot.h"
+#include "CollectorMetrics.h"
+#include "CollectorBundle.h"
+#include "ProcessLauncher.h"
 #include "EnableSqlManager.h"
 #include "EnableUtils.h"
 #include "WakeupUtils.h"
@@ -49,8 +55,15 @@ MainJob::MainJob(QObject *parent)
     , mp_IFace(new DBusInterface(this))
     , m_FirstUpdate(true)
 {
-    // 守护进程启动的时候加载所有信息
-    updateAllDevice();
+    // 每轮信息获取完成后保存快照
+    connect(mp_Pool, &ThreadPool::finished, this, &MainJob::slotSaveSnapshot, Qt::QueuedConnection);
+    // 由线程池的 finished 信号驱动下一轮调度，主线程不阻塞等待
+    connect(mp_Pool, &ThreadPool::finished, this, &MainJob::slotPoolFinished, Qt::QueuedConnection);
+
+    // 守护进程启动的时候加载所有信息，硬件未变化时直接使用快照，后台重新获取
+    // 回放时快照中是本机的信息，不使用
+    if (CollectorBundle::getInstance()->isReplaying() || !loadSnapshot())
+        updateAllDevice();
     //启动时，检测驱动是否要更新，如果要更新则通知系统
 // 取消开机驱动安装提示
 //    DriverManager *drivermanager = new DriverManager(this);
@@ -74,17 +87,12 @@ void MainJob::working()
     // 启动线程监听USB是否有新的设备
     mp_DetectThread = new DetectThread(this);
     mp_DetectThread->start();
-    connect(mp_DetectThread, &DetectThread::usbChanged, this, &MainJob::slotUsbChanged, Qt::ConnectionType::QueuedConnection);
+    connect(mp_DetectThread, &DetectThread::usbChanged, this, &MainJob::slotHotplugChanged, Qt::ConnectionType::QueuedConnection);
 
     // 在驱动管理延迟加载1000ms
     QTimer::singleShot(1000, this, [ = ]() {
         //初始化源
         initDriverRepoSource();
-        // 后台加载后先禁用设备
-        const QString &info = DeviceInfoManager::getInstance()->getInfo("hwinfo");
-        EnableUtils::disableOutDevice(info);
-        EnableUtils::disableInDevice();
-        WakeupUtils::updateWakeupDeviceInfo(info);
 
         mp_DriverOperateIFace = (new DriverDBusInterface(this));
         mp_Enable = (new DBusEnableInterface(this));
@@ -106,10 +114,13 @@ void MainJob::working()
 INSTRUCTION_RES MainJob::executeClientInstruction(const QString &instructions)
 {
     QMutexLocker locker(&mutex);
-    s_ServerIsUpdating = true;
     INSTRUCTION_RES res = IR_NULL;
 
-    if (instructions.startsWith("DETECT")) {
+    if (instructions.startsWith("DETECT:")) {
+        // 热插拔只更新相关类别的缓存信息, DETECT:usb,storage
+        // MonitorUsb 已经等待内核处理完毕，不需要再延时
+        updateDevice(instructions.mid(QString("DETECT:").size()).split(",", QString::SkipEmptyParts));
+    } else if (instructions.startsWith("DETECT")) {
         this->thread()->msleep(1000);
         // 跟新缓存信息
         updateAllDevice();
@@ -122,17 +133,21 @@ INSTRUCTION_RES MainJob::executeClientInstruction(const QString &instructions)
         res = IR_NULL;
     }
 
-    s_ServerIsUpdating = false;
     return res;
 }
 
 bool MainJob::isZhaoXin()
 {
-    QString cmd = "sudo dmidecode -t 4";
-    QProcess process;
-    process.start(cmd);
-    process.waitForFinished(-1);
-    QString info = process.readAllStandardOutput();
+    // 优先使用缓存中已解析的处理器信息，避免再次解析SMBIOS表
+    QString info = DeviceInfoManager::getInstance()->getInfo("dmidecode_4");
+    if (info.isEmpty()) {
+        DmiDecoder dmi;
+        if (dmi.load()) {
+            info = dmi.typeInfo(4);
+        } else {
+            ProcessLauncher::run("dmidecode", QStringList() << "-t" << "4", DEFAULT_CMD_TIMEOUT, info);
+        }
+    }
     if (info.contains("ZHAOXIN KaiXian KX-U")) {
         return true;
     } else {
@@ -155,6 +170,11 @@ void MainJob::slotUsbChanged()
     executeClientInstruction("DETECT");
 }
 
+void MainJob::slotHotplugChanged(const QStringList &categories)
+{
+    executeClientInstruction("DETECT:" + categories.join(","));
+}
+
 void MainJob::slotDriverControl(bool success)
 {
     if (success)
@@ -168,18 +188,127 @@ void MainJob::onFirstUpdate()
     }
 }
 
+void MainJob::slotSaveSnapshot()
+{
+    // 回放的结果不能作为本机的快照
+    CollectorBundle *bundle = CollectorBundle::getInstance();
+    if (bundle->isReplaying())
+        return;
+
+    if (bundle->isCapturing() && !bundle->capture(DeviceInfoManager::getInstance()->allInfo()))
+        qWarning() << "Failed to capture collector outputs";
+
+    DeviceSnapshot snapshot;
+    if (!snapshot.save(DeviceInfoManager::getInstance()->allInfo()))
+        qWarning() << "Failed to save device info snapshot";
+
+    // 每轮采集结束后更新采集统计，供 node_exporter 的 textfile 收集
+    if (!CollectorMetrics::getInstance()->save())
+        qWarning() << "Failed to save collector metrics";
+}
+
+void MainJob::slotPoolFinished()
+{
+    m_PoolRunning = false;
+    if (!m_PerfPoint.isEmpty()) {
+        PERF_PRINT_END(m_PerfPoint);
+        m_PerfPoint.clear();
+    }
+
+    // 第一轮获取完成后 hwinfo 的信息才完整
+    if (!m_DeviceStateApplied)
+        applyDeviceState();
+
+    // 调度期间收到的请求合并为一轮，全部刷新包含热插拔类别的刷新
+    if (m_PendingAll) {
+        m_PendingAll = false;
+        m_PendingCategories.clear();
+        updateAllDevice();
+    } else if (!m_PendingCategories.isEmpty()) {
+        QStringList categories = m_PendingCategories;
+        m_PendingCategories.clear();
+        updateDevice(categories);
+    } else {
+        s_ServerIsUpdating = false;
+    }
+}
+
+void MainJob::applyDeviceState()
+{
+    // 加载后先禁用设备
+    const QList<DeviceRecord> records = DeviceRecordStore::getInstance()->records("hwinfo");
+    EnableUtils::disableOutDevice(records);
+    EnableUtils::disableInDevice();
+    WakeupUtils::updateWakeupDeviceInfo(records);
+    m_DeviceStateApplied = true;
+}
+
+bool MainJob::loadSnapshot()
+{
+    PERF_PRINT_BEGIN("POINT-00", "MainJob::loadSnapshot()");
+    DeviceSnapshot snapshot;
+    bool loaded = snapshot.load();
+    PERF_PRINT_END("POINT-00");
+    if (!loaded)
+        return false;
+
+    DeviceInfoManager::getInstance()->setAllInfo(snapshot.info());
+    m_FirstUpdate = false;
+    // 快照中已有 hwinfo 的信息，不必等待后台校验完成
+    applyDeviceState();
+
+    // 同一次开机只刷新会变化的信息，否则全部重新获取，均不阻塞启动
+    m_PoolRunning = true;
+    if (snapshot.sameBoot())
+        mp_Pool->updateDeviceInfo();
+    else
+        mp_Pool->loadDeviceInfo(true);
+    return true;
+}
+
 void MainJob::updateAllDevice()
 {
-    PERF_PRINT_BEGIN("POINT-01", "MainJob::updateAllDevice()");
+    s_ServerIsUpdating = true;
+    // 上一轮（如快照的后台校验）未完成时，完成后再调度，避免两轮调度同时进行
+    if (m_PoolRunning) {
+        m_PendingAll = true;
+        return;
+    }
+
+    m_PerfPoint = "POINT-01";
+    PERF_PRINT_BEGIN(m_PerfPoint, "MainJob::updateAllDevice()");
+    m_PoolRunning = true;
+    // 每个命令都有超时时间，超时后结束进程组，本轮总会发出 finished 信号
     if (m_FirstUpdate)
         mp_Pool->loadDeviceInfo();
     else
         mp_Pool->updateDeviceInfo();
-    mp_Pool->waitForDone(-1);
-    PERF_PRINT_END("POINT-01");
     m_FirstUpdate = false;
 }
 
+void MainJob::updateDevice(const QStringList &categories)
+{
+    // 首次加载未完成或无法确定类别时全部刷新
+    if (m_FirstUpdate || categories.isEmpty()) {
+        updateAllDevice();
+        return;
+    }
+
+    s_ServerIsUpdating = true;
+    if (m_PoolRunning) {
+        foreach (const QString &category, categories) {
+            if (!m_PendingCategories.contains(category))
+                m_PendingCategories << category;
+        }
+        return;
+    }
+
+    m_PerfPoint = "POINT-02";
+    PERF_PRINT_BEGIN(m_PerfPoint, "MainJob::updateDevice()");
+    m_PoolRunning = true;
+    mp_Pool->updateDeviceInfo(ThreadPool::keysOfCategories(categories));
+}
+
 bool MainJob::initDBus()
 {
     QDBusConnection systemBus = QDBusConnection::systemBus();
@@ -8,6 +8,7 @@
 #include <QObject>
 #include <QMutex>
 #include <QTimer>
+#include <QStringList>
 
 class ThreadPool;
 class DetectThread;
@@ -63,6 +64,12 @@ private slots:
      */
     void slotUsbChanged();
 
+    /**
+     * @brief slotHotplugChanged : 热插拔时只刷新相关类别的设备信息
+     * @param categories
+     */
+    void slotHotplugChanged(const QStringList &categories);
+
     /**
      * @brief slotUsbChanged
      * @param usbchanged
@@ -74,13 +81,41 @@ private slots:
      */
     void onFirstUpdate();
 
+    /**
+     * @brief slotSaveSnapshot : save all device info to disk
+     */
+    void slotSaveSnapshot();
+
+    /**
+     * @brief slotPoolFinished : 一轮调度完成后开始调度期间收到的刷新请求
+     */
+    void slotPoolFinished();
+
 private:
 
     /**
-     * @brief updateAllDevice
+     * @brief updateAllDevice : 按依赖关系调度所有命令，不阻塞调用线程
+     * 线程池正在调度时合并到下一轮，在 slotPoolFinished 中开始
      */
     void updateAllDevice();
 
+    /**
+     * @brief updateDevice : 刷新热插拔设备类别相关的信息
+     * @param categories
+     */
+    void updateDevice(const QStringList &categories);
+
+    /**
+     * @brief applyDeviceState : 根据已获取的 hwinfo 信息禁用设备并更新唤醒设置
+     */
+    void applyDeviceState();
+
+    /**
+     * @brief loadSnapshot : load the snapshot and revalidate it in the background
+     * @return false if there is no valid snapshot
+     */
+    bool loadSnapshot();
+
     /**
      * @brief initDBus : 初始化dbus
      * @return : 返回bool
@@ -110,6 +145,11 @@ private:
     static bool           s_ClientIsUpdating;                 //<! 前台正在更新中
     static bool           s_ServerIsUpdating;                 //<! 后台正在更新中
     bool                  m_FirstUpdate;                      //<! 是否是第一次更新
+    bool                  m_PoolRunning = false;              //<! 线程池正在调度一轮命令
+    bool                  m_PendingAll = false;               //<! 调度期间收到全部刷新的请求
+    QStringList           m_PendingCategories;                //<! 调度期间收到的热插拔设备类别
+    QString               m_PerfPoint;                        //<! 当前一轮调度的性能统计点
+    bool                  m_DeviceStateApplied = false;       //<! 已根据设备信息禁用设备和设置唤醒
 
 };
 
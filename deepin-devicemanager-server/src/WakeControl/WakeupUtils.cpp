@@ -17,12 +17,11 @@ WakeupUtils::WakeupUtils()
 
 }
 
-void WakeupUtils::updateWakeupDeviceInfo(const QString& info)
+void WakeupUtils::updateWakeupDeviceInfo(const QList<DeviceRecord>& records)
 {
-    QStringList items = info.split("\n\n");
-    foreach(const QString& item,items){
+    foreach(const DeviceRecord& record,records){
         QMap<QString,QString> mapItem;
-        if(!getMapInfo(item,mapItem))
+        if(!getMapInfo(record,mapItem))
             continue;
 
         // Unique ID
@@ -126,19 +125,16 @@ bool WakeupUtils::setWakeOnLan(const QString& logicalName, bool open)
     return false;
 }
 
-bool WakeupUtils::getMapInfo(const QString& item,QMap<QString,QString>& mapInfo)
+bool WakeupUtils::getMapInfo(const DeviceRecord& record,QMap<QString,QString>& mapInfo)
 {
-    QStringList lines = item.split("\n");
     // 行数太少则为无用信息
-    if(lines.size() <= LEAST_NUM){
+    if(record.fields.size() <= LEAST_NUM){
         return false;
     }
 
-    foreach(const QString& line,lines){
-        QStringList words = line.split(": ");
-        if(words.size() != 2)
-            continue;
-        mapInfo.insert(words[0].trimmed(),words[1].replace("\"","").trimmed());
+    for(const QPair<QString,QString>& field : record.fields){
+        QString value = field.second;
+        mapInfo.insert(field.first,value.replace("\"","").trimmed());
     }
 
     if(mapInfo["Hardware Class"] != "keyboard" && mapInfo["Hardware Class"] != "mouse")
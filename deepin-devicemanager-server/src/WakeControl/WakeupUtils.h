@@ -6,6 +6,7 @@
 #define WAKEUPUTILS_H
 
 #include "ethtool-copy.h"
+#include "DeviceRecordStore.h"
 
 #include <QString>
 
@@ -34,9 +35,9 @@ public:
 
     /**
      * @brief updateWakeupDeviceInfo
-     * @param info
+     * @param records hwinfo 解析后的记录
      */
-    static void updateWakeupDeviceInfo(const QString& info);
+    static void updateWakeupDeviceInfo(const QList<DeviceRecord>& records);
 
     /**
      * @brief wakeupPath : get wakeup path by sys path
@@ -71,12 +72,12 @@ public:
 
 private:
     /**
-     * @brief getMapInfo 解析usb信息
-     * @param item
+     * @brief getMapInfo 获取usb信息
+     * @param record
      * @param mapInfo
      * @return
      */
-    static bool getMapInfo(const QString& item,QMap<QString,QString>& mapInfo);
+    static bool getMapInfo(const DeviceRecord& record,QMap<QString,QString>& mapInfo);
 
     /**
      * @brief getPS2Syspath 获取ps2鼠标键盘的syspath
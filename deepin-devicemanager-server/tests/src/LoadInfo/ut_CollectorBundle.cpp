@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "CollectorBundle.h"
+
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <unistd.h>
+
+class CollectorBundle_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+
+    void writeFile(const QString &path, const QByteArray &data)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly))
+            file.write(data);
+    }
+
+    QTemporaryDir m_Dir;
+};
+
+TEST_F(CollectorBundle_UT, CollectorBundle_UT_captureReplay)
+{
+    QMap<QString, QString> infos;
+    infos.insert("hwinfo_usb", "usb info");
+    infos.insert("dmidecode_0", "bios info");
+    infos.insert("is_server_running", "1");
+
+    CollectorBundle capture(CollectorBundle::Capture, m_Dir.path());
+    // 测试中不录制本机的 sysfs
+    capture.m_FilesCaptured = true;
+    EXPECT_EQ(QString("/proc/cpuinfo"), capture.sysPath("/proc/cpuinfo"));
+    EXPECT_TRUE(capture.capture(infos));
+    EXPECT_TRUE(QFile::exists(m_Dir.path() + "/info/hwinfo_usb.txt"));
+    EXPECT_FALSE(QFile::exists(m_Dir.path() + "/info/is_server_running.txt"));
+
+    CollectorBundle replay(CollectorBundle::Replay, m_Dir.path());
+    EXPECT_FALSE(replay.capture(infos));
+    EXPECT_EQ(m_Dir.path() + "/fs/proc/cpuinfo", replay.sysPath("/proc/cpuinfo"));
+
+    QString info;
+    EXPECT_TRUE(replay.replayInfo("dmidecode_0", info));
+    EXPECT_EQ(QString("bios info"), info);
+    EXPECT_FALSE(replay.replayInfo("lsblk_d", info));
+    EXPECT_TRUE(info.isEmpty());
+}
+
+TEST_F(CollectorBundle_UT, CollectorBundle_UT_copyTree)
+{
+    QString src = m_Dir.path() + "/src/0000:00:00.0";
+    writeFile(src + "/vendor", "0x8086\n");
+    writeFile(src + "/config", "binary");
+    writeFile(src + "/power/control", "auto\n");
+    writeFile(src + "/msi_irqs/deep/value", "1\n");
+    symlink("../../../bus/pci/drivers/pcieport", (src + "/driver").toLocal8Bit().constData());
+
+    QString dst = m_Dir.path() + "/dst/0000:00:00.0";
+    CollectorBundle::copyTree(src, dst, 1);
+
+    QFile vendor(dst + "/vendor");
+    ASSERT_TRUE(vendor.open(QIODevice::ReadOnly));
+    EXPECT_EQ(QByteArray("0x8086\n"), vendor.readAll());
+    EXPECT_FALSE(QFile::exists(dst + "/config"));
+    EXPECT_TRUE(QFile::exists(dst + "/power/control"));
+    EXPECT_FALSE(QFile::exists(dst + "/msi_irqs/deep/value"));
+
+    // 链接原样保留，PciEnumerator 通过链接名获取驱动
+    QFileInfo driver(dst + "/driver");
+    EXPECT_TRUE(driver.isSymLink());
+    EXPECT_EQ(QString("pcieport"), QFileInfo(driver.symLinkTarget()).fileName());
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "CollectorMetrics.h"
+#include "ProcessLauncher.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <signal.h>
+
+class CollectorMetrics_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+
+    QTemporaryDir m_Dir;
+};
+
+TEST_F(CollectorMetrics_UT, CollectorMetrics_UT_record)
+{
+    CollectorMetrics metrics(m_Dir.path() + "/collector.prom");
+
+    ProcessStat ok;
+    ok.started = true;
+    ok.exitCode = 0;
+    ok.wallMsec = 40;
+    ok.cpuUsec = 1500000;
+    ok.bytes = 100;
+    ok.maxRssKb = 2048;
+    metrics.record("hwinfo", ok);
+
+    ProcessStat timeout;
+    timeout.started = true;
+    timeout.timedOut = true;
+    timeout.termSignal = SIGKILL;
+    timeout.wallMsec = 3000;
+    timeout.maxRssKb = 1024;
+    metrics.record("hwinfo", timeout);
+
+    QMap<QString, CollectorStat> stats = metrics.stats();
+    ASSERT_TRUE(stats.contains("hwinfo"));
+    const CollectorStat &s = stats["hwinfo"];
+    EXPECT_EQ(2u, s.runs);
+    EXPECT_EQ(1u, s.failures);
+    EXPECT_EQ(1u, s.timeouts);
+    EXPECT_EQ(1u, s.kills);
+    EXPECT_EQ(3040, s.wallMsec);
+    EXPECT_EQ(2048, s.maxRssKb);
+    EXPECT_EQ(-1, s.lastExitCode);
+
+    QString text = metrics.toPrometheus();
+    EXPECT_TRUE(text.contains("devicemanager_collector_runs_total{collector=\"hwinfo\"} 2\n"));
+    EXPECT_TRUE(text.contains("devicemanager_collector_cpu_seconds_total{collector=\"hwinfo\"} 1.5\n"));
+    EXPECT_TRUE(text.contains("devicemanager_collector_max_rss_bytes{collector=\"hwinfo\"} 2097152\n"));
+    // 直方图的桶是累加的
+    EXPECT_TRUE(text.contains("devicemanager_collector_duration_seconds_bucket{collector=\"hwinfo\",le=\"0.05\"} 1\n"));
+    EXPECT_TRUE(text.contains("devicemanager_collector_duration_seconds_bucket{collector=\"hwinfo\",le=\"2.5\"} 1\n"));
+    EXPECT_TRUE(text.contains("devicemanager_collector_duration_seconds_bucket{collector=\"hwinfo\",le=\"5\"} 2\n"));
+    EXPECT_TRUE(text.contains("devicemanager_collector_duration_seconds_bucket{collector=\"hwinfo\",le=\"+Inf\"} 2\n"));
+    EXPECT_TRUE(text.contains("devicemanager_collector_duration_seconds_count{collector=\"hwinfo\"} 2\n"));
+
+    EXPECT_TRUE(metrics.save());
+    QFile file(m_Dir.path() + "/collector.prom");
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(text, QString::fromUtf8(file.readAll()));
+}
+
+TEST_F(CollectorMetrics_UT, CollectorMetrics_UT_processStat)
+{
+    QString info;
+    ProcessStat stat;
+    EXPECT_TRUE(ProcessLauncher::run("sh", QStringList() << "-c" << "echo hello; exit 3", 5000, info, &stat));
+    EXPECT_TRUE(stat.started);
+    EXPECT_FALSE(stat.timedOut);
+    EXPECT_EQ(3, stat.exitCode);
+    EXPECT_EQ(6, stat.bytes);
+
+    EXPECT_FALSE(ProcessLauncher::run("sleep", QStringList() << "5", 100, info, &stat));
+    EXPECT_TRUE(stat.timedOut);
+    EXPECT_EQ(SIGKILL, stat.termSignal);
+}
+
+TEST_F(CollectorMetrics_UT, CollectorMetrics_UT_path)
+{
+    // 未设置时使用默认路径，设置后写到指定的文件
+    qunsetenv(COLLECTOR_METRICS_ENV);
+    EXPECT_EQ(QString(COLLECTOR_METRICS_PATH), CollectorMetrics().m_Path);
+
+    QString path = m_Dir.path() + "/textfile/devicemanager.prom";
+    qputenv(COLLECTOR_METRICS_ENV, path.toLocal8Bit());
+    CollectorMetrics metrics;
+    EXPECT_EQ(path, metrics.m_Path);
+    EXPECT_TRUE(metrics.save());
+    EXPECT_TRUE(QFile::exists(path));
+    qunsetenv(COLLECTOR_METRICS_ENV);
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "CollectorQuarantine.h"
+#include "DeviceSnapshot.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+class CollectorQuarantine_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_Path = m_Dir.path() + "/cache/collector.quarantine";
+    }
+    void TearDown()
+    {
+    }
+
+    QTemporaryDir m_Dir;
+    QString m_Path;
+};
+
+TEST_F(CollectorQuarantine_UT, CollectorQuarantine_UT_persist)
+{
+    CollectorQuarantine writer(m_Path);
+    EXPECT_FALSE(writer.isQuarantined("hwinfo"));
+    writer.add("hwinfo");
+    writer.add("smartctl:sdb");
+    EXPECT_TRUE(writer.isQuarantined("hwinfo"));
+
+    // 守护进程重启后仍然有效
+    CollectorQuarantine reader(m_Path);
+    EXPECT_EQ(QStringList() << "hwinfo" << "smartctl:sdb", reader.entries());
+
+    // 硬件指纹变化后失效
+    QFile file(m_Path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("0000\nhwinfo\n");
+    file.close();
+    CollectorQuarantine changed(m_Path);
+    EXPECT_FALSE(changed.isQuarantined("hwinfo"));
+    EXPECT_FALSE(QFile::exists(m_Path));
+}
+
+TEST_F(CollectorQuarantine_UT, CollectorQuarantine_UT_retry)
+{
+    QByteArray fingerprint = DeviceSnapshot::hardwareFingerprint().toHex();
+    QByteArray usb = DeviceSnapshot::usbTopology().toHex();
+    QDir().mkpath(QFileInfo(m_Path).absolutePath());
+    QFile file(m_Path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(fingerprint + "\n");
+    file.write("hwinfo\t" + DeviceSnapshot::bootId() + "\t" + usb + "\n");
+    file.write("dmidecode\tut-other-boot\t" + usb + "\n");
+    file.write("lspci\t" + DeviceSnapshot::bootId() + "\t0000\n");
+    file.close();
+
+    // 其他开机或USB设备变化前超时的命令重新尝试一次
+    CollectorQuarantine quarantine(m_Path);
+    EXPECT_TRUE(quarantine.isQuarantined("hwinfo"));
+    EXPECT_FALSE(quarantine.isQuarantined("dmidecode"));
+    EXPECT_FALSE(quarantine.isQuarantined("lspci"));
+
+    // 再次超时后本次开机不再执行
+    quarantine.add("dmidecode");
+    EXPECT_TRUE(quarantine.isQuarantined("dmidecode"));
+
+    // 成功后移除
+    quarantine.release("dmidecode");
+    EXPECT_FALSE(quarantine.isQuarantined("dmidecode"));
+    CollectorQuarantine reader(m_Path);
+    EXPECT_EQ(QStringList() << "hwinfo" << "lspci", reader.entries());
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "CpuFreqSampler.h"
+
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+
+class CpuFreqSampler_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        for (int i = 0; i < 2; ++i)
+            QDir().mkpath(QString("%1/cpu%2/cpufreq").arg(m_Dir.path()).arg(i));
+        // 没有 cpufreq 的cpu不采样
+        QDir().mkpath(m_Dir.path() + "/cpu2");
+        QDir().mkpath(m_Dir.path() + "/cpufreq");
+    }
+    void TearDown()
+    {
+    }
+
+    void setFreq(int cpu, int khz)
+    {
+        QFile file(QString("%1/cpu%2/cpufreq/scaling_cur_freq").arg(m_Dir.path()).arg(cpu));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            file.write(QByteArray::number(khz) + "\n");
+    }
+
+    QTemporaryDir m_Dir;
+};
+
+TEST_F(CpuFreqSampler_UT, CpuFreqSampler_UT_ring)
+{
+    CpuFreqSampler sampler(m_Dir.path(), 4);
+    // 不启动采样线程，直接采样
+    sampler.m_Running = true;
+    EXPECT_TRUE(sampler.samples(0).isEmpty());
+
+    for (int i = 1; i <= 3; ++i) {
+        setFreq(0, 1000000 * i);
+        setFreq(1, 2000000 * i);
+        sampler.sampleOnce();
+    }
+    EXPECT_EQ(QVector<int>() << 0 << 1, sampler.m_Cpus);
+
+    QList<CpuFreqSample> all = sampler.samples(sampler.m_FirstSeq);
+    ASSERT_EQ(6, all.size());
+    EXPECT_EQ(0, all[0].cpu);
+    EXPECT_EQ(1000000u, all[0].khz);
+
+    // since 为 0 时只返回最新的一次
+    QList<CpuFreqSample> latest = sampler.samples(0);
+    ASSERT_EQ(2, latest.size());
+    EXPECT_EQ(3000000u, latest[0].khz);
+    EXPECT_EQ(6000000u, latest[1].khz);
+
+    // 只返回 since 之后的采样
+    quint64 since = latest[0].seq;
+    EXPECT_TRUE(sampler.samples(since).isEmpty());
+    setFreq(0, 500000);
+    sampler.sampleOnce();
+    QList<CpuFreqSample> next = sampler.samples(since);
+    ASSERT_EQ(2, next.size());
+    EXPECT_EQ(since + 1, next[0].seq);
+    EXPECT_EQ(500000u, next[0].khz);
+
+    // 环形缓冲只保留最近 4 次
+    for (int i = 0; i < 5; ++i)
+        sampler.sampleOnce();
+    EXPECT_EQ(8, sampler.samples(sampler.m_FirstSeq).size());
+
+    sampler.closeCpus();
+}
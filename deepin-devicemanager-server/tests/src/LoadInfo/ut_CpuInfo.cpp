@@ -10,6 +10,11 @@
 #include "DeviceInfoManager.h"
 #include <cstring>
 
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
 class CpuInfo_UT : public UT_HEAD
 {
 public:
@@ -55,3 +60,55 @@ TEST_F(CpuInfo_UT, ThreadPoolTask_UT_lscpu)
         EXPECT_TRUE(!numInfo.isEmpty());
     }
 }
+
+static void writeFile(const QString &path, const QByteArray &content)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly))
+        file.write(content);
+}
+
+TEST_F(CpuInfo_UT, CpuInfo_UT_sharedCache)
+{
+    // 1个物理cpu，2个核心，每个核心2个线程，L3 只在 cpu0 下存在，其它cpu通过 shared_cpu_list 得到
+    QTemporaryDir dir;
+    const QString sys = dir.path() + "/cpu";
+    const char *siblings[] = {"0,2", "1,3", "0,2", "1,3"};
+    for (int i = 0; i < 4; ++i) {
+        QString cpu = QString("%1/cpu%2").arg(sys).arg(i);
+        writeFile(cpu + "/topology/physical_package_id", "0\n");
+        writeFile(cpu + "/topology/thread_siblings_list", QByteArray(siblings[i]) + "\n");
+        writeFile(cpu + "/cpufreq/cpuinfo_max_freq", "3000000\n");
+    }
+    for (int i = 0; i < 2; ++i) {
+        QString index = QString("%1/cpu%2/cache/index0").arg(sys).arg(i);
+        writeFile(index + "/level", "1\n");
+        writeFile(index + "/type", "Data\n");
+        writeFile(index + "/size", "32K\n");
+        writeFile(index + "/shared_cpu_list", QByteArray(siblings[i]) + "\n");
+    }
+    writeFile(sys + "/cpu0/cache/index1/level", "3\n");
+    writeFile(sys + "/cpu0/cache/index1/type", "Unified\n");
+    writeFile(sys + "/cpu0/cache/index1/size", "8192K\n");
+    writeFile(sys + "/cpu0/cache/index1/shared_cpu_list", "0-3\n");
+
+    QByteArray cpuinfo;
+    for (int i = 0; i < 4; ++i)
+        cpuinfo += QString("processor\t: %1\nvendor_id\t: GenuineIntel\nmodel name\t: Test CPU @ 3.00GHz\nflags\t\t: fpu vme\n\n").arg(i).toLatin1();
+    writeFile(dir.path() + "/cpuinfo", cpuinfo);
+
+    CpuInfo cpu(sys, dir.path() + "/cpuinfo");
+    ASSERT_TRUE(cpu.loadCpuInfo());
+    EXPECT_EQ(1, cpu.physicalNum());
+    EXPECT_EQ(2, cpu.coreNum());
+    EXPECT_EQ(4, cpu.logicalNum());
+
+    QString info;
+    cpu.logicalCpus(info);
+    EXPECT_EQ(4, info.count("L3 cache : 8192K"));
+    EXPECT_EQ(4, info.count("L1d cache : 32K"));
+    EXPECT_EQ(4, info.count("model name : Test CPU @ 3.00GHz"));
+    EXPECT_EQ(4, info.count("CPU max MHz : 3000MHz"));
+    EXPECT_EQ(2, info.count("core id : 1"));
+}
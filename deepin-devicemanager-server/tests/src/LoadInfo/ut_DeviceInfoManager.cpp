@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "DeviceInfoManager.h"
+#include "DBusInterface.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+class DeviceInfoManager_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+};
+
+TEST_F(DeviceInfoManager_UT, DeviceInfoManager_UT_generation)
+{
+    DeviceInfoManager *manager = DeviceInfoManager::getInstance();
+    manager->addInfo("ut_generation", "1");
+    quint64 generation = manager->generation();
+    EXPECT_EQ(generation, manager->snapshot()->changed.value("ut_generation"));
+
+    // 值没有变化时不发布新版本
+    manager->addInfo("ut_generation", "1");
+    EXPECT_EQ(generation, manager->generation());
+
+    QMap<QString, QString> infos;
+    infos.insert("ut_generation", "2");
+    infos.insert("ut_generation_other", "3");
+    manager->addInfos(infos);
+    EXPECT_EQ(generation + 1, manager->generation());
+    EXPECT_EQ(QString("2"), manager->getInfo("ut_generation"));
+    EXPECT_EQ(QString("3"), manager->getInfo("ut_generation_other"));
+}
+
+TEST_F(DeviceInfoManager_UT, DeviceInfoManager_UT_snapshot)
+{
+    DeviceInfoManager *manager = DeviceInfoManager::getInstance();
+    manager->addInfo("ut_snapshot", "old");
+    DeviceInfoSnapshotPtr snapshot = manager->snapshot();
+
+    // 已获取的快照不受后续写入影响
+    manager->addInfo("ut_snapshot", "new");
+    EXPECT_EQ(QString("old"), snapshot->info.value("ut_snapshot"));
+    EXPECT_EQ(QString("new"), manager->getInfo("ut_snapshot"));
+    EXPECT_LT(snapshot->generation, manager->generation());
+
+    EXPECT_FALSE(manager->isInfoExisted("ut_not_existed"));
+    EXPECT_TRUE(manager->getInfo("ut_not_existed").isEmpty());
+    EXPECT_FALSE(manager->isInfoExisted("ut_not_existed"));
+}
+
+TEST_F(DeviceInfoManager_UT, DeviceInfoManager_UT_getChangedInfos)
+{
+    DBusInterface iface;
+    DeviceInfoManager::getInstance()->addInfo("ut_changed", "1");
+
+    qulonglong current = 0;
+    QStringList largeKeys;
+    QMap<QString, QString> all = iface.getChangedInfos(0, current, largeKeys);
+    EXPECT_EQ(DeviceInfoManager::getInstance()->generation(), current);
+    EXPECT_EQ(QString("1"), all.value("ut_changed"));
+
+    // 没有变化时返回空
+    qulonglong next = 0;
+    EXPECT_TRUE(iface.getChangedInfos(current, next, largeKeys).isEmpty());
+    EXPECT_EQ(current, next);
+
+    DeviceInfoManager::getInstance()->addInfo("ut_changed", "2");
+    QMap<QString, QString> changed = iface.getChangedInfos(current, next, largeKeys);
+    EXPECT_EQ(1, changed.size());
+    EXPECT_EQ(QString("2"), changed.value("ut_changed"));
+
+    QMap<QString, QString> infos = iface.getInfos(QStringList() << "ut_changed" << "ut_not_existed");
+    EXPECT_EQ(2, infos.size());
+    EXPECT_EQ(QString("2"), infos.value("ut_changed"));
+}
+
+TEST_F(DeviceInfoManager_UT, DeviceInfoManager_UT_getInfoFd)
+{
+    DBusInterface iface;
+    QString value = QString("hwinfo \u4e2d\u6587\n").repeated(1000);
+    DeviceInfoManager::getInstance()->addInfo("ut_fd", value);
+
+    QDBusUnixFileDescriptor descriptor = iface.getInfoFd("ut_fd");
+    if (!descriptor.isValid())
+        return;    // 内核不支持 memfd
+
+    int fd = descriptor.fileDescriptor();
+    // 已经密封，不能再修改
+    EXPECT_TRUE(fcntl(fd, F_GET_SEALS) & F_SEAL_WRITE);
+
+    struct stat st;
+    ASSERT_EQ(0, fstat(fd, &st));
+    void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ASSERT_NE(MAP_FAILED, addr);
+    EXPECT_EQ(value, QString::fromUtf8(static_cast<const char *>(addr), static_cast<int>(st.st_size)));
+    munmap(addr, static_cast<size_t>(st.st_size));
+
+    // 内容不变时复用同一个 memfd
+    EXPECT_EQ(fd, iface.getInfoFd("ut_fd").fileDescriptor());
+}
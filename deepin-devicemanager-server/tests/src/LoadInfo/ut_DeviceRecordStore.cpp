@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "DeviceRecordStore.h"
+#include "DeviceInfoManager.h"
+
+const QString HWINFO_USB = "30: USB 00.0: 10503 USB Mouse\n"
+                           "  Unique ID: FKGF.v9Gz4OKeCqF\n"
+                           "  Parent ID: k4bc.2DFUsyrieMD\n"
+                           "  SysFS ID: /devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0\n"
+                           "  SysFS BusID: 1-2:1.0\n"
+                           "  Hardware Class: mouse\n"
+                           "  Model: \"Logitech Optical Mouse\"\n"
+                           "  Driver: \"usbhid\"\n"
+                           "  Device File: /dev/input/mice (/dev/input/mouse0)\n"
+                           "  Device Files: /dev/input/mice, /dev/input/mouse0, /dev/input/event3\n"
+                           "\n"
+                           "31: USB 00.0: 10800 Keyboard\n"
+                           "  Unique ID: KRJj.bSPaVxbm4z6\n"
+                           "  SysFS ID: /devices/pci0000:00/0000:00:14.0/usb1/1-3/1-3:1.0\n"
+                           "  Hardware Class: keyboard\n"
+                           "  Device File: /dev/input/event4\n";
+
+class DeviceRecordStore_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+};
+
+TEST_F(DeviceRecordStore_UT, DeviceRecordStore_UT_parseHwinfo)
+{
+    QList<DeviceRecord> records = DeviceRecordStore::parseHwinfo(HWINFO_USB);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(QString("hwinfo"), records[0].source);
+    EXPECT_EQ(QString("\"Logitech Optical Mouse\""), records[0].value("Model"));
+    // 在第一个 ": " 处切分，值中的 ": " 保留
+    EXPECT_EQ(QString("USB 00.0: 10503 USB Mouse"), records[0].value("30"));
+    EXPECT_EQ(QString("keyboard"), records[1].value("Hardware Class"));
+    EXPECT_FALSE(records[1].contains("Driver"));
+}
+
+TEST_F(DeviceRecordStore_UT, DeviceRecordStore_UT_index)
+{
+    DeviceRecordStore *store = DeviceRecordStore::getInstance();
+    DeviceInfoManager::getInstance()->addInfo("hwinfo", HWINFO_USB);
+
+    DeviceRecord record;
+    EXPECT_TRUE(store->findByUniqueId("KRJj.bSPaVxbm4z6", record));
+    EXPECT_EQ(QString("keyboard"), record.value("Hardware Class"));
+    EXPECT_TRUE(store->findBySysfsId("/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0", record));
+    EXPECT_EQ(QString("FKGF.v9Gz4OKeCqF"), record.value("Unique ID"));
+    EXPECT_FALSE(store->findByUniqueId("not existed", record));
+
+    // usb 设备路径下的接口在 hwinfo 中
+    EXPECT_TRUE(DeviceInfoManager::getInstance()->isPathExisted("/sys/devices/pci0000:00/0000:00:14.0/usb1/1-2"));
+    EXPECT_FALSE(DeviceInfoManager::getInstance()->isPathExisted("/sys/devices/pci0000:00/0000:00:14.0/usb1/1-4"));
+    // 按完整的路径分量比较，1-2 下的接口不属于 1-20
+    EXPECT_TRUE(store->isSysfsPathExisted("/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0"));
+    EXPECT_FALSE(store->isSysfsPathExisted("/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1"));
+    EXPECT_FALSE(DeviceInfoManager::getInstance()->isPathExisted("/sys/devices/pci0000:00/0000:00:14.0/usb1/1"));
+
+    // 信息删除后记录也删除
+    DeviceInfoManager::getInstance()->addInfo("hwinfo", "");
+    EXPECT_TRUE(store->records("hwinfo").isEmpty());
+    EXPECT_FALSE(store->findByUniqueId("KRJj.bSPaVxbm4z6", record));
+}
+
+TEST_F(DeviceRecordStore_UT, DeviceRecordStore_UT_parseLshw)
+{
+    const QString info = "uos-PC\n"
+                         "    description: Desktop Computer\n"
+                         "    configuration: boot=normal chassis=desktop\n"
+                         "  *-cpu:0\n"
+                         "       product: Intel(R) Core(TM) i5\n"
+                         "       resources: irq:0 memory:f7000000-f7ffffff irq:1\n";
+    QList<DeviceRecord> records = DeviceRecordStore::parseLshw(info);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(QString("lshw"), records[0].source);
+    EXPECT_EQ(QString("uos-PC"), records[0].value("*-"));
+    EXPECT_EQ(QString("desktop"), records[0].value("chassis"));
+    EXPECT_EQ(QString("cpu:0"), records[1].value("*-"));
+    EXPECT_EQ(QString("Intel(R) Core(TM) i5"), records[1].value("product"));
+    // resources 中相同的 key 用两个空格连接
+    EXPECT_EQ(QString("0  1"), records[1].value("irq"));
+    EXPECT_TRUE(DeviceRecordStore::parseLshw("").isEmpty());
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "DeviceSnapshot.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+
+class DeviceSnapshot_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_Path = m_Dir.path() + "/cache/device-info.snapshot";
+    }
+    void TearDown()
+    {
+    }
+
+    QTemporaryDir m_Dir;
+    QString m_Path;
+};
+
+TEST_F(DeviceSnapshot_UT, DeviceSnapshot_UT_saveAndLoad)
+{
+    QMap<QString, QString> info;
+    info.insert("lshw", "*-core\n     description: Motherboard\n");
+    info.insert("dmidecode_0", QString("BIOS Information\n\tVendor: LENOVO\n"));
+
+    DeviceSnapshot writer(m_Path);
+    EXPECT_TRUE(writer.save(info));
+
+    DeviceSnapshot reader(m_Path);
+    EXPECT_TRUE(reader.load());
+    EXPECT_EQ(info, reader.info());
+    EXPECT_EQ(!DeviceSnapshot::bootId().isEmpty(), reader.sameBoot());
+}
+
+TEST_F(DeviceSnapshot_UT, DeviceSnapshot_UT_invalid)
+{
+    DeviceSnapshot snapshot(m_Path);
+    EXPECT_FALSE(snapshot.load());
+
+    // 格式不正确的快照
+    QFile file(m_Dir.path() + "/broken.snapshot");
+    file.open(QIODevice::WriteOnly);
+    file.write("not a snapshot");
+    file.close();
+
+    DeviceSnapshot broken(m_Dir.path() + "/broken.snapshot");
+    EXPECT_FALSE(broken.load());
+    EXPECT_TRUE(broken.info().isEmpty());
+}
+
+TEST_F(DeviceSnapshot_UT, DeviceSnapshot_UT_truncated)
+{
+    QMap<QString, QString> info;
+    info.insert("lshw", QString(4096, QChar('x')));
+
+    DeviceSnapshot writer(m_Path);
+    EXPECT_TRUE(writer.save(info));
+
+    // 写入中断的快照不完整，不能使用
+    QFile file(m_Path);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() - 16);
+    file.close();
+
+    DeviceSnapshot reader(m_Path);
+    EXPECT_FALSE(reader.load());
+    EXPECT_TRUE(reader.info().isEmpty());
+}
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "DmiDecoder.h"
+
+class DmiDecoder_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        // SMBIOS 3.2.0 64位入口
+        m_Entry = QByteArray(24, '\0');
+        m_Entry.replace(0, 5, "_SM3_");
+        m_Entry[6] = 24;
+        m_Entry[7] = 3;
+        m_Entry[8] = 2;
+        m_Entry[9] = 0;
+
+        // type 1 : System Information
+        QByteArray system(0x1B, '\0');
+        system[0] = 1;
+        system[1] = 0x1B;
+        system[2] = 0x01;
+        system[4] = 1;
+        system[5] = 2;
+        system[6] = 0;
+        system[7] = 3;
+        for (int i = 0; i < 16; ++i)
+            system[0x08 + i] = static_cast<char>(i + 1);
+        system[0x18] = 6;
+        m_Table += system;
+        m_Table += QByteArray("LENOVO\0ThinkCentre M70t\0PC1A2B3C\0\0", 34);
+
+        // type 17 : Memory Device, 8 GB DDR4
+        QByteArray memory(0x28, '\0');
+        memory[0] = 17;
+        memory[1] = 0x28;
+        memory[2] = 0x02;
+        memory[0x08] = 64;
+        memory[0x0A] = 64;
+        memory[0x0C] = 0x00;
+        memory[0x0D] = 0x20;
+        memory[0x0E] = 0x0D;
+        memory[0x10] = 1;
+        memory[0x11] = 2;
+        memory[0x12] = 0x1A;
+        memory[0x13] = 0x80;
+        memory[0x15] = 0x80;
+        memory[0x16] = 0x0C;
+        memory[0x17] = 3;
+        memory[0x18] = 4;
+        memory[0x19] = 0;
+        memory[0x1A] = 5;
+        memory[0x1B] = 1;
+        memory[0x20] = 0x80;
+        memory[0x21] = 0x0C;
+        memory[0x22] = 0xB0;
+        memory[0x23] = 0x04;
+        memory[0x24] = 0xB0;
+        memory[0x25] = 0x04;
+        memory[0x26] = 0xB0;
+        memory[0x27] = 0x04;
+        m_Table += memory;
+        m_Table += QByteArray("DIMM0\0BANK 0\0Samsung\00012345678\0M378A1K43DB2-CTD\0\0", 48);
+
+        // type 127 : End Of Table
+        QByteArray end(4, '\0');
+        end[0] = 127;
+        end[1] = 4;
+        m_Table += end;
+        m_Table += QByteArray("\0\0", 2);
+    }
+    void TearDown()
+    {
+    }
+
+    QByteArray m_Entry;
+    QByteArray m_Table;
+};
+
+TEST_F(DmiDecoder_UT, DmiDecoder_UT_loadFromData)
+{
+    DmiDecoder dmi;
+    EXPECT_TRUE(dmi.loadFromData(m_Entry, m_Table));
+    EXPECT_EQ(QString("3.2.0"), dmi.version());
+    EXPECT_EQ(3, dmi.structures().size());
+    EXPECT_EQ(QString("ThinkCentre M70t\n"), dmi.systemProductName());
+}
+
+TEST_F(DmiDecoder_UT, DmiDecoder_UT_typeInfo)
+{
+    DmiDecoder dmi;
+    dmi.loadFromData(m_Entry, m_Table);
+
+    QString system = dmi.typeInfo(1);
+    EXPECT_TRUE(system.contains("SMBIOS 3.2.0 present."));
+    EXPECT_TRUE(system.contains("Handle 0x0001, DMI type 1, 27 bytes\nSystem Information\n"));
+    EXPECT_TRUE(system.contains("\tManufacturer: LENOVO\n"));
+    EXPECT_TRUE(system.contains("\tVersion: Not Specified\n"));
+    EXPECT_TRUE(system.contains("\tUUID: 04030201-0605-0807-090A-0B0C0D0E0F10\n"));
+    EXPECT_TRUE(system.contains("\tWake-up Type: Power Switch\n"));
+
+    QString memory = dmi.typeInfo(17);
+    EXPECT_TRUE(memory.contains("\tSize: 8 GB\n"));
+    EXPECT_TRUE(memory.contains("\tForm Factor: SODIMM\n"));
+    EXPECT_TRUE(memory.contains("\tType: DDR4\n"));
+    EXPECT_TRUE(memory.contains("\tSpeed: 3200 MT/s\n"));
+    EXPECT_TRUE(memory.contains("\tPart Number: M378A1K43DB2-CTD\n"));
+    EXPECT_TRUE(memory.contains("\tConfigured Memory Speed: 3200 MT/s\n"));
+    EXPECT_TRUE(memory.contains("\tConfigured Voltage: 1.2 V\n"));
+
+    // 不存在的类型只输出头信息
+    EXPECT_FALSE(dmi.typeInfo(4).contains("Handle"));
+}
+
+TEST_F(DmiDecoder_UT, DmiDecoder_UT_badEntry)
+{
+    DmiDecoder dmi;
+    EXPECT_FALSE(dmi.loadFromData(QByteArray("invalid"), m_Table));
+    EXPECT_FALSE(DmiDecoder("/not_existed").load());
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "KernelConfig.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <sys/utsname.h>
+#include <zlib.h>
+
+static const char *s_Config =
+    "#\n"
+    "# Automatically generated file; DO NOT EDIT.\n"
+    "#\n"
+    "CONFIG_USB_STORAGE=y\n"
+    "CONFIG_SND_HDA_INTEL=m\n"
+    "# CONFIG_NVME_CORE is not set\n"
+    "CONFIG_BLK_DEV_SD=y\n"
+    "CONFIG_LOG_BUF_SHIFT=18\n";
+
+class KernelConfig_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_Cache = m_Dir.path() + "/cache/kernel-config.cache";
+        m_Proc = m_Dir.path() + "/config.gz";
+    }
+    void TearDown()
+    {
+    }
+
+    QTemporaryDir m_Dir;
+    QString m_Cache;
+    QString m_Proc;
+};
+
+TEST_F(KernelConfig_UT, KernelConfig_UT_gzip)
+{
+    gzFile file = gzopen(m_Proc.toLocal8Bit().constData(), "wb");
+    ASSERT_TRUE(file != nullptr);
+    gzputs(file, s_Config);
+    gzclose(file);
+
+    KernelConfig config(m_Cache, m_Proc, m_Dir.path());
+    EXPECT_TRUE(config.isBuiltIn("CONFIG_USB_STORAGE"));
+    EXPECT_TRUE(config.isBuiltIn("BLK_DEV_SD"));
+    EXPECT_FALSE(config.isBuiltIn("CONFIG_SND_HDA_INTEL"));
+    EXPECT_FALSE(config.isBuiltIn("CONFIG_NVME_CORE"));
+    EXPECT_EQ(2, config.symbols().size());
+
+    // 配置文件不存在时使用缓存
+    QFile::remove(m_Proc);
+    QFile proc(m_Proc);
+    ASSERT_TRUE(proc.open(QIODevice::WriteOnly));
+    proc.close();
+    KernelConfig cached(m_Cache, m_Proc, m_Dir.path());
+    EXPECT_TRUE(cached.isBuiltIn("CONFIG_USB_STORAGE"));
+}
+
+TEST_F(KernelConfig_UT, KernelConfig_UT_boot)
+{
+    struct utsname name;
+    ASSERT_EQ(0, uname(&name));
+    QFile file(m_Dir.path() + "/config-" + QString::fromLatin1(name.release));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(s_Config);
+    file.close();
+
+    KernelConfig config(m_Cache, m_Dir.path() + "/not-existed.gz", m_Dir.path());
+    EXPECT_TRUE(config.isBuiltIn("CONFIG_USB_STORAGE"));
+    EXPECT_FALSE(config.isBuiltIn("CONFIG_LOG_BUF_SHIFT"));
+}
+
+TEST_F(KernelConfig_UT, KernelConfig_UT_truncatedGzip)
+{
+    gzFile file = gzopen(m_Proc.toLocal8Bit().constData(), "wb");
+    ASSERT_TRUE(file != nullptr);
+    gzputs(file, s_Config);
+    gzclose(file);
+
+    // 截断压缩文件，去掉结尾的校验和长度
+    QFile proc(m_Proc);
+    ASSERT_TRUE(proc.open(QIODevice::ReadWrite));
+    proc.resize(proc.size() - 8);
+    proc.close();
+
+    KernelConfig config(m_Cache, m_Proc, m_Dir.path());
+    EXPECT_FALSE(config.load());
+    EXPECT_TRUE(config.symbols().isEmpty());
+    EXPECT_FALSE(QFile::exists(m_Cache));
+}
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "KmsgReader.h"
+
+class KmsgReader_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_Reader = new KmsgReader("/ut-not-existed/kmsg");
+    }
+    void TearDown()
+    {
+        delete m_Reader;
+    }
+
+    KmsgReader *m_Reader;
+};
+
+TEST_F(KmsgReader_UT, KmsgReader_UT_parseRecord)
+{
+    m_Reader->parseRecord("6,100,1234567,-;amdgpu 0000:03:00.0: amdgpu: VRAM: 4096M 0x0000008000000000 - 0x00000080FFFFFFFF (4096M used)\n SUBSYSTEM=pci\n DEVICE=+pci:0000:03:00.0\n");
+    m_Reader->parseRecord("6,101,1234568,-;snd_hda_codec_realtek hdaudioC0D0: autoconfig for ALC887-VD: line_outs=1 (0x14/0x0/0x0/0x0/0x0) type:line\n");
+    m_Reader->parseRecord("6,102,1234569,-;usb 1-1: new high-speed USB device number 2 using xhci_hcd\n");
+    EXPECT_EQ(QString("VRAM: 0000:03:00.0=4GB\nAudioChip: ALC887-VD\n"), m_Reader->facts());
+
+    // 已经处理过的记录不再重复处理
+    m_Reader->parseRecord("6,100,1234567,-;jjw: VRAM Size 2048M\n");
+    EXPECT_FALSE(m_Reader->facts().contains("null"));
+
+    m_Reader->parseRecord("6,103,1234570,-;jjw: VRAM Size 2048M\n");
+    EXPECT_EQ(QString("VRAM: null=2GB\nVRAM: 0000:03:00.0=4GB\nAudioChip: ALC887-VD\n"), m_Reader->facts());
+}
+
+TEST_F(KmsgReader_UT, KmsgReader_UT_readNew)
+{
+    EXPECT_FALSE(m_Reader->readNew());
+    EXPECT_TRUE(m_Reader->facts().isEmpty());
+}
+
+TEST_F(KmsgReader_UT, KmsgReader_UT_mergeFacts)
+{
+    // 快照中的信息补充到读取的信息中，读取到的信息优先
+    m_Reader->parseRecord("6,100,1234567,-;amdgpu 0000:03:00.0: amdgpu: VRAM: 8192M 0x0000008000000000 - 0x00000080FFFFFFFF (8192M used)\n");
+    m_Reader->mergeFacts("VRAM: null=2GB\nVRAM: 0000:03:00.0=4GB\nAudioChip: ALC887-VD\n");
+    EXPECT_EQ(QString("VRAM: null=2GB\nVRAM: 0000:03:00.0=8GB\nAudioChip: ALC887-VD\n"), m_Reader->facts());
+
+    // 重复合并结果不变
+    m_Reader->mergeFacts(m_Reader->facts());
+    EXPECT_EQ(QString("VRAM: null=2GB\nVRAM: 0000:03:00.0=8GB\nAudioChip: ALC887-VD\n"), m_Reader->facts());
+}
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "PciEnumerator.h"
+
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+
+class PciEnumerator_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        QDir root(m_Dir.path());
+        root.mkpath("devices");
+
+        // ISA bridge
+        addDevice("0000:00:1f.0", "0x060100", "0x8086", "0xa3c8", "0x17aa", "0x3124", "0x00",
+                  "0x00000000fe010000 0x00000000fe010fff 0x0000000000040200\n");
+        // VGA, the first memory BAR is 32-bit
+        addDevice("0000:00:02.0", "0x030000", "0x8086", "0x9bc8", "0x17aa", "0x3124", "0x05",
+                  "0x00000000f6000000 0x00000000f6ffffff 0x0000000000040200\n");
+
+        QFile ids(root.filePath("pci.ids"));
+        ids.open(QIODevice::WriteOnly);
+        ids.write("8086  Intel Corporation\n"
+                  "\ta3c8  B460 Chipset LPC/eSPI Controller\n"
+                  "\t\t17aa 3124  ThinkCentre M70t\n"
+                  "17aa  Lenovo\n"
+                  "C 06  Bridge\n"
+                  "\t01  ISA bridge\n");
+        ids.close();
+    }
+    void TearDown()
+    {
+    }
+
+    void addDevice(const QString &slot, const QByteArray &cls, const QByteArray &vendor, const QByteArray &device,
+                   const QByteArray &subVendor, const QByteArray &subDevice, const QByteArray &rev, const QByteArray &resource)
+    {
+        QDir dir(m_Dir.path() + "/devices/" + slot);
+        dir.mkpath(".");
+        writeFile(dir.filePath("class"), cls);
+        writeFile(dir.filePath("vendor"), vendor);
+        writeFile(dir.filePath("device"), device);
+        writeFile(dir.filePath("subsystem_vendor"), subVendor);
+        writeFile(dir.filePath("subsystem_device"), subDevice);
+        writeFile(dir.filePath("revision"), rev);
+        writeFile(dir.filePath("resource"), resource);
+    }
+
+    void writeFile(const QString &path, const QByteArray &data)
+    {
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write(data + "\n");
+        file.close();
+    }
+
+    QTemporaryDir m_Dir;
+};
+
+TEST_F(PciEnumerator_UT, PciEnumerator_UT_enumerate)
+{
+    PciEnumerator pci(m_Dir.path() + "/devices", m_Dir.path() + "/pci.ids");
+    EXPECT_TRUE(pci.enumerate());
+    EXPECT_EQ(2, pci.devices().size());
+
+    // 按目录名排序，pci.ids 中没有的类名使用内置的名称
+    EXPECT_EQ(QString("00:02.0 VGA compatible controller: Intel Corporation Device 9bc8 (rev 05)\n"
+                      "00:1f.0 ISA bridge: Intel Corporation B460 Chipset LPC/eSPI Controller\n"),
+              pci.lspciInfo());
+
+    EXPECT_EQ(QString("00:1f.0 ISA bridge: Intel Corporation B460 Chipset LPC/eSPI Controller\n"
+                      "\tSubsystem: Lenovo ThinkCentre M70t\n"
+                      "\tMemory at fe010000 (32-bit, non-prefetchable) [size=4K]\n"
+                      "\n"),
+              pci.lspciVSInfo());
+
+    EXPECT_EQ(QString("00:02.0-32\n"), pci.widthInfo());
+}
+
+TEST_F(PciEnumerator_UT, PciEnumerator_UT_domain)
+{
+    // 存在非0 domain时显示完整的槽位
+    addDevice("0001:00:00.0", "0x060400", "0x8086", "0xa3c8", "0x0000", "0x0000", "0x00", "\n");
+    PciEnumerator pci(m_Dir.path() + "/devices", m_Dir.path() + "/pci.ids");
+    EXPECT_TRUE(pci.enumerate());
+    ASSERT_EQ(3, pci.devices().size());
+    EXPECT_EQ(QString("0001:00:00.0"), pci.devices()[2].slot);
+    EXPECT_TRUE(pci.lspciInfo().startsWith("0000:00:02.0 VGA compatible controller"));
+    EXPECT_TRUE(pci.lspciInfo().contains("0001:00:00.0 PCI bridge: Intel Corporation B460 Chipset LPC/eSPI Controller\n"));
+}
+
+TEST_F(PciEnumerator_UT, PciEnumerator_UT_noSysfs)
+{
+    PciEnumerator pci(m_Dir.path() + "/not_existed", m_Dir.path() + "/pci.ids");
+    EXPECT_FALSE(pci.enumerate());
+    EXPECT_TRUE(pci.lspciInfo().isEmpty());
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "ProcessLauncher.h"
+
+#include <QElapsedTimer>
+
+#include <signal.h>
+
+class ProcessLauncher_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+};
+
+TEST_F(ProcessLauncher_UT, ProcessLauncher_UT_run)
+{
+    QString output;
+    EXPECT_TRUE(ProcessLauncher::runCommand("echo  ok", 5000, output));
+    EXPECT_EQ(QString("ok\n"), output);
+
+    // 超过初始缓冲区大小的输出
+    QByteArray data;
+    EXPECT_TRUE(ProcessLauncher::run("head", QStringList() << "-c" << "200000" << "/dev/zero", 5000, data));
+    EXPECT_EQ(200000, data.size());
+
+    // 不存在的命令
+    ProcessStat stat;
+    EXPECT_FALSE(ProcessLauncher::run("ut-not-existed-cmd", QStringList(), 5000, output, &stat));
+    EXPECT_FALSE(stat.started);
+    EXPECT_FALSE(stat.timedOut);
+    EXPECT_TRUE(output.isEmpty());
+}
+
+TEST_F(ProcessLauncher_UT, ProcessLauncher_UT_timeout)
+{
+    // bash 的子进程也随进程组一起结束
+    QString output;
+    QElapsedTimer timer;
+    timer.start();
+    EXPECT_FALSE(ProcessLauncher::run("/bin/bash", QStringList() << "-c" << "echo part; sleep 30 | cat", 300, output));
+    EXPECT_LT(timer.elapsed(), 5000);
+    EXPECT_EQ(QString("part\n"), output);
+}
+
+TEST_F(ProcessLauncher_UT, ProcessLauncher_UT_waitExit)
+{
+    // 关闭标准输出后进程仍在运行，等待退出时也受超时时间限制
+    QString output;
+    ProcessStat stat;
+    QElapsedTimer timer;
+    timer.start();
+    EXPECT_FALSE(ProcessLauncher::run("/bin/bash", QStringList() << "-c" << "echo part; exec >&-; sleep 30", 300, output, &stat));
+    EXPECT_LT(timer.elapsed(), 5000);
+    EXPECT_TRUE(stat.started);
+    EXPECT_TRUE(stat.timedOut);
+    EXPECT_EQ(SIGKILL, stat.termSignal);
+
+    // 关闭标准输出后很快退出，正常回收并获取返回值
+    EXPECT_TRUE(ProcessLauncher::run("/bin/bash", QStringList() << "-c" << "exec >&-; sleep 0.1; exit 3", 5000, output, &stat));
+    EXPECT_FALSE(stat.timedOut);
+    EXPECT_EQ(3, stat.exitCode);
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "SmartctlProbe.h"
+
+class SmartctlProbe_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_Info  = "smartctl 7.2 2020-12-30 r5155 [x86_64-linux-5.10.0] (local build)\n\n";
+        m_Info += "=== START OF INFORMATION SECTION ===\n";
+        m_Info += "Device Model:     ST1000DM010-2EP102\n";
+        m_Info += "Serial Number:    Z9A1B2C3\n";
+        m_Info += "LU WWN Device Id: 5 000c50 0a1b2c3d4\n";
+        m_Info += "Firmware Version: CC43\n\n";
+        m_Info += "=== START OF READ SMART DATA SECTION ===\n";
+        m_Info += "SMART overall-health self-assessment test result: PASSED\n";
+        m_Info += "  9 Power_On_Hours          0x0032   089   089   000    Old_age   Always       -       10238\n";
+    }
+    void TearDown()
+    {
+        SmartctlProbe::clearCache();
+    }
+
+    QString m_Info;
+};
+
+TEST_F(SmartctlProbe_UT, SmartctlProbe_UT_sections)
+{
+    QString identity = SmartctlProbe::identitySection(m_Info);
+    EXPECT_TRUE(identity.contains("Firmware Version: CC43"));
+    EXPECT_FALSE(identity.contains("Power_On_Hours"));
+
+    QString data = SmartctlProbe::dataSection(m_Info);
+    EXPECT_TRUE(data.startsWith("=== START OF READ SMART DATA SECTION ==="));
+    EXPECT_TRUE(data.contains("Power_On_Hours"));
+    EXPECT_EQ(m_Info, identity + data);
+
+    EXPECT_TRUE(SmartctlProbe::identitySection("Read Device Identity failed: scsi error\n").isEmpty());
+}
+
+TEST_F(SmartctlProbe_UT, SmartctlProbe_UT_identityKeys)
+{
+    QStringList keys = SmartctlProbe::identityKeys(SmartctlProbe::identitySection(m_Info));
+    EXPECT_TRUE(keys.contains("serial:Z9A1B2C3"));
+    EXPECT_TRUE(keys.contains("wwn:5000c500a1b2c3d4"));
+}
+
+TEST_F(SmartctlProbe_UT, SmartctlProbe_UT_probeEmpty)
+{
+    SmartctlProbe probe;
+    probe.probe(QStringList());
+    EXPECT_TRUE(probe.results().isEmpty());
+}
+
+TEST_F(SmartctlProbe_UT, SmartctlProbe_UT_quarantineEntry)
+{
+    // 按硬盘的身份隔离，设备名变化后仍然有效
+    EXPECT_EQ(QString("smartctl:wwn:5000c500a1b2c3d4"),
+              SmartctlProbe::quarantineEntry("sdb", QStringList() << "wwn:5000c500a1b2c3d4" << "serial:Z9A1B2C3"));
+    EXPECT_EQ(QString("smartctl:sdb"), SmartctlProbe::quarantineEntry("sdb", QStringList()));
+}
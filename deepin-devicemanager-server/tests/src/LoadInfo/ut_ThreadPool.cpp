@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../ut_Head.h"
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+
+class ThreadPool_UT : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+};
+
+TEST_F(ThreadPool_UT, ThreadPool_UT_keysOfCategories)
+{
+    // usb鼠标不需要刷新存储设备信息
+    QStringList keys = ThreadPool::keysOfCategories(QStringList() << "usb" << "input");
+    EXPECT_TRUE(keys.contains("hwinfo"));
+    EXPECT_TRUE(keys.contains("lshw"));
+    EXPECT_FALSE(keys.contains("lsblk_d"));
+
+    keys = ThreadPool::keysOfCategories(QStringList() << "usb" << "storage");
+    EXPECT_TRUE(keys.contains("lsblk_d"));
+    EXPECT_TRUE(keys.contains("ls_sg"));
+    EXPECT_FALSE(keys.contains("lpstat"));
+}
@@ -9,6 +9,10 @@
 #include <QThreadPool>
 #include "cpu/CpuInfo.h"
 #include "DeviceInfoManager.h"
+#include "PciEnumerator.h"
+#include "CollectorQuarantine.h"
+#include "CollectorMetrics.h"
+#include "DmiDecoder.h"
 
 class ThreadPoolTask_UT : public UT_HEAD
 {
@@ -72,3 +76,173 @@ TEST_F(ThreadPoolTask_UT, ThreadPoolTask_UT_lscpu)
     EXPECT_TRUE(!DeviceInfoManager::getInstance()->getInfo("lscpu").isEmpty());
     EXPECT_TRUE(!DeviceInfoManager::getInstance()->getInfo("lscpu_num").isEmpty());
 }
+
+bool ut_pci_enumerate_failed()
+{
+    return false;
+}
+
+bool ut_not_quarantined()
+{
+    return false;
+}
+
+bool ut_runCmd_lspci(void *obj, const QString &cmd, const QString &collector, QString &info, bool *started)
+{
+    Q_UNUSED(obj);
+    Q_UNUSED(collector);
+    if (started)
+        *started = true;
+    if (cmd == "lspci") {
+        info = "00:02.0 VGA compatible controller: Intel Corporation Device 9bc8 (rev 05)\n"
+               "00:1f.0 ISA bridge: Intel Corporation B460 Chipset LPC/eSPI Controller\n";
+    } else if (cmd == "lspci -v -s 00:1f.0") {
+        info = "00:1f.0 ISA bridge: Intel Corporation B460 Chipset LPC/eSPI Controller\n"
+               "\tMemory at fe010000 (32-bit, non-prefetchable) [size=4K]\n";
+    } else if (cmd == "lspci -v -s 00:02.0") {
+        info = "00:02.0 VGA compatible controller: Intel Corporation Device 9bc8 (rev 05)\n"
+               "\tMemory at f6000000 (32-bit, non-prefetchable) [size=16M]\n";
+    } else {
+        info.clear();
+    }
+    return true;
+}
+
+TEST_F(ThreadPoolTask_UT, ThreadPoolTask_UT_lspci_fallback)
+{
+    Stub stub;
+    stub.set(ADDR(PciEnumerator, enumerate), ut_pci_enumerate_failed);
+    stub.set(ADDR(CollectorQuarantine, isQuarantined), ut_not_quarantined);
+    stub.set(ADDR(ThreadPoolTask, runCmd), ut_runCmd_lspci);
+
+    // sysfs 不可读时使用 lspci 命令的输出
+    ThreadPoolTask task("lspci", "lspci.txt", false, 500);
+    task.loadPciInfo();
+
+    DeviceInfoManager *manager = DeviceInfoManager::getInstance();
+    EXPECT_TRUE(manager->getInfo("lspci").startsWith("00:02.0 VGA compatible controller"));
+    EXPECT_TRUE(manager->getInfo("lspci_vs").contains("Memory at fe010000"));
+    EXPECT_EQ(QString("00:02.0-32\n"), manager->getInfo("width"));
+}
+
+TEST_F(ThreadPoolTask_UT, ThreadPoolTask_UT_runCmdToCache_notStarted)
+{
+    Stub stub;
+    stub.set(ADDR(CollectorQuarantine, isQuarantined), ut_not_quarantined);
+
+    // 命令无法启动时保留已有的信息
+    DeviceInfoManager::getInstance()->addInfo("ut_not_existed", "cached info");
+    ThreadPoolTask task("ut-not-existed-cmd", "ut_not_existed.txt", false, 500);
+    task.runCmdToCache("ut-not-existed-cmd");
+    EXPECT_EQ(QString("cached info"), DeviceInfoManager::getInstance()->getInfo("ut_not_existed"));
+}
+
+void ut_loadDmidecodeInfo_sysfs(void *obj)
+{
+    Q_UNUSED(obj);
+}
+void ut_loadDmidecodeInfo_fallback(void *obj)
+{
+    // 回退到 dmidecode 命令，子进程由 runCmd 记录
+    static_cast<ThreadPoolTask *>(obj)->m_Spawned = true;
+}
+TEST_F(ThreadPoolTask_UT, ThreadPoolTask_UT_metrics_once)
+{
+    CollectorMetrics *metrics = CollectorMetrics::getInstance();
+    quint64 runs = metrics->stats().value("dmidecode").runs;
+
+    // 进程内采集记录一次
+    Stub stub;
+    stub.set(ADDR(ThreadPoolTask, loadDmidecodeInfo), ut_loadDmidecodeInfo_sysfs);
+    ThreadPoolTask sysfs("dmidecode", "dmidecode.txt", false, 500);
+    sysfs.run();
+    EXPECT_EQ(runs + 1, metrics->stats().value("dmidecode").runs);
+
+    // 执行了外部命令时不再按进程内采集重复记录
+    stub.set(ADDR(ThreadPoolTask, loadDmidecodeInfo), ut_loadDmidecodeInfo_fallback);
+    ThreadPoolTask fallback("dmidecode", "dmidecode.txt", false, 500);
+    fallback.run();
+    EXPECT_EQ(runs + 1, metrics->stats().value("dmidecode").runs);
+}
+
+bool ut_dmi_load_failed()
+{
+    return false;
+}
+void ut_quarantine_add(void *obj, const QString &entry)
+{
+    Q_UNUSED(obj);
+    Q_UNUSED(entry);
+}
+bool ut_runCmd_dmidecode_timeout(void *obj, const QString &cmd, const QString &collector, QString &info, bool *started)
+{
+    Q_UNUSED(obj);
+    Q_UNUSED(collector);
+    if (started)
+        *started = true;
+    // type 2 超时，只输出了一部分
+    info = QString("# dmidecode 3.2\nut %1").arg(cmd);
+    return cmd != "dmidecode -t 2";
+}
+TEST_F(ThreadPoolTask_UT, ThreadPoolTask_UT_dmidecode_timeout)
+{
+    Stub stub;
+    stub.set(ADDR(DmiDecoder, load), ut_dmi_load_failed);
+    stub.set(ADDR(CollectorQuarantine, isQuarantined), ut_not_quarantined);
+    stub.set(ADDR(CollectorQuarantine, add), ut_quarantine_add);
+    stub.set(ADDR(ThreadPoolTask, runCmd), ut_runCmd_dmidecode_timeout);
+
+    // 超时的输出不发布，保留已有的信息
+    DeviceInfoManager *manager = DeviceInfoManager::getInstance();
+    manager->addInfo("dmidecode_2", "cached info");
+    manager->addInfo("dmidecode_3", "cached info");
+    ThreadPoolTask task("dmidecode", "dmidecode.txt", false, 500);
+    task.loadDmidecodeInfo();
+
+    EXPECT_TRUE(manager->getInfo("dmidecode_1").endsWith("dmidecode -t 1"));
+    EXPECT_EQ(QString("cached info"), manager->getInfo("dmidecode_2"));
+    EXPECT_EQ(QString("cached info"), manager->getInfo("dmidecode_3"));
+}
+
+bool ut_hwinfo_quarantined(void *obj, const QString &entry)
+{
+    Q_UNUSED(obj);
+    return entry == "hwinfo";
+}
+bool ut_runCmd_hwinfo_class(void *obj, const QString &cmd, const QString &collector, QString &info, bool *started)
+{
+    Q_UNUSED(obj);
+    Q_UNUSED(collector);
+    if (started)
+        *started = true;
+    QString mouse = "02: USB 00.0: 10503 USB Mouse\n  Unique ID: ut.mouse\n  Model: \"UT Mouse\"\n";
+    if (cmd == "hwinfo --usb") {
+        info = "01: USB 00.0: 0000 Unclassified device\n  Unique ID: ut.hub\n  Model: \"UT Hub\"\n\n" + mouse;
+    } else if (cmd == "hwinfo --mouse") {
+        info = mouse;
+    } else {
+        // display 超时
+        info = "01: PCI 02.0: 0300 VGA compatible controller";
+        return false;
+    }
+    return true;
+}
+TEST_F(ThreadPoolTask_UT, ThreadPoolTask_UT_hwinfo_byClass)
+{
+    Stub stub;
+    stub.set(ADDR(CollectorQuarantine, isQuarantined), ut_hwinfo_quarantined);
+    stub.set(ADDR(CollectorQuarantine, add), ut_quarantine_add);
+    stub.set(ADDR(CollectorQuarantine, release), ut_quarantine_add);
+    stub.set(ADDR(ThreadPoolTask, runCmd), ut_runCmd_hwinfo_class);
+
+    // 完整的 hwinfo 超时过，按类别获取，超时的类别跳过，重复的设备只保留一个
+    QString cmd = "hwinfo --usb --mouse --display";
+    ThreadPoolTask task(cmd, "hwinfo.txt", false, 60000);
+    task.runCmdToCache(cmd);
+
+    QString info = DeviceInfoManager::getInstance()->getInfo("hwinfo");
+    EXPECT_EQ(1, info.count("Unique ID: ut.mouse"));
+    EXPECT_TRUE(info.contains("Unique ID: ut.hub"));
+    EXPECT_FALSE(info.contains("VGA compatible controller"));
+    EXPECT_EQ(60000, task.m_Waiting);
+}
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "MainJob.h"
+#include "EnableUtils.h"
 #include "ut_Head.h"
 #include <gtest/gtest.h>
 #include "stub.h"
@@ -67,3 +68,40 @@ TEST_F(MainJob_UT, MainJob_UT_initDBus)
 {
     m_mainJob->initDBus();
 }
+
+TEST_F(MainJob_UT, MainJob_UT_updateDevice_pending)
+{
+    // 线程池调度期间的请求合并到下一轮，不阻塞等待
+    m_mainJob->m_FirstUpdate = false;
+    m_mainJob->m_PoolRunning = true;
+    m_mainJob->m_PendingAll = false;
+    m_mainJob->updateDevice(QStringList() << "usb" << "storage");
+    m_mainJob->updateDevice(QStringList() << "storage");
+    EXPECT_EQ(QStringList() << "usb" << "storage", m_mainJob->m_PendingCategories);
+    EXPECT_FALSE(m_mainJob->m_PendingAll);
+    EXPECT_TRUE(MainJob::serverIsRunning());
+
+    m_mainJob->updateAllDevice();
+    EXPECT_TRUE(m_mainJob->m_PendingAll);
+}
+
+static int ut_applyCount = 0;
+void ut_disableInDevice()
+{
+    ++ut_applyCount;
+}
+
+TEST_F(MainJob_UT, MainJob_UT_slotPoolFinished_applyOnce)
+{
+    // 禁用设备和唤醒设置只在第一轮获取完成后执行一次
+    Stub stub;
+    stub.set(ADDR(EnableUtils, disableInDevice), ut_disableInDevice);
+    ut_applyCount = 0;
+    m_mainJob->m_DeviceStateApplied = false;
+    m_mainJob->m_PendingAll = false;
+    m_mainJob->m_PendingCategories.clear();
+    m_mainJob->slotPoolFinished();
+    m_mainJob->slotPoolFinished();
+    EXPECT_EQ(1, ut_applyCount);
+    EXPECT_TRUE(m_mainJob->m_DeviceStateApplied);
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LoadInfoThread.h"
+#include "CollectorBundle.h"
+
+#include <QApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDir>
+
+#include <algorithm>
+
+/**
+ * @brief findBundles : a bundle directory or a directory of bundles
+ */
+static QStringList findBundles(const QString &path)
+{
+    QStringList bundles;
+    QDir dir(path);
+    if (dir.exists("info")) {
+        bundles << dir.absolutePath();
+        return bundles;
+    }
+    foreach (const QString &name, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        if (QDir(dir.filePath(name)).exists("info"))
+            bundles << QDir(dir.filePath(name)).absolutePath();
+    }
+    return bundles;
+}
+
+/**
+ * @brief runOnce : msec from starting the refresh to LoadInfoThread::finished
+ */
+static qint64 runOnce()
+{
+    LoadInfoThread thread;
+    QEventLoop loop;
+    QObject::connect(&thread, &LoadInfoThread::finished, &loop, &QEventLoop::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    thread.start();
+    // 事件循环同时处理 GetInfoPool::finishedAll
+    loop.exec();
+    qint64 elapsed = timer.elapsed();
+    thread.wait();
+    return elapsed;
+}
+
+// 用法: deepin-devicemanager-replay-bench [-n rounds] <bundle>...
+// 后台以 DEVICEMANAGER_CAPTURE_DIR 启动，客户端以同样的环境变量刷新一次即可录制一台机器
+// 后台采集的耗时由 deepin-devicemanager-server-replay-bench 测量
+int main(int argc, char **argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication a(argc, argv);
+    QTextStream out(stdout);
+
+    int rounds = 5;
+    QStringList bundles;
+    QStringList args = a.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "-n" && i + 1 < args.size())
+            rounds = qMax(1, args[++i].toInt());
+        else
+            bundles << findBundles(args[i]);
+    }
+    if (bundles.isEmpty()) {
+        out << "usage: " << a.applicationName() << " [-n rounds] <bundle>...\n";
+        return 1;
+    }
+
+    out << QString("%1 %2 %3 %4\n").arg("generate", -40).arg("min(ms)", 10).arg("median", 10).arg("max", 10);
+    foreach (const QString &bundle, bundles) {
+        CollectorBundle::getInstance()->setReplayDir(bundle);
+
+        QVector<qint64> times;
+        for (int i = 0; i < rounds; ++i)
+            times.append(runOnce());
+        std::sort(times.begin(), times.end());
+
+        out << QString("%1 %2 %3 %4\n").arg(QDir(bundle).dirName(), -40)
+            .arg(times.first(), 10).arg(times[times.size() / 2], 10).arg(times.last(), 10);
+        out.flush();
+    }
+    return 0;
+}
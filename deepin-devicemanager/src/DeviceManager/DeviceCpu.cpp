@@ -190,6 +190,11 @@ void DeviceCpu::setCurFreq(const QString &curFreq)
         m_CurFrequency = curFreq;
 }
 
+const QString &DeviceCpu::physicalID() const
+{
+    return m_PhysicalID;
+}
+
 void DeviceCpu::setFrequencyIsCur(const bool &flag)
 {
     m_FrequencyIsCur = flag;
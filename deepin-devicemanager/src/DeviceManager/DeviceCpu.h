@@ -80,6 +80,12 @@ public:
      */
     void setCurFreq(const QString &curFreq);
 
+    /**
+     * @brief physicalID:处理器ID，即逻辑cpu编号
+     * @return
+     */
+    const QString &physicalID() const;
+
     /**
      * @brief setFrequencyIsCur:设置频率显示是当前还是最大值
      * @param flag:频率显示是当前还是最大值
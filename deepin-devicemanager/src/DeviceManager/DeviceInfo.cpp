@@ -505,6 +505,35 @@ const QString &DeviceBaseInfo::sysPath() const
     return m_SysPath;
 }
 
+const QString &DeviceBaseInfo::hwinfoToLshw() const
+{
+    return m_HwinfoToLshw;
+}
+
+QStringList DeviceBaseInfo::lshwJoinKeys(const QMap<QString, QString> &mapInfo)
+{
+    QStringList keys;
+    // 网卡设备与序列号匹配
+    QMap<QString, QString>::const_iterator serial = mapInfo.find("serial");
+    if (mapInfo.contains("logical name") && serial != mapInfo.end())
+        keys.append(serial.value());
+
+    QMap<QString, QString>::const_iterator busInfo = mapInfo.find("bus info");
+    if (busInfo == mapInfo.end())
+        return keys;
+
+    // 非usb设备，pci@0000:01:00.0 -> 0000:01:00.0
+    if (busInfo.value().startsWith("pci")) {
+        QStringList words = busInfo.value().split("@");
+        if (2 == words.size())
+            keys.append(words[1]);
+    }
+
+    // USB 设备
+    keys.append(busInfo.value());
+    return keys;
+}
+
 const QString DeviceBaseInfo::getVendorOrModelId(const QString &sysPath, bool flag)
 {
     // 从文件中获取制造商ID信息
@@ -600,30 +629,39 @@ void DeviceBaseInfo::addOtherDeviceInfo(const QString &key, const QString &value
         m_LstOtherInfo.insert(0, QPair<QString, QString>(key, value));
 }
 
-void DeviceBaseInfo::setAttribute(const QMap<QString, QString> &mapInfo, const QString &key, QString &variable, bool overwrite)
+/**
+ * @brief setAttributeValue : setAttribute 的公共部分
+ */
+static void setAttributeValue(const QString &value, QString &variable, bool overwrite)
 {
-    // map中存在该属性
-    if (mapInfo.find(key) == mapInfo.end())
-        return;
-
     // 属性值不能为空
-    if (mapInfo[key] == "")
+    if (value == "")
         return;
 
     // overwrite 为true直接覆盖
     if (overwrite) {
-        variable = mapInfo[key].trimmed();
+        variable = value.trimmed();
     } else {
 
         // overwrite 为false,如果当前属性值为空或unknown时可覆盖
         if (variable.isEmpty())
-            variable = mapInfo[key].trimmed();
+            variable = value.trimmed();
 
         if (variable.contains("Unknown", Qt::CaseInsensitive))
-            variable = mapInfo[key].trimmed();
+            variable = value.trimmed();
     }
 }
 
+void DeviceBaseInfo::setAttribute(const QMap<QString, QString> &mapInfo, const QString &key, QString &variable, bool overwrite)
+{
+    // map中存在该属性，只查找一次
+    QMap<QString, QString>::const_iterator it = mapInfo.find(key);
+    if (it == mapInfo.end())
+        return;
+
+    setAttributeValue(it.value(), variable, overwrite);
+}
+
 void DeviceBaseInfo::mapInfoToList()
 {
     // m_MapOtherInfo --> m_LstOtherInfo
@@ -677,29 +715,8 @@ void DeviceBaseInfo::setHwinfoLshwKey(const QMap<QString, QString> &mapInfo)
 
 bool DeviceBaseInfo::matchToLshw(const QMap<QString, QString> &mapInfo)
 {
-    // 网卡设备与序列号匹配上
-    if (mapInfo.find("logical name") != mapInfo.end() && mapInfo.find("serial") != mapInfo.end()) {
-        if (m_HwinfoToLshw == mapInfo["serial"]) {
-            return true;
-        }
-    }
-
-    if (mapInfo.find("bus info") == mapInfo.end()) {
-        return false;
-    }
-    // 非usb设备
-    if (mapInfo["bus info"].startsWith("pci")) {
-        QStringList words = mapInfo["bus info"].split("@");
-        if (2 == words.size() && words[1] == m_HwinfoToLshw) {
-            return true;
-        }
-    }
-
-    // USB 设备
-    if (m_HwinfoToLshw == mapInfo["bus info"]) {
-        return true;
-    }
-    return false;
+    // 网卡序列号、非usb设备的pci地址或usb设备的bus info匹配上
+    return lshwJoinKeys(mapInfo).contains(m_HwinfoToLshw);
 }
 
 void DeviceBaseInfo::setsysFStoHwinfoKey(const QMap<QString, QString> &mapInfo)
@@ -176,6 +176,20 @@ public:
      */
     const QString &sysPath() const;
 
+    /**
+     * @brief hwinfoToLshw : 与lshw匹配的key，hwinfo信息设置后确定
+     * @return
+     */
+    const QString &hwinfoToLshw() const;
+
+    /**
+     * @brief lshwJoinKeys : lshw记录中可与 hwinfoToLshw() 相等的值(serial、pci总线地址、bus info)
+     * 每条记录只计算一次，按key查找设备代替逐个调用 matchToLshw
+     * @param mapInfo : lshw 记录
+     * @return matchToLshw 返回 true 当且仅当 hwinfoToLshw() 在其中
+     */
+    static QStringList lshwJoinKeys(const QMap<QString, QString> &mapInfo);
+
     /**
      * @brief getVendorOrModelId:获取Vendor 或 Model Id
      * @param sysPath 属性sysFS ID
@@ -9,6 +9,7 @@
 #include <QDebug>
 #include <QFile>
 #include <QMutexLocker>
+#include <QVarLengthArray>
 
 // 其它头文件
 #include "DeviceCpu.h"
@@ -33,12 +34,58 @@
 DeviceManager    *DeviceManager::sInstance = nullptr;
 int DeviceManager::m_CurrentXlsRow = 1;
 
-QMutex addCmdMutex;
+/**
+ * @brief storageFileKey : 存储设备文件名，/dev/sda -> sda
+ */
+static QString storageFileKey(const DeviceBaseInfo *device)
+{
+    const DeviceStorage *storage = dynamic_cast<const DeviceStorage *>(device);
+    return storage ? storage->deviceFile().section('/', -1) : QString();
+}
 
-DeviceManager::DeviceManager()
-    : m_CpuNum(1)
+/**
+ * @brief storageBusKey : 存储设备与lshw匹配的总线ID
+ */
+static QString storageBusKey(const DeviceBaseInfo *device)
+{
+    const DeviceStorage *storage = dynamic_cast<const DeviceStorage *>(device);
+    return storage ? storage->keyToLshw() : QString();
+}
+
+/**
+ * @brief storageLogicalKey : 存储设备标识符，用于排除其他设备中的存储设备
+ */
+static QString storageLogicalKey(const DeviceBaseInfo *device)
 {
+    const DeviceStorage *storage = dynamic_cast<const DeviceStorage *>(device);
+    return storage ? storage->keyFromStorage() : QString();
+}
+
+static QString othersBusKey(const DeviceBaseInfo *device)
+{
+    const DeviceOthers *others = dynamic_cast<const DeviceOthers *>(device);
+    return others ? others->busInfo() : QString();
+}
 
+/**
+ * @brief audioUniqueKey : 音频设备 1.1:1.1 -> 1.1:1.0
+ */
+static QString audioUniqueKey(const DeviceBaseInfo *device)
+{
+    QString uniqueID = device->uniqueID();
+    return uniqueID.replace(QRegExp("[1-9]$"), "0");
+}
+
+DeviceManager::DeviceManager()
+    : m_CmdSlots(nullptr)
+    , m_CpuNum(1)
+{
+    // 各类设备合并多个来源的信息时使用的索引
+    m_ShardStorage.setIndexKey(DeviceShard::DeviceFile, storageFileKey);
+    m_ShardStorage.setIndexKey(DeviceShard::BusID, storageBusKey);
+    m_ShardStorage.setIndexKey(DeviceShard::LogicalName, storageLogicalKey);
+    m_ShardOthers.setIndexKey(DeviceShard::BusID, othersBusKey);
+    m_ShardAudio.setIndexKey(DeviceShard::UniqueID, audioUniqueKey);
 }
 
 DeviceManager::~DeviceManager()
@@ -49,7 +96,7 @@ DeviceManager::~DeviceManager()
 void DeviceManager::clear()
 {
     // 清除所有命令
-    m_cmdInfo.clear();
+    clearCmdInfo();
 
     // 清除内存中的所有设备指针
     foreach (auto device, m_ListDeviceMouse)
@@ -125,6 +172,29 @@ void DeviceManager::clear()
     m_ListDeviceGPU.clear();
     m_ListDeviceMemory.clear();
     m_ListDeviceCPU.clear();
+    resetShards();
+}
+
+void DeviceManager::resetShards()
+{
+    m_ShardMouse.reset();
+    m_ShardCPU.reset();
+    m_ShardStorage.reset();
+    m_ShardGPU.reset();
+    m_ShardMemory.reset();
+    m_ShardMonitor.reset();
+    m_ShardBios.reset();
+    m_ShardBluetooth.reset();
+    m_ShardAudio.reset();
+    m_ShardNetwork.reset();
+    m_ShardImage.reset();
+    m_ShardKeyboard.reset();
+    m_ShardOthers.reset();
+    m_ShardPower.reset();
+    m_ShardPrint.reset();
+    m_ShardOtherPCI.reset();
+    m_ShardComputer.reset();
+    m_ShardCdrom.reset();
 }
 
 const QList<QPair<QString, QString>> &DeviceManager::getDeviceTypes()
@@ -296,7 +366,7 @@ DeviceBaseInfo *DeviceManager::getBluetoothAtIndex(int index)
 void DeviceManager::addMouseDevice(DeviceInput *const device)
 {
     // 如果不是重复设备则添加到设备列表
-    m_ListDeviceMouse.append(device);
+    m_ShardMouse.append(device);
 }
 
 DeviceBaseInfo *DeviceManager::getMouseDevice(const QString &unique_id)
@@ -304,21 +374,16 @@ DeviceBaseInfo *DeviceManager::getMouseDevice(const QString &unique_id)
     if (unique_id.isEmpty()) {
         return nullptr;
     }
-    for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceMouse.begin(); it != m_ListDeviceMouse.end(); ++it) {
-        DeviceInput *mouse = dynamic_cast<DeviceInput *>(*it);
-        if (mouse && mouse->uniqueID() == unique_id) {
-            return *it;
-        }
-    }
-    return nullptr;
+    return m_ShardMouse.find(DeviceShard::UniqueID, unique_id);
 }
 
 bool DeviceManager::addMouseInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw中添加鼠标信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceMouse.begin();
-    for (; it != m_ListDeviceMouse.end(); ++it) {
-        DeviceInput *device = dynamic_cast<DeviceInput *>(*it);
+    QMutexLocker locker(m_ShardMouse.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardMouse.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceInput *device = dynamic_cast<DeviceInput *>(info);
         if (!device)
             continue;
 
@@ -331,31 +396,44 @@ bool DeviceManager::addMouseInfoFromLshw(const QMap<QString, QString> &mapInfo)
 void DeviceManager::addCpuDevice(DeviceCpu *const device)
 {
     // 添加CPU设备
-    m_ListDeviceCPU.append(device);
+    m_ShardCPU.append(device);
 }
 
 void DeviceManager::addStorageDeivce(DeviceStorage *const device)
 {
-    m_ListDeviceStorage.append(device);
+    m_ShardStorage.append(device);
 }
 
 void DeviceManager::addLshwinfoIntoStorageDevice(const QMap<QString, QString> &mapInfo)
 {
-    // 从lshw中添加存储设备信息
+    // 从lshw中添加存储设备信息，bus info: scsi@0:0.0.0 与 hwinfo 的 SysFS BusID 0:0:0:0 匹配
+    QStringList keys = mapInfo["bus info"].split("@");
+    if (keys.size() != 2)
+        return;
+
+    QString key = keys[1].trimmed();
+    key.replace(".", ":");
+
+    QMutexLocker locker(m_ShardStorage.mutex());
+    DeviceStorage *device = dynamic_cast<DeviceStorage *>(m_ShardStorage.find(DeviceShard::BusID, key));
+    if (device && device->addInfoFromlshw(mapInfo))
+        return;
+
+    // 索引未命中时按顺序匹配，与索引建立前的结果一致
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceStorage.begin();
     for (; it != m_ListDeviceStorage.end(); ++it) {
-        DeviceStorage *device = dynamic_cast<DeviceStorage *>(*it);
-        if (!device)
-            continue;
-
-        if (device->addInfoFromlshw(mapInfo))
+        device = dynamic_cast<DeviceStorage *>(*it);
+        if (device && device->addInfoFromlshw(mapInfo)) {
+            m_ShardStorage.update(device);
             return;
+        }
     }
 }
 
 void DeviceManager::addLshwinfoIntoNVMEStorageDevice(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw中添加NVME存储设备信息
+    QMutexLocker locker(m_ShardStorage.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceStorage.begin();
     for (; it != m_ListDeviceStorage.end(); ++it) {
         DeviceStorage *device = dynamic_cast<DeviceStorage *>(*it);
@@ -370,6 +448,12 @@ void DeviceManager::addLshwinfoIntoNVMEStorageDevice(const QMap<QString, QString
 void DeviceManager::setStorageInfoFromSmartctl(const QString &name, const QMap<QString, QString> &mapInfo)
 {
     // // 从smartctl中添加存储设备信息
+    QMutexLocker locker(m_ShardStorage.mutex());
+    DeviceStorage *storage = dynamic_cast<DeviceStorage *>(m_ShardStorage.find(DeviceShard::DeviceFile, name));
+    if (storage && storage->addInfoFromSmartctl(name, mapInfo))
+        return;
+
+    // 设备文件名不完全相同时按包含关系查找
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceStorage.begin();
     for (; it != m_ListDeviceStorage.end(); ++it) {
         DeviceStorage *device = dynamic_cast<DeviceStorage *>(*it);
@@ -384,6 +468,7 @@ void DeviceManager::setStorageInfoFromSmartctl(const QString &name, const QMap<Q
 void DeviceManager::mergeDisk()
 {
     QMap<QString, QList<int> > allSerialIDs;
+    QMutexLocker locker(m_ShardStorage.mutex());
     for (int i = 0; i < m_ListDeviceStorage.size(); ++i) {
         DeviceStorage *device = dynamic_cast<DeviceStorage *>(m_ListDeviceStorage[i]);
         if (!device->getDiskSerialID().isEmpty()) {
@@ -405,6 +490,7 @@ void DeviceManager::mergeDisk()
 
 void DeviceManager::checkDiskSize()
 {
+    QMutexLocker locker(m_ShardStorage.mutex());
     for (int i = 0; i < m_ListDeviceStorage.size(); ++i) {
         DeviceStorage *device = dynamic_cast<DeviceStorage *>(m_ListDeviceStorage[i]);
         device->checkDiskSize();
@@ -414,6 +500,12 @@ void DeviceManager::checkDiskSize()
 bool DeviceManager::setStorageDeviceMediaType(const QString &name, const QString &value)
 {
     // 设置存储设备介质类型
+    QMutexLocker locker(m_ShardStorage.mutex());
+    DeviceStorage *storage = dynamic_cast<DeviceStorage *>(m_ShardStorage.find(DeviceShard::DeviceFile, name));
+    if (storage && storage->setMediaType(name, value))
+        return true;
+
+    // 设备文件名不完全相同时按包含关系查找
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceStorage.begin();
     for (; it != m_ListDeviceStorage.end(); ++it) {
         DeviceStorage *device = dynamic_cast<DeviceStorage *>(*it);
@@ -431,6 +523,12 @@ bool DeviceManager::setStorageDeviceMediaType(const QString &name, const QString
 bool DeviceManager::setKLUStorageDeviceMediaType(const QString &name, const QString &value)
 {
     // 设置KLU机器存储设备介质类型
+    QMutexLocker locker(m_ShardStorage.mutex());
+    DeviceStorage *storage = dynamic_cast<DeviceStorage *>(m_ShardStorage.find(DeviceShard::DeviceFile, name));
+    if (storage && storage->setKLUMediaType(name, value))
+        return true;
+
+    // 设备文件名不完全相同时按包含关系查找
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceStorage.begin();
     for (; it != m_ListDeviceStorage.end(); ++it) {
         DeviceStorage *device = dynamic_cast<DeviceStorage *>(*it);
@@ -448,15 +546,16 @@ bool DeviceManager::setKLUStorageDeviceMediaType(const QString &name, const QStr
 void DeviceManager::addGpuDevice(DeviceGpu *const device)
 {
     // 添加显示适配器
-    m_ListDeviceGPU.append(device);
+    m_ShardGPU.append(device);
 }
 
 void DeviceManager::setGpuInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw中添加显示适配器信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceGPU.begin();
-    for (; it != m_ListDeviceGPU.end(); ++it) {
-        DeviceGpu *device = dynamic_cast<DeviceGpu *>(*it);
+    QMutexLocker locker(m_ShardGPU.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardGPU.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceGpu *device = dynamic_cast<DeviceGpu *>(info);
         if (!device)
             continue;
 
@@ -467,6 +566,7 @@ void DeviceManager::setGpuInfoFromLshw(const QMap<QString, QString> &mapInfo)
 void DeviceManager::setGpuInfoFromXrandr(const QMap<QString, QString> &mapInfo)
 {
     // 从xrandr中添加显示适配器信息
+    QMutexLocker locker(m_ShardGPU.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceGPU.begin();
     for (; it != m_ListDeviceGPU.end(); ++it) {
         DeviceGpu *device = dynamic_cast<DeviceGpu *>(*it);
@@ -480,6 +580,7 @@ void DeviceManager::setGpuInfoFromXrandr(const QMap<QString, QString> &mapInfo)
 void DeviceManager::setGpuSizeFromDmesg(const QMap<QString, QString> &mapInfo)
 {
     // 从dmesg中设置显卡大小
+    QMutexLocker locker(m_ShardGPU.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceGPU.begin();
     for (; it != m_ListDeviceGPU.end(); ++it) {
         DeviceGpu *device = dynamic_cast<DeviceGpu *>(*it);
@@ -493,12 +594,13 @@ void DeviceManager::setGpuSizeFromDmesg(const QMap<QString, QString> &mapInfo)
 void DeviceManager::addMemoryDevice(DeviceMemory *const device)
 {
     // 添加内存
-    m_ListDeviceMemory.append(device);
+    m_ShardMemory.append(device);
 }
 
 void DeviceManager::setMemoryInfoFromDmidecode(const QMap<QString, QString> &mapInfo)
 {
     // 从dmidecode中添加内存信息
+    QMutexLocker locker(m_ShardMemory.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceMemory.begin();
     for (; it != m_ListDeviceMemory.end(); ++it) {
         DeviceMemory *device = dynamic_cast<DeviceMemory *>(*it);
@@ -513,12 +615,13 @@ void DeviceManager::setMemoryInfoFromDmidecode(const QMap<QString, QString> &map
 void DeviceManager::addMonitor(DeviceMonitor *const device)
 {
     // 添加显示设备
-    m_ListDeviceMonitor.append(device);
+    m_ShardMonitor.append(device);
 }
 
 void DeviceManager::setMonitorInfoFromXrandr(const QString &main, const QString &edid, const QString &rate)
 {
     // 从xrandr中添加显示设备信息
+    QMutexLocker locker(m_ShardMonitor.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceMonitor.begin();
     for (; it != m_ListDeviceMonitor.end(); ++it) {
         DeviceMonitor *device = dynamic_cast<DeviceMonitor *>(*it);
@@ -533,12 +636,13 @@ void DeviceManager::setMonitorInfoFromXrandr(const QString &main, const QString
 void DeviceManager::addBiosDevice(DeviceBios *const device)
 {
     // 添加主板信息
-    m_ListDeviceBios.append(device);
+    m_ShardBios.append(device);
 }
 
 void DeviceManager::setLanguageInfo(const QMap<QString, QString> &mapInfo)
 {
     // 设置语言信息
+    QMutexLocker locker(m_ShardBios.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceBios.begin();
     for (; it != m_ListDeviceBios.end(); ++it) {
         DeviceBios *device = dynamic_cast<DeviceBios *>(*it);
@@ -552,15 +656,16 @@ void DeviceManager::setLanguageInfo(const QMap<QString, QString> &mapInfo)
 
 void DeviceManager::addBluetoothDevice(DeviceBluetooth *const device)
 {
-    m_ListDeviceBluetooth.append(device);
+    m_ShardBluetooth.append(device);
 }
 
 void DeviceManager::setBluetoothInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw中获取蓝牙信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceBluetooth.begin();
-    for (; it != m_ListDeviceBluetooth.end(); ++it) {
-        DeviceBluetooth *device = dynamic_cast<DeviceBluetooth *>(*it);
+    QMutexLocker locker(m_ShardBluetooth.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardBluetooth.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceBluetooth *device = dynamic_cast<DeviceBluetooth *>(info);
         if (!device)
             continue;
 
@@ -572,20 +677,24 @@ void DeviceManager::setBluetoothInfoFromLshw(const QMap<QString, QString> &mapIn
 bool DeviceManager::setBluetoothInfoFromHwinfo(const QMap<QString, QString> &mapInfo)
 {
     // 从hwinfo中获取蓝牙信息
+    QMutexLocker locker(m_ShardBluetooth.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceBluetooth.begin();
     for (; it != m_ListDeviceBluetooth.end(); ++it) {
         DeviceBluetooth *device = dynamic_cast<DeviceBluetooth *>(*it);
         if (!device)
             continue;
 
-        if (device->setInfoFromHwinfo(mapInfo))
+        if (device->setInfoFromHwinfo(mapInfo)) {
+            m_ShardBluetooth.update(device);
             return true;
+        }
     }
     return false;
 }
 
 bool DeviceManager::setBluetoothInfoFromWifiInfo(const QMap<QString, QString> &mapInfo)
 {
+    QMutexLocker locker(m_ShardBluetooth.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceBluetooth.begin();
     for (; it != m_ListDeviceBluetooth.end(); ++it) {
         DeviceBluetooth *device = dynamic_cast<DeviceBluetooth *>(*it);
@@ -598,22 +707,17 @@ bool DeviceManager::setBluetoothInfoFromWifiInfo(const QMap<QString, QString> &m
 
 DeviceBaseInfo *DeviceManager::getBluetoothDevice(const QString &unique_id)
 {
-    for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceBluetooth.begin(); it != m_ListDeviceBluetooth.end(); ++it) {
-        DeviceBluetooth *bt = dynamic_cast<DeviceBluetooth *>(*it);
-        if (bt && bt->uniqueID() == unique_id) {
-            return *it;
-        }
-    }
-    return nullptr;
+    return m_ShardBluetooth.find(DeviceShard::UniqueID, unique_id);
 }
 
 void DeviceManager::addAudioDevice(DeviceAudio *const device)
 {
-    m_ListDeviceAudio.append(device);
+    m_ShardAudio.append(device);
 }
 
 void DeviceManager::deleteDisableDuplicate_AudioDevice(void)
 {
+    QMutexLocker locker(m_ShardAudio.mutex());
     if (m_ListDeviceAudio.size() > 0) {
         for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceAudio.begin(); it != m_ListDeviceAudio.end(); ++it) {
             DeviceAudio *audio_1 = dynamic_cast<DeviceAudio *>(*it);
@@ -634,27 +738,17 @@ void DeviceManager::deleteDisableDuplicate_AudioDevice(void)
 
 DeviceBaseInfo *DeviceManager::getAudioDevice(const QString &path)
 {
-    for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceAudio.begin(); it != m_ListDeviceAudio.end(); ++it) {
-        DeviceAudio *audio = dynamic_cast<DeviceAudio *>(*it);
-        QString tpath = audio->uniqueID();
-        // 判断该设备是否已经存在，1.1:1.1 -> 1.1:1.0
-        if (audio && path == tpath.replace(QRegExp("[1-9]$"), "0")) {
-            return *it;
-        }
-         QString syspath = audio->sysPath();   //remove dumplicate syspath
-         if (audio && path == syspath) {
-             return *it;
-         }
-    }
-    return nullptr;
+    // 判断该设备是否已经存在，1.1:1.1 -> 1.1:1.0，或者 sys path 相同
+    return m_ShardAudio.find(DeviceShard::UniqueID, path, DeviceShard::SysPath, path);
 }
 
 void DeviceManager::setAudioInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw中获取音频适配器信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceAudio.begin();
-    for (; it != m_ListDeviceAudio.end(); ++it) {
-        DeviceAudio *device = dynamic_cast<DeviceAudio *>(*it);
+    QMutexLocker locker(m_ShardAudio.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardAudio.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceAudio *device = dynamic_cast<DeviceAudio *>(info);
         if (!device)
             continue;
 
@@ -666,6 +760,7 @@ void DeviceManager::setAudioInfoFromLshw(const QMap<QString, QString> &mapInfo)
 void DeviceManager::setAudioChipFromDmesg(const QString &info)
 {
     // 从dmesg中获取声卡芯片型号
+    QMutexLocker locker(m_ShardAudio.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceAudio.begin();
     for (; it != m_ListDeviceAudio.end(); ++it) {
         DeviceAudio *device = dynamic_cast<DeviceAudio *>(*it);
@@ -679,11 +774,12 @@ void DeviceManager::setAudioChipFromDmesg(const QString &info)
 void DeviceManager::addNetworkDevice(DeviceNetwork *const device)
 {
     // 添加网络适配器
-    m_ListDeviceNetwork.append(device);
+    m_ShardNetwork.append(device);
 }
 
 bool DeviceManager::setNetworkInfoFromWifiInfo(const QMap<QString, QString> &mapInfo)
 {
+    QMutexLocker locker(m_ShardNetwork.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceNetwork.begin();
     for (; it != m_ListDeviceNetwork.end(); ++it) {
 
@@ -700,17 +796,14 @@ bool DeviceManager::setNetworkInfoFromWifiInfo(const QMap<QString, QString> &map
 
 DeviceBaseInfo *DeviceManager::getNetworkDevice(const QString &unique_id)
 {
-    for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceNetwork.begin(); it != m_ListDeviceNetwork.end(); ++it) {
-        DeviceNetwork *net = dynamic_cast<DeviceNetwork *>(*it);
-        if (!unique_id.isEmpty() && net && net->uniqueID() == unique_id) {
-            return *it;
-        }
-    }
-    return nullptr;
+    if (unique_id.isEmpty())
+        return nullptr;
+    return m_ShardNetwork.find(DeviceShard::UniqueID, unique_id);
 }
 
 void DeviceManager::correctNetworkLinkStatus(QString linkStatus, QString networkDriver)
 {
+    QMutexLocker locker(m_ShardNetwork.mutex());
     if (m_ListDeviceNetwork.size() == 0)
         return;
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceNetwork.begin();
@@ -726,6 +819,7 @@ void DeviceManager::correctNetworkLinkStatus(QString linkStatus, QString network
 QStringList DeviceManager::networkDriver()
 {
     m_networkDriver.clear();
+    QMutexLocker locker(m_ShardNetwork.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceNetwork.begin();
     for (; it != m_ListDeviceNetwork.end(); ++it) {
         DeviceNetwork *device = dynamic_cast<DeviceNetwork *>(*it);
@@ -739,6 +833,7 @@ QStringList DeviceManager::networkDriver()
 
 void DeviceManager::correctPowerInfo(const QMap<QString, QMap<QString, QString>> &mapInfo)
 {
+    QMutexLocker locker(m_ShardPower.mutex());
     if (m_ListDevicePower.size() == 0)
         return;
     QList<DeviceBaseInfo *>::iterator it = m_ListDevicePower.begin();
@@ -756,26 +851,21 @@ void DeviceManager::correctPowerInfo(const QMap<QString, QMap<QString, QString>>
 void DeviceManager::addImageDevice(DeviceImage *const device)
 {
     // 添加图像设备
-    m_ListDeviceImage.append(device);
+    m_ShardImage.append(device);
 }
 
 DeviceBaseInfo *DeviceManager::getImageDevice(const QString &unique_id)
 {
-    for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceImage.begin(); it != m_ListDeviceImage.end(); ++it) {
-        DeviceImage *image = dynamic_cast<DeviceImage *>(*it);
-        if (image && image->uniqueID() == unique_id) {
-            return *it;
-        }
-    }
-    return nullptr;
+    return m_ShardImage.find(DeviceShard::UniqueID, unique_id);
 }
 
 void DeviceManager::setCameraInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw获取图像设备信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceImage.begin();
-    for (; it != m_ListDeviceImage.end(); ++it) {
-        DeviceImage *device = dynamic_cast<DeviceImage *>(*it);
+    QMutexLocker locker(m_ShardImage.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardImage.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceImage *device = dynamic_cast<DeviceImage *>(info);
         if (!device)
             continue;
 
@@ -786,15 +876,16 @@ void DeviceManager::setCameraInfoFromLshw(const QMap<QString, QString> &mapInfo)
 void DeviceManager::addKeyboardDevice(DeviceInput *const device)
 {
     // 添加键盘
-    m_ListDeviceKeyboard.append(device);
+    m_ShardKeyboard.append(device);
 }
 
 void DeviceManager::setKeyboardInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw获取键盘信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceKeyboard.begin();
-    for (; it != m_ListDeviceKeyboard.end(); ++it) {
-        DeviceInput *device = dynamic_cast<DeviceInput *>(*it);
+    QMutexLocker locker(m_ShardKeyboard.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardKeyboard.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceInput *device = dynamic_cast<DeviceInput *>(info);
         if (!device)
             continue;
 
@@ -805,23 +896,12 @@ void DeviceManager::setKeyboardInfoFromLshw(const QMap<QString, QString> &mapInf
 
 void DeviceManager::addOthersDevice(DeviceOthers *const device)
 {
-    // 添加其他设备
-    bool isOtherDevice = true;
-    foreach (auto disk, m_ListDeviceStorage) {
-        DeviceStorage *deviceDisk = dynamic_cast<DeviceStorage *>(disk);
-        if (!deviceDisk)
-            continue;
-
-        // 排除存储设备
-        if (deviceDisk->keyFromStorage() == device->logicalName() && device->logicalName() != "") {
-            isOtherDevice = false;
-            break;
-        }
-    }
+    // 排除存储设备
+    if (device->logicalName() != "" && m_ShardStorage.find(DeviceShard::LogicalName, device->logicalName()))
+        return;
 
     // 添加其他设备
-    if (isOtherDevice)
-        m_ListDeviceOthers.append(device);
+    m_ShardOthers.append(device);
 }
 
 DeviceBaseInfo *DeviceManager::getOthersDevice(const QString &unique_id)
@@ -829,35 +909,25 @@ DeviceBaseInfo *DeviceManager::getOthersDevice(const QString &unique_id)
     if (unique_id.isEmpty()) {
         return nullptr;
     }
-    for (QList<DeviceBaseInfo *>::iterator it = m_ListDeviceOthers.begin(); it != m_ListDeviceOthers.end(); ++it) {
-        DeviceOthers *other = dynamic_cast<DeviceOthers *>(*it);
-        if (other && other->uniqueID() == unique_id) {
-            return *it;
-        }
-    }
-    return nullptr;
+    return m_ShardOthers.find(DeviceShard::UniqueID, unique_id);
 }
 
 void DeviceManager::addOthersDeviceFromHwinfo(DeviceOthers *const device)
 {
-    // 从hwinfo中获取其他设备信息
-    foreach (auto cur, m_ListDeviceOthers) {
-        DeviceOthers *deviceOthers = dynamic_cast<DeviceOthers *>(cur);
-        if (!deviceOthers)
-            continue;
-
-        if (deviceOthers->busInfo() == device->busInfo() && deviceOthers->busInfo() != "")
-            return;
-    }
-    m_ListDeviceOthers.append(device);
+    // 从hwinfo中获取其他设备信息，总线ID相同的设备已经存在
+    QMutexLocker locker(m_ShardOthers.mutex());
+    if (device->busInfo() != "" && m_ShardOthers.find(DeviceShard::BusID, device->busInfo()))
+        return;
+    m_ShardOthers.append(device);
 }
 
 void DeviceManager::setOthersDeviceInfoFromLshw(const QMap<QString, QString> &mapInfo)
 {
     //从lshw中获取其他设备信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceOthers.begin();
-    for (; it != m_ListDeviceOthers.end(); ++it) {
-        DeviceOthers *device = dynamic_cast<DeviceOthers *>(*it);
+    QMutexLocker locker(m_ShardOthers.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardOthers.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceOthers *device = dynamic_cast<DeviceOthers *>(info);
         if (!device)
             continue;
 
@@ -867,6 +937,7 @@ void DeviceManager::setOthersDeviceInfoFromLshw(const QMap<QString, QString> &ma
 
 void DeviceManager::setCpuRefreshInfoFromlscpu(const QMap<QString, QString> &mapInfo)
 {
+    QMutexLocker locker(m_ShardCPU.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceCPU.begin();
     for (; it != m_ListDeviceCPU.end(); ++it) {
         DeviceCpu *device = dynamic_cast<DeviceCpu *>(*it);
@@ -877,42 +948,59 @@ void DeviceManager::setCpuRefreshInfoFromlscpu(const QMap<QString, QString> &map
     }
 }
 
+void DeviceManager::setCpuCurFreq(const QMap<int, uint> &mapFreq)
+{
+    QMutexLocker locker(m_ShardCPU.mutex());
+    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceCPU.begin();
+    for (; it != m_ListDeviceCPU.end(); ++it) {
+        DeviceCpu *device = dynamic_cast<DeviceCpu *>(*it);
+        if (!device)
+            continue;
+
+        bool ok = false;
+        int cpu = device->physicalID().toInt(&ok);
+        if (ok && mapFreq.contains(cpu))
+            device->setCurFreq(QString::number(mapFreq[cpu] / 1000) + "MHz");
+    }
+}
+
 void DeviceManager::addPowerDevice(DevicePower *const device)
 {
     // 添加电池设备
-    m_ListDevicePower.append(device);
+    m_ShardPower.append(device);
 }
 
 void DeviceManager::addPrintDevice(DevicePrint *const device)
 {
     // 添加打印机信息
-    m_ListDevicePrint.append(device);
+    m_ShardPrint.append(device);
 }
 
 void DeviceManager::addOtherPCIDevice(DeviceOtherPCI *const device)
 {
     // 添加其他PCI设备
-    m_ListDeviceOtherPCI.append(device);
+    m_ShardOtherPCI.append(device);
 }
 
 void DeviceManager::addComputerDevice(DeviceComputer *const device)
 {
     // 添加计算机设备
-    m_ListDeviceComputer.append(device);
+    m_ShardComputer.append(device);
 }
 
 void DeviceManager::addCdromDevice(DeviceCdrom *const device)
 {
     // 添加CDROM
-    m_ListDeviceCdrom.append(device);
+    m_ShardCdrom.append(device);
 }
 
 void DeviceManager::addLshwinfoIntoCdromDevice(const QMap<QString, QString> &mapInfo)
 {
     // 从lshw中添加CDROM信息
-    QList<DeviceBaseInfo *>::iterator it = m_ListDeviceCdrom.begin();
-    for (; it != m_ListDeviceCdrom.end(); ++it) {
-        DeviceCdrom *device = dynamic_cast<DeviceCdrom *>(*it);
+    QMutexLocker locker(m_ShardCdrom.mutex());
+    const QList<DeviceBaseInfo *> &lstDevice = m_ShardCdrom.findAll(DeviceShard::HwinfoToLshw, DeviceBaseInfo::lshwJoinKeys(mapInfo));
+    foreach (DeviceBaseInfo *info, lstDevice) {
+        DeviceCdrom *device = dynamic_cast<DeviceCdrom *>(info);
         if (!device)
             continue;
 
@@ -923,7 +1011,10 @@ void DeviceManager::addLshwinfoIntoCdromDevice(const QMap<QString, QString> &map
 void DeviceManager::addBusId(const QStringList &busId)
 {
     // 添加设备总线信息
+    QMutexLocker locker(&m_BusIdMutex);
     m_BusIdList.append(busId);
+    foreach (const QString &id, busId)
+        m_BusIdSet.insert(id);
 }
 
 const QStringList &DeviceManager::getBusId()
@@ -931,22 +1022,74 @@ const QStringList &DeviceManager::getBusId()
     return m_BusIdList;
 }
 
-void DeviceManager::addCmdInfo(const QMap<QString, QList<QMap<QString, QString> > > &cmdInfo)
+bool DeviceManager::containsBusId(const QString &busId)
+{
+    QMutexLocker locker(&m_BusIdMutex);
+    return m_BusIdSet.contains(busId);
+}
+
+void DeviceManager::addCmdInfo(QMap<QString, QList<QMap<QString, QString> > > cmdInfo)
+{
+    if (cmdInfo.isEmpty())
+        return;
+
+    // 在发布之前把该任务的槽串成一条链，属性名驻留为id后以记录保存
+    CmdSlot *first = nullptr;
+    CmdSlot *last = nullptr;
+    for (auto it = cmdInfo.cbegin(); it != cmdInfo.cend(); ++it) {
+        CmdSlot *slot = new CmdSlot;
+        slot->keyId = CmdRecord::keyId(it.key());
+        slot->records = CmdRecord::fromList(it.value());
+        slot->next = first;
+        first = slot;
+        if (!last)
+            last = slot;
+    }
+
+    // 整条链一次发布，发布后其他线程只读
+    CmdSlot *head = m_CmdSlots.loadAcquire();
+    do {
+        last->next = head;
+    } while (!m_CmdSlots.testAndSetOrdered(head, first, head));
+}
+
+void DeviceManager::clearCmdInfo()
 {
-    QMutexLocker locker(&addCmdMutex);
-    // 添加命令信息
-    foreach (const QString &key, cmdInfo.keys()) {
-        if (m_cmdInfo.find(key) == m_cmdInfo.end())
-            m_cmdInfo.insert(key, cmdInfo[key]);
-        else
-            m_cmdInfo[key].append(cmdInfo[key]);
+    // 此时没有任务在发布，也没有生成器在读取
+    CmdSlot *slot = m_CmdSlots.fetchAndStoreOrdered(nullptr);
+    while (slot) {
+        CmdSlot *next = slot->next;
+        delete slot;
+        slot = next;
     }
 }
 
-const QList<QMap<QString, QString>> &DeviceManager::cmdInfo(const QString &key)
+QList<QMap<QString, QString>> DeviceManager::cmdInfo(const QString &key)
 {
-    QMutexLocker locker(&addCmdMutex);
-    return m_cmdInfo[key];
+    return CmdRecord::toList(cmdRecords(key));
+}
+
+QList<CmdRecord> DeviceManager::cmdRecords(const QString &key)
+{
+    int keyId = CmdRecord::findKeyId(key);
+    if (keyId < 0)
+        return QList<CmdRecord>();
+
+    // 槽发布后不再修改，读取不加锁；槽按发布的倒序连接，结果按发布顺序拼接
+    QVarLengthArray<const CmdSlot *, 4> lstSlot;
+    for (const CmdSlot *slot = m_CmdSlots.loadAcquire(); slot; slot = slot->next) {
+        if (slot->keyId == keyId)
+            lstSlot.append(slot);
+    }
+
+    // 只有一个任务产生该key时直接共享
+    if (1 == lstSlot.size())
+        return lstSlot[0]->records;
+
+    QList<CmdRecord> records;
+    for (int i = lstSlot.size() - 1; i >= 0; --i)
+        records.append(lstSlot[i]->records);
+    return records;
 }
 
 bool DeviceManager::exportToTxt(const QString &filePath)
@@ -1343,6 +1486,7 @@ void DeviceManager::setCpuNum(int num)
 
 void DeviceManager::setCpuFrequencyIsCur(const bool &flag)
 {
+    QMutexLocker locker(m_ShardCPU.mutex());
     QList<DeviceBaseInfo *>::iterator it = m_ListDeviceCPU.begin();
     for (; it != m_ListDeviceCPU.end(); ++it) {
         DeviceCpu *device = dynamic_cast<DeviceCpu *>(*it);
@@ -8,10 +8,14 @@
 
 #include "document.h"
 #include "xlsxdocument.h"
+#include "CmdRecord.h"
+#include "DeviceShard.h"
 
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QMutex>
+#include <QAtomicPointer>
 #include <QDomDocument>
 #include <QObject>
 #include <QFile>
@@ -42,6 +46,15 @@ class DeviceBaseInfo;
  * 设备的管理类(包括设备的获取、增加、修改)
  */
 
+/**
+ * @brief The CmdSlot struct : 一个命令key解析出的全部记录，发布之后只读
+ */
+struct CmdSlot {
+    int                 keyId;      //<! 命令key驻留后的id
+    QList<CmdRecord>    records;    //<! 解析出的记录
+    CmdSlot            *next;       //<! 之前发布的槽
+};
+
 class DeviceManager : public QObject
 {
     Q_OBJECT
@@ -397,6 +410,12 @@ public:
 
     void setCpuRefreshInfoFromlscpu(const QMap<QString, QString> &mapInfo);
 
+    /**
+     * @brief setCpuCurFreq:设置各个逻辑cpu的当前频率
+     * @param mapFreq:逻辑cpu -> 频率 kHz
+     */
+    void setCpuCurFreq(const QMap<int, uint> &mapFreq);
+
     // 电源设备相关
     /**
      * @brief addPowerDevice:添加电池设备
@@ -451,18 +470,34 @@ public:
      */
     const QStringList &getBusId();
 
+    /**
+     * @brief containsBusId: 总线ID是否已被其他类别的设备使用
+     * @param busId:总线ID
+     * @return 是否存在
+     */
+    bool containsBusId(const QString &busId);
+
     /**
      * @brief addCmdInfo:添加命令以及由命令获取的信息解析出的map list
-     * @param cmdInfo:命令以及由命令获取的信息解析出的map list
+     * 每个key转为一个只读的槽，一个任务的所有槽一次发布，之后读取不加锁
+     * @param cmdInfo:命令以及由命令获取的信息解析出的map list，调用方应 std::move 交出
      */
-    void addCmdInfo(const QMap<QString, QList<QMap<QString, QString> > > &cmdInfo);
+    void addCmdInfo(QMap<QString, QList<QMap<QString, QString> > > cmdInfo);
 
     /**
-     * @brief cmdInfo:获取命令key对相应的信息map组成的List
+     * @brief cmdInfo:获取命令key对相应的信息map组成的List，供仍使用map的生成器代码
+     * 每个槽只在第一次获取时由记录还原一次，之后返回隐式共享的结果
      * @param key:命令值
      * @return 信息map组成的信息List
      */
-    const QList<QMap<QString, QString>> &cmdInfo(const QString &key);
+    QList<QMap<QString, QString>> cmdInfo(const QString &key);
+
+    /**
+     * @brief cmdRecords:获取命令key对相应的记录，属性以驻留的整数id查找
+     * @param key:命令值
+     * @return 记录组成的List，隐式共享
+     */
+    QList<CmdRecord> cmdRecords(const QString &key);
 
     /**
      * @brief exportToTxt:导出到txt
@@ -571,6 +606,16 @@ protected:
     ~DeviceManager();
 
 private:
+    /**
+     * @brief clearCmdInfo:释放所有已发布的命令槽
+     */
+    void clearCmdInfo();
+
+    /**
+     * @brief resetShards:设备列表清空后重建所有分片的索引
+     */
+    void resetShards();
+
     static DeviceManager    *sInstance;
 
     QList<DeviceBaseInfo *>              m_ListDeviceMouse;                //<! 鼠标设备
@@ -592,9 +637,31 @@ private:
     QList<DeviceBaseInfo *>              m_ListDeviceComputer;             //<! 计算机基本信息
     QList<DeviceBaseInfo *>              m_ListDeviceCdrom;                //<! cdrom设备
 
+    // 每类设备一个分片，生成任务并行添加、查找设备
+    DeviceShard                          m_ShardMouse {m_ListDeviceMouse};
+    DeviceShard                          m_ShardCPU {m_ListDeviceCPU};
+    DeviceShard                          m_ShardStorage {m_ListDeviceStorage};
+    DeviceShard                          m_ShardGPU {m_ListDeviceGPU};
+    DeviceShard                          m_ShardMemory {m_ListDeviceMemory};
+    DeviceShard                          m_ShardMonitor {m_ListDeviceMonitor};
+    DeviceShard                          m_ShardBios {m_ListDeviceBios};
+    DeviceShard                          m_ShardBluetooth {m_ListDeviceBluetooth};
+    DeviceShard                          m_ShardAudio {m_ListDeviceAudio};
+    DeviceShard                          m_ShardNetwork {m_ListDeviceNetwork};
+    DeviceShard                          m_ShardImage {m_ListDeviceImage};
+    DeviceShard                          m_ShardKeyboard {m_ListDeviceKeyboard};
+    DeviceShard                          m_ShardOthers {m_ListDeviceOthers};
+    DeviceShard                          m_ShardPower {m_ListDevicePower};
+    DeviceShard                          m_ShardPrint {m_ListDevicePrint};
+    DeviceShard                          m_ShardOtherPCI {m_ListDeviceOtherPCI};
+    DeviceShard                          m_ShardComputer {m_ListDeviceComputer};
+    DeviceShard                          m_ShardCdrom {m_ListDeviceCdrom};
+
     QList<QPair<QString, QString>>       m_ListDeviceType;                 //<! 所有的设备类型及其对应的图标
     QStringList                                    m_BusIdList;            //<! 所有的设备总线ID
-    QMap<QString, QList<QMap<QString, QString> > > m_cmdInfo;              //<! 所有设备信息获取命令
+    QSet<QString>                                  m_BusIdSet;             //<! 总线ID索引
+    QMutex                                         m_BusIdMutex;           //<! 保护总线ID
+    QAtomicPointer<CmdSlot>                        m_CmdSlots;             //<! 所有设备信息获取命令，最后发布的槽
     QMap<QString, QString>                         m_OveriewMap;           //<! 所有的设备与其对应概况信息
     QMap<QString, QList<DeviceBaseInfo *>>         m_DeviceClassMap;       //<! 所有的设备类型与其对应设备列表
     QMap<QString, QMap<QString, QStringList>>      m_DeviceDriverPool;     //<! 所有的设备驱动与与其对应的设备类型，设备名称列表
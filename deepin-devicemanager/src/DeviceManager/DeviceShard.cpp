@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DeviceShard.h"
+#include "DeviceInfo.h"
+
+#include <algorithm>
+
+static QString uniqueIDKey(const DeviceBaseInfo *device)
+{
+    return device->uniqueID();
+}
+
+static QString sysPathKey(const DeviceBaseInfo *device)
+{
+    return device->sysPath();
+}
+
+static QString hwinfoToLshwKey(const DeviceBaseInfo *device)
+{
+    return device->hwinfoToLshw();
+}
+
+DeviceShard::DeviceShard(QList<DeviceBaseInfo *> &lstDevice)
+    : m_LstDevice(lstDevice)
+    , m_Indexed(0)
+    , m_Last(nullptr)
+    , m_Mutex(QMutex::Recursive)
+{
+    m_IndexKey[UniqueID] = uniqueIDKey;
+    m_IndexKey[SysPath] = sysPathKey;
+    m_IndexKey[DeviceFile] = nullptr;
+    m_IndexKey[BusID] = nullptr;
+    m_IndexKey[LogicalName] = nullptr;
+    m_IndexKey[HwinfoToLshw] = hwinfoToLshwKey;
+}
+
+void DeviceShard::setIndexKey(Index index, IndexKey key)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_IndexKey[index] = key;
+    reindex();
+}
+
+QMutex *DeviceShard::mutex()
+{
+    return &m_Mutex;
+}
+
+void DeviceShard::append(DeviceBaseInfo *device)
+{
+    QMutexLocker locker(&m_Mutex);
+    // 列表被直接修改过时先重建
+    refresh();
+
+    m_LstDevice.append(device);
+    addIndex(m_LstDevice.size() - 1);
+    m_Indexed = m_LstDevice.size();
+    m_Last = device;
+}
+
+void DeviceShard::update(DeviceBaseInfo *device)
+{
+    QMutexLocker locker(&m_Mutex);
+    refresh();
+
+    int pos = m_LstDevice.indexOf(device);
+    if (pos >= 0)
+        addKeys(pos);
+}
+
+DeviceBaseInfo *DeviceShard::find(Index index, const QString &key)
+{
+    QMutexLocker locker(&m_Mutex);
+    return touch(position(index, key));
+}
+
+DeviceBaseInfo *DeviceShard::find(Index index1, const QString &key1, Index index2, const QString &key2)
+{
+    QMutexLocker locker(&m_Mutex);
+    int pos1 = position(index1, key1);
+    int pos2 = position(index2, key2);
+    if (pos1 < 0 || (pos2 >= 0 && pos2 < pos1))
+        pos1 = pos2;
+    return touch(pos1);
+}
+
+QList<DeviceBaseInfo *> DeviceShard::findAll(Index index, const QStringList &keys)
+{
+    QMutexLocker locker(&m_Mutex);
+    QVector<int> lstPos;
+    foreach (const QString &key, keys)
+        lstPos += positions(index, key);
+
+    // 多个 key 可能对应同一个设备
+    std::sort(lstPos.begin(), lstPos.end());
+    lstPos.erase(std::unique(lstPos.begin(), lstPos.end()), lstPos.end());
+
+    QList<DeviceBaseInfo *> lstDevice;
+    lstDevice.reserve(lstPos.size());
+    foreach (int pos, lstPos)
+        lstDevice.append(touch(pos));
+    return lstDevice;
+}
+
+void DeviceShard::reset()
+{
+    QMutexLocker locker(&m_Mutex);
+    reindex();
+}
+
+QVector<int> DeviceShard::positions(Index index, const QString &key)
+{
+    if (!m_IndexKey[index])
+        return QVector<int>();
+
+    refresh();
+
+    QHash<QString, QVector<int> >::const_iterator it = m_Index[index].constFind(key);
+    if (it == m_Index[index].constEnd())
+        return QVector<int>();
+
+    // 设备的 key 在加入之后被修改，可能没有经过 find 或 update，新的 key 不在索引中，重建后再查找
+    foreach (int pos, it.value()) {
+        if (m_IndexKey[index](m_LstDevice[pos]) != key) {
+            reindex();
+            return m_Index[index].value(key);
+        }
+    }
+    return it.value();
+}
+
+int DeviceShard::position(Index index, const QString &key)
+{
+    const QVector<int> &lstPos = positions(index, key);
+    return lstPos.isEmpty() ? -1 : lstPos.first();
+}
+
+void DeviceShard::refresh()
+{
+    // 列表被直接修改过(合并、删除重复设备)
+    if (stale()) {
+        reindex();
+        return;
+    }
+
+    // 查找到的设备可能已被修改，添加新的 key
+    foreach (int pos, m_Touched)
+        addKeys(pos);
+    m_Touched.clear();
+}
+
+DeviceBaseInfo *DeviceShard::touch(int pos)
+{
+    if (pos < 0)
+        return nullptr;
+    m_Touched.append(pos);
+    return m_LstDevice[pos];
+}
+
+void DeviceShard::reindex()
+{
+    m_Touched.clear();
+    for (int i = 0; i < IndexCount; ++i)
+        m_Index[i].clear();
+    for (int pos = 0; pos < m_LstDevice.size(); ++pos)
+        addIndex(pos);
+    m_Indexed = m_LstDevice.size();
+    m_Last = m_LstDevice.isEmpty() ? nullptr : m_LstDevice.last();
+}
+
+bool DeviceShard::stale() const
+{
+    if (m_Indexed != m_LstDevice.size())
+        return true;
+    return m_Indexed > 0 && m_LstDevice.last() != m_Last;
+}
+
+void DeviceShard::addIndex(int pos)
+{
+    DeviceBaseInfo *device = m_LstDevice[pos];
+    if (!device)
+        return;
+
+    for (int i = 0; i < IndexCount; ++i) {
+        if (!m_IndexKey[i])
+            continue;
+
+        // 按位置升序添加
+        m_Index[i][m_IndexKey[i](device)].append(pos);
+    }
+}
+
+void DeviceShard::addKeys(int pos)
+{
+    DeviceBaseInfo *device = m_LstDevice[pos];
+    if (!device)
+        return;
+
+    // 旧的 key 留在索引中，查找时命中旧的 key 会重建索引
+    for (int i = 0; i < IndexCount; ++i) {
+        if (!m_IndexKey[i])
+            continue;
+
+        QVector<int> &lstPos = m_Index[i][m_IndexKey[i](device)];
+        QVector<int>::iterator it = std::lower_bound(lstPos.begin(), lstPos.end(), pos);
+        if (it == lstPos.end() || *it != pos)
+            lstPos.insert(it, pos);
+    }
+}
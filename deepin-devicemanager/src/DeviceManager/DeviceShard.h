@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICESHARD_H
+#define DEVICESHARD_H
+
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QMutex>
+#include <QString>
+
+class DeviceBaseInfo;
+
+/**
+ * @brief The DeviceShard class
+ * 一类设备的列表及其哈希索引，每类设备一把锁，不同类别的生成任务互不阻塞
+ * 索引保存 key 在列表中出现的所有位置，查找结果与按顺序遍历列表相同
+ */
+class DeviceShard
+{
+    Q_DISABLE_COPY(DeviceShard)
+public:
+    /**
+     * @brief The Index enum : 索引的种类
+     */
+    enum Index {
+        UniqueID = 0,       //<! 设备的唯一值
+        SysPath,            //<! sysfs 路径
+        DeviceFile,         //<! 设备文件
+        BusID,              //<! 总线ID
+        LogicalName,        //<! 逻辑名称
+        HwinfoToLshw,       //<! 与 lshw 匹配的 key
+        IndexCount
+    };
+
+    /**
+     * @brief IndexKey : 从设备取出索引的 key，设备加入列表时只计算一次
+     */
+    typedef QString (*IndexKey)(const DeviceBaseInfo *device);
+
+    /**
+     * @brief DeviceShard
+     * @param lstDevice : 设备列表，列表仍由 DeviceManager 持有
+     */
+    explicit DeviceShard(QList<DeviceBaseInfo *> &lstDevice);
+
+    /**
+     * @brief setIndexKey : 设置索引的取值方式，默认只有 UniqueID、SysPath 和 HwinfoToLshw 索引
+     */
+    void setIndexKey(Index index, IndexKey key);
+
+    /**
+     * @brief mutex : 遍历并修改设备时加锁，递归锁，持有时可以继续调用 append/find
+     */
+    QMutex *mutex();
+
+    /**
+     * @brief append : 添加设备并更新索引
+     */
+    void append(DeviceBaseInfo *device);
+
+    /**
+     * @brief update : 没有经过 find 取得的设备修改了索引的 key 时调用，添加新的 key
+     * find 返回的设备在下一次访问时自动更新，其它设备在按旧的 key 查找时重建索引
+     */
+    void update(DeviceBaseInfo *device);
+
+    /**
+     * @brief find : 按索引查找
+     * @return 列表中第一个 key 相同的设备，nullptr if not found
+     */
+    DeviceBaseInfo *find(Index index, const QString &key);
+
+    /**
+     * @brief find : 两个索引中任意一个相同即可
+     * @return 列表中第一个满足条件的设备
+     */
+    DeviceBaseInfo *find(Index index1, const QString &key1, Index index2, const QString &key2);
+
+    /**
+     * @brief findAll : 查找 key 等于 keys 中任意一个的所有设备
+     * @return 按列表顺序排列，不重复
+     */
+    QList<DeviceBaseInfo *> findAll(Index index, const QStringList &keys);
+
+    /**
+     * @brief reset : 列表被整体清空或替换后重建索引
+     */
+    void reset();
+
+private:
+    /**
+     * @brief positions : 查找位置，列表被直接修改或命中的设备 key 已经变化时重建索引
+     * @return 升序排列的位置
+     */
+    QVector<int> positions(Index index, const QString &key);
+
+    /**
+     * @brief position : 第一次出现的位置
+     * @return -1 if not found
+     */
+    int position(Index index, const QString &key);
+
+    /**
+     * @brief refresh : 列表被直接修改时重建索引，否则添加查找过的设备的新 key
+     */
+    void refresh();
+
+    /**
+     * @brief touch : 记录返回给调用者的设备，调用者可能修改其 key
+     * @return nullptr if pos < 0
+     */
+    DeviceBaseInfo *touch(int pos);
+
+    /**
+     * @brief reindex : 重建所有索引
+     */
+    void reindex();
+
+    /**
+     * @brief stale : 列表被绕过 append 修改过，个数或最后一个设备与索引不一致
+     */
+    bool stale() const;
+
+    /**
+     * @brief addIndex : 添加第 pos 个设备的索引
+     */
+    void addIndex(int pos);
+
+    /**
+     * @brief addKeys : 第 pos 个设备的 key 有变化时，按位置顺序插入新的 key
+     */
+    void addKeys(int pos);
+
+private:
+    QList<DeviceBaseInfo *>     &m_LstDevice;               //<! 设备列表
+    IndexKey                    m_IndexKey[IndexCount];     //<! 各索引的取值方式，nullptr 表示不建索引
+    QHash<QString, QVector<int> > m_Index[IndexCount];      //<! key -> 出现的位置，升序
+    int                         m_Indexed;                  //<! 已建索引的设备个数
+    DeviceBaseInfo              *m_Last;                    //<! 已建索引的最后一个设备
+    QVector<int>                m_Touched;                  //<! 查找后返回给调用者的设备位置
+    QMutex                      m_Mutex;                    //<! 保护列表、索引和设备
+};
+
+#endif // DEVICESHARD_H
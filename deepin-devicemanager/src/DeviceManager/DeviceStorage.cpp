@@ -452,6 +452,16 @@ const QString &DeviceStorage::keyFromStorage()const
     return m_KeyFromStorage;
 }
 
+const QString &DeviceStorage::keyToLshw()const
+{
+    return m_KeyToLshw;
+}
+
+const QString &DeviceStorage::deviceFile()const
+{
+    return m_DeviceFile;
+}
+
 QString DeviceStorage::subTitle()
 {
     return m_Model;
@@ -137,6 +137,18 @@ public:
        */
     const QString &keyFromStorage()const;
 
+    /**
+     * @brief keyToLshw:获取与lshw匹配的总线ID
+     * @return QString:hwinfo中的SysFS BusID
+     */
+    const QString &keyToLshw()const;
+
+    /**
+     * @brief deviceFile:获取设备文件
+     * @return QString:设备文件，如 /dev/sda
+     */
+    const QString &deviceFile()const;
+
     /**
      * @brief subTitle:获取子标题
      * @return 子标题
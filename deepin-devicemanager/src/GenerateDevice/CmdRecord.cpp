@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CmdRecord.h"
+
+#include <QReadWriteLock>
+#include <QHash>
+
+#include <algorithm>
+
+/**
+ * @brief The KeyTable struct : 属性名驻留表，只增不减
+ */
+struct KeyTable {
+    QReadWriteLock          lock;       //<! 解析线程并发驻留
+    QHash<QString, int>     ids;        //<! 属性名 -> id
+    QVector<QString>        names;      //<! id -> 属性名
+};
+
+static KeyTable &keyTable()
+{
+    static KeyTable s_Table;
+    return s_Table;
+}
+
+static bool lessId(const QPair<int, QString> &attr, int id)
+{
+    return attr.first < id;
+}
+
+CmdRecord::CmdRecord()
+{
+
+}
+
+CmdRecord::CmdRecord(const QMap<QString, QString> &mapInfo)
+{
+    m_Attrs.reserve(mapInfo.size());
+    for (QMap<QString, QString>::const_iterator it = mapInfo.begin(); it != mapInfo.end(); ++it)
+        m_Attrs.append(qMakePair(keyId(it.key()), it.value()));
+    std::sort(m_Attrs.begin(), m_Attrs.end(), [](const QPair<int, QString> &a, const QPair<int, QString> &b) {
+        return a.first < b.first;
+    });
+}
+
+int CmdRecord::keyId(const QString &key)
+{
+    KeyTable &table = keyTable();
+    {
+        QReadLocker locker(&table.lock);
+        QHash<QString, int>::const_iterator it = table.ids.find(key);
+        if (it != table.ids.end())
+            return it.value();
+    }
+
+    QWriteLocker locker(&table.lock);
+    // 加写锁之前可能已被其他线程添加
+    QHash<QString, int>::const_iterator it = table.ids.find(key);
+    if (it != table.ids.end())
+        return it.value();
+    int id = table.names.size();
+    table.names.append(key);
+    table.ids.insert(key, id);
+    return id;
+}
+
+int CmdRecord::findKeyId(const QString &key)
+{
+    KeyTable &table = keyTable();
+    QReadLocker locker(&table.lock);
+    return table.ids.value(key, -1);
+}
+
+QString CmdRecord::keyName(int id)
+{
+    KeyTable &table = keyTable();
+    QReadLocker locker(&table.lock);
+    if (id < 0 || id >= table.names.size())
+        return QString();
+    return table.names[id];
+}
+
+QList<CmdRecord> CmdRecord::fromList(const QList<QMap<QString, QString> > &lstMap)
+{
+    QList<CmdRecord> lstRecord;
+    lstRecord.reserve(lstMap.size());
+    foreach (const auto &mapInfo, lstMap)
+        lstRecord.append(CmdRecord(mapInfo));
+    return lstRecord;
+}
+
+QList<QMap<QString, QString> > CmdRecord::toList(const QList<CmdRecord> &lstRecord)
+{
+    QList<QMap<QString, QString> > lstMap;
+    lstMap.reserve(lstRecord.size());
+    foreach (const CmdRecord &record, lstRecord)
+        lstMap.append(record.toMap());
+    return lstMap;
+}
+
+int CmdRecord::size() const
+{
+    return m_Attrs.size();
+}
+
+bool CmdRecord::isEmpty() const
+{
+    return m_Attrs.isEmpty();
+}
+
+bool CmdRecord::contains(int id) const
+{
+    return nullptr != find(id);
+}
+
+QString CmdRecord::value(int id) const
+{
+    const QPair<int, QString> *attr = find(id);
+    return attr ? attr->second : QString();
+}
+
+QString CmdRecord::value(const QString &key) const
+{
+    return value(findKeyId(key));
+}
+
+void CmdRecord::insert(int id, const QString &value)
+{
+    QVector<QPair<int, QString> >::iterator it = std::lower_bound(m_Attrs.begin(), m_Attrs.end(), id, lessId);
+    if (it != m_Attrs.end() && it->first == id)
+        it->second = value;
+    else
+        m_Attrs.insert(it, qMakePair(id, value));
+}
+
+QMap<QString, QString> CmdRecord::toMap() const
+{
+    QMap<QString, QString> mapInfo;
+    KeyTable &table = keyTable();
+    QReadLocker locker(&table.lock);
+    foreach (const auto &attr, m_Attrs)
+        mapInfo.insert(table.names[attr.first], attr.second);
+    return mapInfo;
+}
+
+bool CmdRecord::operator==(const CmdRecord &other) const
+{
+    return m_Attrs == other.m_Attrs;
+}
+
+const QPair<int, QString> *CmdRecord::find(int id) const
+{
+    QVector<QPair<int, QString> >::const_iterator it = std::lower_bound(m_Attrs.constBegin(), m_Attrs.constEnd(), id, lessId);
+    if (it == m_Attrs.constEnd() || it->first != id)
+        return nullptr;
+    return it;
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CMDRECORD_H
+#define CMDRECORD_H
+
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <QList>
+#include <QMap>
+
+/**
+ * @brief The CmdRecord class
+ * 命令解析出的一条记录，属性名在全局表中驻留为整数 id，每个属性名只保存一份，
+ * 记录本身只保存按 id 排序的 (id, value) 数组，查找为二分查找加整数比较
+ */
+class CmdRecord
+{
+public:
+    CmdRecord();
+    explicit CmdRecord(const QMap<QString, QString> &mapInfo);
+
+    /**
+     * @brief keyId : 驻留属性名，不存在时添加，线程安全
+     * @param key : Hardware Class, SysFS BusID, Model ...
+     * @return 属性名对应的 id，在进程内不变
+     */
+    static int keyId(const QString &key);
+
+    /**
+     * @brief findKeyId : 只查找不添加
+     * @return -1 if the key was never interned
+     */
+    static int findKeyId(const QString &key);
+
+    /**
+     * @brief keyName
+     * @return empty if the id is invalid
+     */
+    static QString keyName(int id);
+
+    /**
+     * @brief fromList : map list 转为记录
+     */
+    static QList<CmdRecord> fromList(const QList<QMap<QString, QString> > &lstMap);
+
+    /**
+     * @brief toList : 记录转为 map list，供仍使用 map 的生成器代码
+     */
+    static QList<QMap<QString, QString> > toList(const QList<CmdRecord> &lstRecord);
+
+    int size() const;
+    bool isEmpty() const;
+
+    /**
+     * @brief contains
+     * @param id : keyId() 的返回值
+     */
+    bool contains(int id) const;
+
+    /**
+     * @brief value
+     * @param id : keyId() 的返回值
+     * @return empty if not found
+     */
+    QString value(int id) const;
+
+    /**
+     * @brief value : 按名称查找，名称只查一次驻留表
+     */
+    QString value(const QString &key) const;
+
+    /**
+     * @brief insert : 已存在时覆盖
+     */
+    void insert(int id, const QString &value);
+
+    /**
+     * @brief toMap : 还原为 map
+     */
+    QMap<QString, QString> toMap() const;
+
+    bool operator==(const CmdRecord &other) const;
+
+private:
+    /**
+     * @brief find : 二分查找
+     * @return nullptr if not found
+     */
+    const QPair<int, QString> *find(int id) const;
+
+private:
+    QVector<QPair<int, QString> >   m_Attrs;        //<! 按 id 排序的属性
+};
+
+Q_DECLARE_TYPEINFO(CmdRecord, Q_MOVABLE_TYPE);
+
+#endif // CMDRECORD_H
@@ -19,8 +19,29 @@
 #include "DBusInterface.h"
 #include "DBusEnableInterface.h"
 #include "MacroDefinition.h"
+#include "ProcessLauncher.h"
+#include "CollectorBundle.h"
+#include "HwinfoParser.h"
+
+/**
+ * @brief usbBusId : SysFS BusID without the interface number, 1-3:1.2 and 1-3:1.0 are the same device
+ */
+static QString usbBusId(const QString &busId)
+{
+    // 等价于去掉 \.[0-9]{1,2}$
+    int dot = busId.lastIndexOf('.');
+    int digits = busId.size() - dot - 1;
+    if (dot < 0 || digits < 1 || digits > 2)
+        return busId;
+    for (int i = dot + 1; i < busId.size(); ++i) {
+        if (busId[i] < '0' || busId[i] > '9')
+            return busId;
+    }
+    return busId.left(dot);
+}
 
 CmdTool::CmdTool()
+    : m_UsbIndexed(0)
 {
 
 }
@@ -50,19 +71,17 @@ void CmdTool::addMouseKeyboardInfoMapInfo(const QString &key, const QMap<QString
 
 void CmdTool::addUsbMapInfo(const QString &key, const QMap<QString, QString> &mapInfo)
 {
-    QList<QMap<QString, QString>>::iterator it = m_cmdInfo["hwinfo_usb"].begin();
     // 有的是有同一个设备有两段信息，我们只需要一个
     // 比如 SysFS BusID: 1-3:1.2   和  SysFS BusID: 1-3:1.0 这个是同一个设备
-    // 我们只需要一个
-    for (; it != m_cmdInfo["hwinfo_usb"].end(); ++it) {
-        QString curBus = (*it)["SysFS BusID"];
-        QString newBus = mapInfo["SysFS BusID"];
-        curBus.replace(QRegExp("\\.[0-9]{1,2}$"), "");
-        newBus.replace(QRegExp("\\.[0-9]{1,2}$"), "");
-        if (!curBus.isEmpty() && curBus == newBus) {
-            return;
-        }
+    // 我们只需要一个，已添加的设备保存在集合中，不再逐个比较
+    const QList<QMap<QString, QString> > &lstUsb = m_cmdInfo["hwinfo_usb"];
+    for (; m_UsbIndexed < lstUsb.size(); ++m_UsbIndexed) {
+        QString curBus = usbBusId(lstUsb[m_UsbIndexed].value("SysFS BusID"));
+        if (!curBus.isEmpty())
+            m_UsbBusIds.insert(curBus);
     }
+    if (m_UsbBusIds.contains(usbBusId(mapInfo.value("SysFS BusID"))))
+        return;
 
     // 这个是用来过滤，没有接入任何设备的usb接口
     if (mapInfo["Model"].contains("Linux Foundation")
@@ -134,8 +153,6 @@ void CmdTool::loadCmdInfo(const QString &key, const QString &debugFile)
         loadBootDeviceManfid(key, debugFile);    // 加载蓝牙设备配对信息
     else if ("lscpu" == key)
         loadLscpuInfo(key, debugFile);
-    else if ("dr_config" == key)
-        loadCatConfigInfo(key, debugFile);
     else if ("nvidia" == key)
         loadNvidiaSettingInfo(key, debugFile);
     else
@@ -149,6 +166,19 @@ QMap<QString, QList<QMap<QString, QString> > > &CmdTool::cmdInfo()
 
 void CmdTool::loadLshwInfo(const QString &debugFile)
 {
+    // 优先使用后台已解析的记录，第一条为系统信息
+    QList<QMap<QString, QString> > records;
+    if (DBusInterface::getInstance()->getRecords("lshw", records) && !records.isEmpty()) {
+        for (int i = 0; i < records.size(); ++i) {
+            QMap<QString, QString> mapInfo = records[i];
+            QString item = mapInfo.take("*-");
+            QString key = 0 == i ? QString("lshw_system") : lshwKey(item);
+            if (!key.isEmpty())
+                addMapInfo(key, mapInfo);
+        }
+        return;
+    }
+
     // 加载lshw信息
     QString deviceInfo;
     getDeviceInfo(deviceInfo, debugFile);
@@ -157,49 +187,44 @@ void CmdTool::loadLshwInfo(const QString &debugFile)
     QStringList items = deviceInfo.split("*-");
     bool isFirst = true;
     foreach (const QString &item, items) {
-        QMap<QString, QString> mapInfo;
-        if (isFirst) {
-            // 系统信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_system", mapInfo);
-            isFirst = false;
+        // 第一项为系统信息
+        QString key = isFirst ? QString("lshw_system") : lshwKey(item);
+        isFirst = false;
+        if (key.isEmpty())
             continue;
-        }
 
-        // CPU 信息
-        if (item.startsWith("cpu")) {
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_cpu", mapInfo);
-        } else if (item.startsWith("disk")) {         // 存储设备信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_disk", mapInfo);
-        } else if (item.startsWith("storage")) {
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_storage", mapInfo);
+        QMap<QString, QString> mapInfo;
+        getMapInfoFromLshw(item, mapInfo);
+        addMapInfo(key, mapInfo);
+    }
+}
+
+QString CmdTool::lshwKey(const QString &item)
+{
+    // CPU 信息
+    if (item.startsWith("cpu"))
+        return "lshw_cpu";
+    else if (item.startsWith("disk"))           // 存储设备信息
+        return "lshw_disk";
+    else if (item.startsWith("storage"))
+        return "lshw_storage";
 #ifdef __sw_64__
-        } else if ((item.startsWith("memory") && !item.startsWith("memory UNCLAIMED")) || item.startsWith("bank")) {      // 内存信息
+    else if ((item.startsWith("memory") && !item.startsWith("memory UNCLAIMED")) || item.startsWith("bank"))      // 内存信息
 #else
-        } else if (item.startsWith("bank")) {      // 内存信息
+    else if (item.startsWith("bank"))           // 内存信息
 #endif
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_memory", mapInfo);
-        } else if (item.startsWith("display")) {      // 显卡信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_display", mapInfo);
-        } else if (item.startsWith("multimedia")) {   // 音频信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_multimedia", mapInfo);
-        } else if (item.startsWith("network")) {      // 网卡信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_network", mapInfo);
-        } else if (item.startsWith("usb")) {          // USB 设备信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_usb", mapInfo);
-        } else if (item.startsWith("cdrom")) {        // 光盘信息
-            getMapInfoFromLshw(item, mapInfo);
-            addMapInfo("lshw_cdrom", mapInfo);
-        }
-    }
+        return "lshw_memory";
+    else if (item.startsWith("display"))        // 显卡信息
+        return "lshw_display";
+    else if (item.startsWith("multimedia"))     // 音频信息
+        return "lshw_multimedia";
+    else if (item.startsWith("network"))        // 网卡信息
+        return "lshw_network";
+    else if (item.startsWith("usb"))            // USB 设备信息
+        return "lshw_usb";
+    else if (item.startsWith("cdrom"))          // 光盘信息
+        return "lshw_cdrom";
+    return QString();
 }
 
 void CmdTool::loadLsblkInfo(const QString &debugfile)
@@ -267,6 +292,13 @@ void CmdTool::loadSmartCtlInfo(const QString &logicalName, const QString &debugf
 
 void CmdTool::loadDmesgInfo(const QString &debugfile)
 {
+    // 后台增量读取 /dev/kmsg 并提取显存和声卡芯片信息，不再传输整个内核日志
+    QString facts;
+    if (getDeviceInfo(facts, "dmesg_facts.txt") && !facts.isEmpty()) {
+        loadDmesgFacts(facts);
+        return;
+    }
+
     QString deviceInfo;
     if (!getDeviceInfo(deviceInfo, debugfile))
         return;
@@ -275,6 +307,10 @@ void CmdTool::loadDmesgInfo(const QString &debugfile)
     QMap<QString, QString> mapInfo;
     QStringList lines = deviceInfo.split("\n");
     foreach (const QString &line, lines) {
+        // 只有少数行包含显存信息，先做简单的字符串判断再匹配正则表达式
+        if (!line.contains("VRAM"))
+            continue;
+
         // DeviceCdrom m_HwinfoToLshw 值为0000:01:00.0 此处同步修改,否则显存大小无法显示
         QRegExp reg(".*([0-9a-z]{4}:[0-9a-z]{2}:[0-9a-z]{2}.[0-9]{1}):.*VRAM([=:]{1}) ([0-9]*)[\\s]{0,1}M.*");
         if (reg.exactMatch(line)) {
@@ -302,6 +338,8 @@ void CmdTool::loadDmesgInfo(const QString &debugfile)
      * ALC887:
     */
     foreach (const QString &line, lines) {
+        if (!line.contains("autoconfig for"))
+            continue;
         QRegExp reg(".*autoconfig for ([A-Za-z0-9]{6}( [A-Za-z0-9]+|-[A-Za-z0-9]+|)):.*");
         if (reg.exactMatch(line)) {
             QString chip = reg.cap(1);
@@ -311,6 +349,30 @@ void CmdTool::loadDmesgInfo(const QString &debugfile)
     addMapInfo("audiochip", mapInfo);
 }
 
+void CmdTool::loadDmesgFacts(const QString &facts)
+{
+    // VRAM: 0000:01:00.0=4GB
+    // AudioChip: ALC887-VD
+    bool hasVram = false;
+    QMap<QString, QString> chipInfo;
+    QStringList lines = facts.split("\n", QString::SkipEmptyParts);
+    foreach (const QString &line, lines) {
+        if (line.startsWith("VRAM: ")) {
+            QMap<QString, QString> mapInfo;
+            mapInfo["Size"] = line.mid(6);
+            addMapInfo("dmesg", mapInfo);
+            hasVram = true;
+        } else if (line.startsWith("AudioChip: ")) {
+            chipInfo["chip"] = line.mid(11);
+        }
+    }
+
+    // 没有显存信息时与解析 dmesg 一致，添加空信息，之后从 nvidia-settings 获取
+    if (!hasVram)
+        addMapInfo("dmesg", QMap<QString, QString>());
+    addMapInfo("audiochip", chipInfo);
+}
+
 void CmdTool::loadHciconfigInfo(const QString &debugfile)
 {
     // 获取hciconfig文件信息
@@ -321,15 +383,12 @@ void CmdTool::loadHciconfigInfo(const QString &debugfile)
     if (DSysInfo::UosHome == type) {
         // 如果是个人版则直接执行命令获取设备信息
         // bug 目前服务端与直接执行命令获取结果不一致
-        QProcess process;
         int msecs = 10000;
-        QString cmd = "hciconfig --all";
-        process.start(cmd);
+        QString info;
 
         // 获取命令执行结果
-        bool res = process.waitForFinished(msecs);
-        if (res)
-            deviceInfo = process.readAllStandardOutput();
+        if (ProcessLauncher::run("hciconfig", QStringList() << "--all", msecs, info))
+            deviceInfo = info;
 
     } else {
         // 获取文件信息
@@ -397,14 +456,9 @@ void CmdTool::loadHwinfoInfo(const QString &key, const QString &debugfile)
     QString deviceInfo;
     if ("hwinfo_monitor" == key) {
         getDeviceInfoFromCmd(deviceInfo, "hwinfo --monitor");
-        QStringList items = deviceInfo.split("\n\n");
-        foreach (const QString &item, items) {
-            if (item.isEmpty())
-                continue;
-            QMap<QString, QString> mapInfo;
-            getMapInfoFromHwinfo(item, mapInfo);
-            addMapInfo(key, mapInfo);
-        }
+        HwinfoParser parser(deviceInfo.toUtf8());
+        foreach (const HwinfoRecord &record, parser.records())
+            addMapInfo(key, record.toMap());
     } else { // 处理其它信息 mouse sound keyboard usb display cdrom disk
         getDeviceInfo(deviceInfo, debugfile);
         getMulHwinfoInfo(deviceInfo);
@@ -418,17 +472,14 @@ void CmdTool::getMulHwinfoInfo(const QString &info)
     DBusEnableInterface::getInstance()->getRemoveInfo(sRinfo);
     DBusEnableInterface::getInstance()->getAuthorizedInfo(sAinfo);
 
-    // 获取信息
-    QStringList items = info.split("\n\n");
-    QStringList auths = sAinfo.split("\n\n", QString::SkipEmptyParts);
-    QStringList remos = sRinfo.split("\n\n", QString::SkipEmptyParts);
-    QStringList resItems = items + auths + remos;
+    // 获取信息，一次遍历解析，不再切分为字符串列表
+    HwinfoParser items(info.toUtf8());
+    HwinfoParser auths(sAinfo.toUtf8());
+    HwinfoParser remos(sRinfo.toUtf8());
+    QVector<HwinfoRecord> resItems = items.records() + auths.records() + remos.records();
 
-    foreach (const QString &item, resItems) {
-        if (item.isEmpty())
-            continue;
-        QMap<QString, QString> mapInfo;
-        getMapInfoFromHwinfo(item, mapInfo);
+    foreach (const HwinfoRecord &item, resItems) {
+        QMap<QString, QString> mapInfo = item.toMap();
         if (mapInfo["Hardware Class"] == "sound" || mapInfo["Device"].contains("USB Audio")) {
             // mapInfo["Device"].contains("USB Audio") 是为了处理未识别的USB声卡 Bug-118773
             addMapInfo("hwinfo_sound", mapInfo);
@@ -467,10 +518,7 @@ void CmdTool::addWidthToMap(QMap<QString, QString> &mapInfo)
 
     QString cmd = QString("nvidia-settings -q GPUMemoryInterface");
     QString sInfo;
-    QProcess process;
-    process.start(cmd);
-    process.waitForFinished(-1);
-    sInfo = process.readAllStandardOutput();
+    ProcessLauncher::runCommand(cmd, DEFAULT_CMD_TIMEOUT, sInfo);
     QStringList lines = sInfo.split("\n");
     foreach (const QString &line, lines) {
         QRegExp reg("\\s\\sAttribute\\s'GPUMemoryInterface' \\(.*\\):\\s([0-9]{2}).*");
@@ -487,6 +535,15 @@ void CmdTool::loadDmidecodeInfo(const QString &key, const QString &debugfile)
         loadDmidecode2Info(key, debugfile);
         return;
     }
+    // 优先使用后台已解析的记录，不再切分文本，所有来源的记录在第一次获取时一起取回
+    QString source = debugfile;
+    source.replace(".txt", "");
+    QList<QMap<QString, QString> > records;
+    if (DBusInterface::getInstance()->getRecords(source, records) && !records.isEmpty()) {
+        loadDmidecodeRecords(key, records);
+        return;
+    }
+
     QString deviceInfo;
     getDeviceInfo(deviceInfo, debugfile);
 
@@ -514,6 +571,29 @@ void CmdTool::loadDmidecodeInfo(const QString &key, const QString &debugfile)
     }
 }
 
+void CmdTool::loadDmidecodeRecords(const QString &key, const QList<QMap<QString, QString> > &records)
+{
+    // According to the latest demand , The notebook should not have chassis information
+    if ("dmidecode3" == key) {
+        foreach (const auto &mapInfo, records) {
+            for (auto it = mapInfo.begin(); it != mapInfo.end(); ++it) {
+                if (it.key().contains("laptop", Qt::CaseInsensitive) || it.value().contains("laptop", Qt::CaseInsensitive) ||
+                        it.key().contains("notebook", Qt::CaseInsensitive) || it.value().contains("notebook", Qt::CaseInsensitive))
+                    return;
+            }
+        }
+    }
+
+    foreach (const auto &mapInfo, records) {
+        // 过滤空cpu卡槽信息
+        if ("dmidecode4" == key && mapInfo.find("ID") == mapInfo.end())
+            continue;
+
+        if (mapInfo.size() > MIN_NUM)
+            addMapInfo(key, mapInfo);
+    }
+}
+
 void CmdTool::loadDmidecode2Info(const QString &key, const QString &debugfile)
 {
     // 通过命令获取设备信息
@@ -683,24 +763,6 @@ void CmdTool::loadCatAudioInfo(const QString &key, const QString &debugfile)
     }
 }
 
-void CmdTool::loadCatConfigInfo(const QString &key, const QString &debugfile)
-{
-    QString deviceInfo;
-    if (!getDeviceInfo(deviceInfo, debugfile))
-        return;
-    QStringList items = deviceInfo.split("\n");
-    foreach (const QString &item, items) {
-        if (item.isEmpty())
-            continue;
-
-        QMap<QString, QString> mapInfo;
-        QStringList lines = item.split("\n");
-        mapInfo.insert("drivers", lines[0].trimmed());
-
-        addMapInfo(key, mapInfo);
-    }
-}
-
 void CmdTool::loadBootDeviceManfid(const QString &key, const QString &debugfile)
 {
     // 加载硬盘信息
@@ -918,15 +980,10 @@ void CmdTool::getMapInfoFromLshw(const QString &info, QMap<QString, QString> &ma
 QString CmdTool::getCurNetworkLinkStatus(QString driverName)
 {
     //通过ifconfig 判断网络是否连接
-    QProcess process;
-    QString cmd = "ifconfig";
-    process.start(cmd);
     QString ifconfigInfo;
     QString link;
-    bool re = process.waitForFinished(-1);
-    if (!re)
+    if (!ProcessLauncher::run("ifconfig", QStringList(), DEFAULT_CMD_TIMEOUT, ifconfigInfo))
         return "";
-    ifconfigInfo = process.readAllStandardOutput();
     //截取查询到的各个网卡连接信息
     QStringList list = ifconfigInfo.split("\n\n");
     for (int i = 0; i < list.size(); i++) {
@@ -945,15 +1002,9 @@ QMap<QString, QMap<QString, QString>> CmdTool::getCurPowerInfo()
 {
     QString powerInfo;
     QMap<QString, QMap<QString, QString>> map;
-    QProcess process;
 
     //执行"upower --dump"命令获取电池相关信息
-    QString cmd = "upower --dump";
-    process.start(cmd);
-
-    // 获取命令执行结果
-    process.waitForFinished(-1);
-    powerInfo = process.readAllStandardOutput();
+    ProcessLauncher::run("upower", QStringList() << "--dump", DEFAULT_CMD_TIMEOUT, powerInfo);
     QStringList items = powerInfo.split("\n\n");
     foreach (const QString &item, items) {
         if (item.isEmpty() || item.contains("DisplayDevice")
@@ -1305,10 +1356,15 @@ bool CmdTool::getDeviceInfo(QString &deviceInfo, const QString &debugFile)
 
 bool CmdTool::getDeviceInfoFromCmd(QString &deviceInfo, const QString &cmd)
 {
-    QProcess process;
-    process.start(cmd);
-    process.waitForFinished(-1);
-    deviceInfo = process.readAllStandardOutput();
+    CollectorBundle *bundle = CollectorBundle::getInstance();
+    if (bundle->isReplaying()) {
+        bundle->replayCmd(cmd, deviceInfo);
+        return true;
+    }
+
+    // 直接 posix_spawn 执行命令，不经过 QProcess
+    ProcessLauncher::runCommand(cmd, DEFAULT_CMD_TIMEOUT, deviceInfo);
+    bundle->captureCmd(cmd, deviceInfo);
     return true;
 }
 
@@ -1318,13 +1374,16 @@ bool CmdTool::getCatDeviceInfo(QString &deviceInfo, const QString &debugFile)
     if (!deviceInfo.isEmpty())
         return true;
 
-    // 从文件中获取设备信息
-    QFile inputDeviceFile(debugFile);
+    // 从文件中获取设备信息，回放时读取录制的文件
+    CollectorBundle *bundle = CollectorBundle::getInstance();
+    QFile inputDeviceFile(bundle->filePath(debugFile));
     if (false == inputDeviceFile.open(QIODevice::ReadOnly))
         return false;
 
-    deviceInfo = inputDeviceFile.readAll();
+    QByteArray data = inputDeviceFile.readAll();
     inputDeviceFile.close();
+    bundle->captureFile(debugFile, data);
+    deviceInfo = data;
 
     return true;
 }
@@ -8,6 +8,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QSet>
 #include <QProcess>
 #include <QFile>
 #include <cups.h>
@@ -60,6 +61,13 @@ private:
      */
     void loadLshwInfo(const QString &debugFile);
 
+    /**
+     * @brief lshwKey:根据lshw项的开头获取对应的关键字
+     * @param item:lshw中 "*-" 之后的内容
+     * @return 不需要的项返回空
+     */
+    static QString lshwKey(const QString &item);
+
     /**
      * @brief loadLsblkInfo:加载lsblk -d -o name,rota获取的信息
      * @param debugfile:调试文件名
@@ -86,6 +94,12 @@ private:
      */
     void loadDmesgInfo(const QString &debugfile);
 
+    /**
+     * @brief loadDmesgFacts:加载后台从内核日志中提取的显存和声卡芯片信息
+     * @param facts:dmesg_facts信息
+     */
+    void loadDmesgFacts(const QString &facts);
+
     /**
      * @brief loadHciconfigInfo:加载hciconfig -a获取的信息
      * @param debugfile:调试文件名
@@ -155,6 +169,13 @@ private:
      */
     void loadDmidecodeInfo(const QString &key, const QString &debugfile);
 
+    /**
+     * @brief loadDmidecodeRecords:加载后台已解析的dmidecode记录
+     * @param key:与cmd对应的关键字
+     * @param records:后台解析的记录
+     */
+    void loadDmidecodeRecords(const QString &key, const QList<QMap<QString, QString> > &records);
+
     /**
      * @brief loadDmidecode2Info:加载dmidecode -t 2信息
      * @param key:dmidecode2
@@ -203,12 +224,6 @@ private:
      */
     void loadCatAudioInfo(const QString &key, const QString &debugfile);
 
-    /**
-     * @brief loadCatConfigInfo:cat /boot/config* | grep '=y'信息
-     * @param key:dr_config
-     * @param debugfile:调试文件名
-     */
-    void loadCatConfigInfo(const QString &key, const QString &debugfile);
     /**
      * @brief loadBootDeviceManfid:加载本机自带硬盘
      * @param key:bootdevice
@@ -356,6 +371,8 @@ private:
 
 private:
     QMap<QString, QList<QMap<QString, QString> > > m_cmdInfo;
+    QSet<QString>   m_UsbBusIds;        //<! hwinfo_usb 中已有设备的 SysFS BusID
+    int             m_UsbIndexed;       //<! hwinfo_usb 中已加入 m_UsbBusIds 的设备数
 };
 
 #endif // CMDTOOL_H
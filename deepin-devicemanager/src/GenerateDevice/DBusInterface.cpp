@@ -8,8 +8,16 @@
 #include <QDBusConnection>
 #include <QDBusInterface>
 #include <QDBusReply>
+#include <QDBusMetaType>
+#include <QDBusMessage>
+#include <QDBusUnixFileDescriptor>
 #include <QDebug>
 
+#include "CollectorBundle.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 // 以下这个问题可以避免单例的内存泄露问题
 std::atomic<DBusInterface *> DBusInterface::s_Instance;
 std::mutex DBusInterface::m_mutex;
@@ -18,15 +26,45 @@ const QString SERVICE_NAME = "com.deepin.devicemanager";
 const QString DEVICE_SERVICE_PATH = "/com/deepin/devicemanager";
 const QString DEVICE_SERVICE_INTERFACE = "com.deepin.devicemanager";
 
+// 后台解析为记录的来源，dmidecode_2 由客户端单独处理
+const QStringList RECORD_SOURCES = QStringList() << "lshw" << "dmidecode_0" << "dmidecode_1" << "dmidecode_3"
+                                   << "dmidecode_4" << "dmidecode_13" << "dmidecode_16" << "dmidecode_17";
+
 DBusInterface::DBusInterface()
     : mp_Iface(nullptr)
+    , m_Generation(0)
+    , m_CacheValid(false)
+    , m_CpuFreqSeq(0)
+    , m_RecordsValid(false)
 {
+    // a{ss}
+    qDBusRegisterMetaType<QMap<QString, QString> >();
+
     // 初始化dbus
     init();
 }
 
 bool DBusInterface::getInfo(const QString &key, QString &info)
 {
+    // 回放时只使用录制的信息，后台没有运行
+    if (CollectorBundle::getInstance()->isReplaying()) {
+        QMutexLocker locker(&m_CacheMutex);
+        info = m_MapCache.value(key);
+        return m_CacheValid;
+    }
+
+    // 已经批量获取过时直接使用缓存，is_server_running 需要实时获取
+    if ("is_server_running" != key) {
+        QMutexLocker locker(&m_CacheMutex);
+        if (m_CacheValid) {
+            info = m_MapCache.value(key);
+            return true;
+        }
+    }
+
+    if (isLargeKey(key) && getInfoFromFd(key, info))
+        return true;
+
     // 调用dbus接口获取设备信息
     QDBusReply<QString> reply = mp_Iface->call("getInfo", key);
     if (reply.isValid()) {
@@ -38,11 +76,185 @@ bool DBusInterface::getInfo(const QString &key, QString &info)
     }
 }
 
+bool DBusInterface::fetchChangedInfos()
+{
+    QMutexLocker locker(&m_CacheMutex);
+    if (CollectorBundle::getInstance()->isReplaying()) {
+        m_Generation = 0;
+        m_CacheValid = CollectorBundle::getInstance()->replayInfos(m_MapCache);
+        return m_CacheValid;
+    }
+
+    QDBusMessage reply = mp_Iface->call("getChangedInfos", QVariant::fromValue<qulonglong>(m_Generation));
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().size() != 3) {
+        // 后台版本较旧，逐个获取
+        m_CacheValid = false;
+        return false;
+    }
+
+    // 只包含变化的信息，合并到缓存中
+    QMap<QString, QString> infos = qdbus_cast<QMap<QString, QString> >(reply.arguments()[0]);
+    for (QMap<QString, QString>::const_iterator it = infos.begin(); it != infos.end(); ++it) {
+        if (it.value().isEmpty())
+            m_MapCache.remove(it.key());
+        else
+            m_MapCache.insert(it.key(), it.value());
+    }
+
+    // 大的信息通过 memfd 获取，失败时回退到字符串接口
+    QStringList largeKeys = qdbus_cast<QStringList>(reply.arguments()[2]);
+    foreach (const QString &key, largeKeys) {
+        QString info;
+        if (!getInfoFromFd(key, info)) {
+            QDBusReply<QString> infoReply = mp_Iface->call("getInfo", key);
+            if (!infoReply.isValid()) {
+                m_CacheValid = false;
+                return false;
+            }
+            info = infoReply.value();
+        }
+        m_MapCache.insert(key, info);
+    }
+
+    m_Generation = reply.arguments()[1].toULongLong();
+    m_CacheValid = true;
+    return true;
+}
+
+void DBusInterface::invalidateCache()
+{
+    // 回放的信息不会变化，一直有效
+    if (CollectorBundle::getInstance()->isReplaying())
+        return;
+
+    {
+        QMutexLocker locker(&m_CacheMutex);
+        m_CacheValid = false;
+    }
+    QMutexLocker recordsLocker(&m_RecordsMutex);
+    m_RecordsValid = false;
+}
+
+bool DBusInterface::getRecords(const QString &source, QList<QMap<QString, QString> > &records)
+{
+    // 回放时由调用者解析录制的文本
+    if (CollectorBundle::getInstance()->isReplaying())
+        return false;
+
+    // 各个任务并发获取，只有第一个任务调用后台
+    QMutexLocker locker(&m_RecordsMutex);
+    if (!m_RecordsValid) {
+        QStringList sources = RECORD_SOURCES;
+        if (!sources.contains(source))
+            sources.append(source);
+        m_MapRecords.clear();
+        if (!fetchRecords(sources, m_MapRecords))
+            return false;
+        m_RecordsValid = true;
+    }
+
+    records = m_MapRecords.value(source);
+    return true;
+}
+
+bool DBusInterface::getCpuFreq(QMap<int, uint> &mapFreq)
+{
+    if (CollectorBundle::getInstance()->isReplaying())
+        return false;
+
+    QDBusMessage reply = mp_Iface->call("getCpuFreqSamples", static_cast<qulonglong>(m_CpuFreqSeq));
+    if (QDBusMessage::ReplyMessage != reply.type() || reply.arguments().isEmpty())
+        return false;
+
+    // a(txiu)，按序号递增，后面的采样覆盖前面的
+    QMutexLocker locker(&m_CacheMutex);
+    const QDBusArgument argument = reply.arguments().at(0).value<QDBusArgument>();
+    argument.beginArray();
+    while (!argument.atEnd()) {
+        qulonglong seq = 0;
+        qlonglong msec = 0;
+        int cpu = -1;
+        uint khz = 0;
+        argument.beginStructure();
+        argument >> seq >> msec >> cpu >> khz;
+        argument.endStructure();
+        m_MapCpuFreq.insert(cpu, khz);
+        m_CpuFreqSeq = qMax(m_CpuFreqSeq, static_cast<quint64>(seq));
+    }
+    argument.endArray();
+
+    mapFreq = m_MapCpuFreq;
+    return true;
+}
+
 void DBusInterface::refreshInfo()
 {
+    if (CollectorBundle::getInstance()->isReplaying())
+        return;
+
+    // 后台将重新获取信息，缓存已过期
+    invalidateCache();
     mp_Iface->asyncCall("refreshInfo");
 }
 
+bool DBusInterface::fetchRecords(const QStringList &sources, QMap<QString, QList<QMap<QString, QString> > > &mapRecords)
+{
+    QDBusMessage reply = mp_Iface->call("getRecords", sources);
+    if (QDBusMessage::ReplyMessage != reply.type() || reply.arguments().isEmpty())
+        return false;
+
+    // a(sa{ss})，按记录的来源分组，没有记录的来源对应空列表
+    foreach (const QString &source, sources)
+        mapRecords.insert(source, QList<QMap<QString, QString> >());
+    const QDBusArgument argument = reply.arguments().at(0).value<QDBusArgument>();
+    argument.beginArray();
+    while (!argument.atEnd()) {
+        QString recordSource;
+        QMap<QString, QString> map;
+        argument.beginStructure();
+        argument >> recordSource >> map;
+        argument.endStructure();
+        mapRecords[recordSource].append(map);
+    }
+    argument.endArray();
+    return true;
+}
+
+bool DBusInterface::getInfoFromFd(const QString &key, QString &info)
+{
+    if (!(mp_Iface->connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing))
+        return false;
+
+    QDBusReply<QDBusUnixFileDescriptor> reply = mp_Iface->call("getInfoFd", key);
+    if (!reply.isValid() || !reply.value().isValid())
+        return false;
+
+    // 描述符由 reply 持有，离开作用域时关闭
+    int fd = reply.value().fileDescriptor();
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return false;
+    if (st.st_size == 0) {
+        info.clear();
+        return true;
+    }
+
+    // 直接从映射的内存中解码，只在客户端产生一份 UTF-16 信息
+    size_t size = static_cast<size_t>(st.st_size);
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == addr)
+        return false;
+    info = QString::fromUtf8(static_cast<const char *>(addr), static_cast<int>(size));
+    munmap(addr, size);
+    return true;
+}
+
+bool DBusInterface::isLargeKey(const QString &key)
+{
+    // 后台只发布从内核日志提取的 dmesg_facts，不再包含完整的 dmesg，只有 hwinfo 和 lshw 超过 memfd 的阈值
+    return key.startsWith("hwinfo") || key.startsWith("lshw");
+}
+
 void DBusInterface::init()
 {
     // 1. 连接到dbus
@@ -7,6 +7,9 @@
 #define DBUSINTERFACE_H
 
 #include <QObject>
+#include <QMap>
+#include <QMutex>
+#include <QStringList>
 
 #include <mutex>
 
@@ -42,6 +45,34 @@ public:
      */
     bool getInfo(const QString &key, QString &info);
 
+    /**
+     * @brief fetchChangedInfos：一次调用获取上次获取之后变化的所有信息，之后的 getInfo 从缓存中读取
+     * @return 后台是否支持按版本号获取
+     */
+    bool fetchChangedInfos();
+
+    /**
+     * @brief invalidateCache：一轮获取结束或通知后台刷新后，getInfo 和 getRecords 不再使用缓存
+     * 缓存的信息和版本号保留，下一次 fetchChangedInfos 仍然只获取变化的信息
+     */
+    void invalidateCache();
+
+    /**
+     * @brief getRecords：获取后台已解析的记录，不再切分文本
+     * 第一次获取时一次调用取回所有来源的记录，本轮之后的获取从缓存中读取
+     * @param source：如 lshw dmidecode_4
+     * @param records：每条记录的 key -> value
+     * @return 后台是否支持
+     */
+    bool getRecords(const QString &source, QList<QMap<QString, QString> > &records);
+
+    /**
+     * @brief getCpuFreq：获取后台采样的各个cpu的当前频率，只获取上次之后的采样
+     * @param mapFreq：逻辑cpu -> 频率 kHz
+     * @return 后台是否支持
+     */
+    bool getCpuFreq(QMap<int, uint> &mapFreq);
+
     /**
      * @brief refreshInfo 用来通知后台刷新信息
      */
@@ -56,11 +87,43 @@ private:
      */
     void init();
 
+    /**
+     * @brief getInfoFromFd：通过 memfd 获取大的信息，避免经过 dbus-daemon 复制
+     * @param key：命令关键字
+     * @param info：获取的设备信息
+     * @return 是否获取成功
+     */
+    bool getInfoFromFd(const QString &key, QString &info);
+
+    /**
+     * @brief isLargeKey：hwinfo lshw 的信息较大，优先通过 memfd 获取
+     * @param key：命令关键字
+     * @return
+     */
+    static bool isLargeKey(const QString &key);
+
+    /**
+     * @brief fetchRecords：一次调用获取多个来源的记录
+     * @param sources：如 lshw dmidecode_4
+     * @param mapRecords：来源 -> 记录
+     * @return 后台是否支持
+     */
+    bool fetchRecords(const QStringList &sources, QMap<QString, QList<QMap<QString, QString> > > &mapRecords);
+
 private:
     static std::atomic<DBusInterface *> s_Instance;
     static std::mutex m_mutex;
 
     QDBusInterface       *mp_Iface;
+    QMutex               m_CacheMutex;      //<! 保护以下缓存
+    QMap<QString, QString> m_MapCache;      //<! 通过 getChangedInfos 获取的信息
+    quint64              m_Generation;      //<! 缓存对应的后台版本号
+    bool                 m_CacheValid;      //<! 缓存是否可用
+    quint64              m_CpuFreqSeq;      //<! 已获取的最新频率采样序号
+    QMap<int, uint>      m_MapCpuFreq;      //<! 逻辑cpu -> 最新的频率 kHz
+    QMutex               m_RecordsMutex;    //<! 保护以下记录缓存
+    QMap<QString, QList<QMap<QString, QString> > > m_MapRecords;   //<! 来源 -> 后台解析的记录
+    bool                 m_RecordsValid;    //<! 记录缓存是否可用
 };
 
 #endif // DBUSINTERFACE_H
@@ -32,6 +32,24 @@
 // Qt库文件
 #include <QDebug>
 
+/**
+ * @brief The UsbKeys struct : 遍历 hwinfo_usb 时用到的属性id，过滤时只做整数比较
+ */
+struct UsbKeys {
+    const int hardwareClass = CmdRecord::keyId("Hardware Class");
+    const int model = CmdRecord::keyId("Model");
+    const int device = CmdRecord::keyId("Device");
+    const int driver = CmdRecord::keyId("Driver");
+    const int sysfsBusID = CmdRecord::keyId("SysFS BusID");
+    const int uniqueID = CmdRecord::keyId("unique_id");
+};
+
+static const UsbKeys &usbKeys()
+{
+    static UsbKeys s_Keys;
+    return s_Keys;
+}
+
 DeviceGenerator::DeviceGenerator(QObject *parent)
     : QObject(parent)
 {
@@ -268,18 +286,21 @@ void DeviceGenerator::generatorNetworkDevice()
         }
     }
 
-    // 设置从lshw中获取的信息
+    // 设置从lshw中获取的信息，网卡的 unique id 为物理地址，与 lshw 的 serial 匹配
+    QHash<QString, DeviceNetwork *> mapSerial;
+    for (QList<DeviceNetwork *>::const_iterator itDevice = lstDevice.cbegin(); itDevice != lstDevice.cend(); ++itDevice) {
+        if (!(*itDevice)->uniqueID().isEmpty() && !mapSerial.contains((*itDevice)->uniqueID()))
+            mapSerial.insert((*itDevice)->uniqueID(), *itDevice);
+    }
+
     const QList<QMap<QString, QString>> &lstLshw = DeviceManager::instance()->cmdInfo("lshw_network");
     for (QList<QMap<QString, QString> >::const_iterator it = lstLshw.begin(); it != lstLshw.end(); ++it) {
-        if ((*it).find("serial") == (*it).end())
+        QMap<QString, QString>::const_iterator serial = (*it).find("serial");
+        if (serial == (*it).end())
             continue;
-        const QString &serialNumber = (*it)["serial"];
-        for (QList<DeviceNetwork *>::iterator itDevice = lstDevice.begin(); itDevice != lstDevice.end(); ++itDevice) {
-            if (!serialNumber.isEmpty() && (*itDevice)->uniqueID() == serialNumber) {
-                (*itDevice)->setInfoFromLshw(*it);
-                break;
-            }
-        }
+        DeviceNetwork *device = mapSerial.value(serial.value());
+        if (device)
+            device->setInfoFromLshw(*it);
     }
 
     foreach (DeviceNetwork *device, lstDevice) {
@@ -773,30 +794,32 @@ void DeviceGenerator::getBluetoothInfoFromHciconfig()
 void DeviceGenerator::getBlueToothInfoFromHwinfo()
 {
     //  加载从hwinfo中获取的蓝牙信息
-    const QList<QMap<QString, QString>> &lstMap = DeviceManager::instance()->cmdInfo("hwinfo_usb");
-    QList<QMap<QString, QString> >::const_iterator it = lstMap.begin();
-    for (; it != lstMap.end(); ++it) {
-        if ((*it).size() < 1)
+    const UsbKeys &keys = usbKeys();
+    const QList<CmdRecord> &lstRecord = DeviceManager::instance()->cmdRecords("hwinfo_usb");
+    foreach (const CmdRecord &record, lstRecord) {
+        if (record.size() < 1)
             continue;
 
-        if ((*it)["Hardware Class"] == "hub" || (*it)["Hardware Class"] == "mouse" || (*it)["Hardware Class"] == "keyboard")
+        const QString &hardwareClass = record.value(keys.hardwareClass);
+        if (hardwareClass == "hub" || hardwareClass == "mouse" || hardwareClass == "keyboard")
             continue;
 
-        if ((*it)["Model"].contains("bluetooth", Qt::CaseInsensitive) || (*it)["Hardware Class"] == "bluetooth" || (*it)["Driver"] == "btusb" || (*it)["Device"] == "BCM20702A0") {
+        if (record.value(keys.model).contains("bluetooth", Qt::CaseInsensitive) || hardwareClass == "bluetooth" || record.value(keys.driver) == "btusb" || record.value(keys.device) == "BCM20702A0") {
+            const QMap<QString, QString> &mapInfo = record.toMap();
 
             // 判断重复设备数据
-            QString unique_id = uniqueID(*it);
+            QString unique_id = uniqueID(mapInfo);
             DeviceBluetooth *device = dynamic_cast<DeviceBluetooth *>(DeviceManager::instance()->getBluetoothDevice(unique_id));
             if (device) {
                 device->setEnableValue(false);
-                device->setInfoFromHwinfo(*it);
+                device->setInfoFromHwinfo(mapInfo);
                 continue;
             }
 
             device = new DeviceBluetooth();
-            device->setInfoFromHwinfo(*it);
+            device->setInfoFromHwinfo(mapInfo);
             DeviceManager::instance()->addBluetoothDevice(device);
-            addBusIDFromHwinfo((*it)["SysFS BusID"]);
+            addBusIDFromHwinfo(record.value(keys.sysfsBusID));
         }
     }
 }
@@ -897,18 +920,18 @@ void DeviceGenerator::getMouseInfoFromHwinfo()
     }
 
     //  加载从hwinfo --usb中获取的触摸屏信息具有鼠标功能，放到鼠标设备中
-    const QList<QMap<QString, QString>> &lstMapUSB = DeviceManager::instance()->cmdInfo("hwinfo_usb");
-    QList<QMap<QString, QString> >::const_iterator iter = lstMapUSB.begin();
-    for (; iter != lstMapUSB.end(); ++iter) {
-        if ((*iter).size() < 1)
+    const UsbKeys &keys = usbKeys();
+    const QList<CmdRecord> &lstRecordUSB = DeviceManager::instance()->cmdRecords("hwinfo_usb");
+    foreach (const CmdRecord &record, lstRecordUSB) {
+        if (record.size() < 1)
             continue;
 
         // 指定型号触摸屏，显示在鼠标设备中
-        if ((*iter)["Model"].contains("Melfas LGDisplay Incell Touch")) {
+        if (record.value(keys.model).contains("Melfas LGDisplay Incell Touch")) {
             DeviceInput *device = new DeviceInput();
-            device->setInfoFromHwinfo(*iter);
+            device->setInfoFromHwinfo(record.toMap());
             DeviceManager::instance()->addMouseDevice(device);
-            addBusIDFromHwinfo((*iter)["SysFS BusID"]);
+            addBusIDFromHwinfo(record.value(keys.sysfsBusID));
         }
     }
 }
@@ -934,23 +957,26 @@ void DeviceGenerator::getMouseInfoFromCatDevices()
 void DeviceGenerator::getImageInfoFromHwinfo()
 {
     //  加载从hwinfo中获取的图像设备信息
-    const QList<QMap<QString, QString>> &lstMap = DeviceManager::instance()->cmdInfo("hwinfo_usb");
-    QList<QMap<QString, QString> >::const_iterator it = lstMap.begin();
-    for (; it != lstMap.end(); ++it) {
-        if ((*it).size() < 3)
+    const UsbKeys &keys = usbKeys();
+    const QList<CmdRecord> &lstRecord = DeviceManager::instance()->cmdRecords("hwinfo_usb");
+    foreach (const CmdRecord &record, lstRecord) {
+        if (record.size() < 3)
             continue;
 
         // hwinfo中对camera的分类不明确，通过camera等关键字认定图像设备
-        if (!(*it)["Model"].contains("camera", Qt::CaseInsensitive) &&
-                !(*it)["Device"].contains("camera", Qt::CaseInsensitive) &&
-                !(*it)["Driver"].contains("uvcvideo", Qt::CaseInsensitive) &&
-                !(*it)["Model"].contains("webcam", Qt::CaseInsensitive) &&
-                (*it)["Hardware Class"] != "camera") {
+        const QString &model = record.value(keys.model);
+        if (!model.contains("camera", Qt::CaseInsensitive) &&
+                !record.value(keys.device).contains("camera", Qt::CaseInsensitive) &&
+                !record.value(keys.driver).contains("uvcvideo", Qt::CaseInsensitive) &&
+                !model.contains("webcam", Qt::CaseInsensitive) &&
+                record.value(keys.hardwareClass) != "camera") {
             continue;
         }
 
+        const QMap<QString, QString> &mapInfo = record.toMap();
+
         // 判断该摄像头是否存在，被禁用的和被拔出
-        QString path = pciPath(*it);
+        QString path = pciPath(mapInfo);
         if (path.contains("usb")) {
             // 判断authorized是否存在，不存在则直接返回
             if (!QFile::exists("/sys" + path + "/authorized")) {
@@ -959,22 +985,22 @@ void DeviceGenerator::getImageInfoFromHwinfo()
         }
 
         // 判断重复设备数据
-        QString unique_id = uniqueID(*it);
+        QString unique_id = uniqueID(mapInfo);
         DeviceImage *device = dynamic_cast<DeviceImage *>(DeviceManager::instance()->getImageDevice(unique_id));
         if (device) {
             device->setEnableValue(false);
-            device->setInfoFromHwinfo(*it);
+            device->setInfoFromHwinfo(mapInfo);
             continue;
         } else {
-            if ((*it).find("path") != (*it).end()) {
+            if (mapInfo.find("path") != mapInfo.end()) {
                 continue;
             }
         }
 
         device = new DeviceImage();
-        device->setInfoFromHwinfo(*it);
+        device->setInfoFromHwinfo(mapInfo);
         DeviceManager::instance()->addImageDevice(device);
-        addBusIDFromHwinfo((*it)["SysFS BusID"]);
+        addBusIDFromHwinfo(record.value(keys.sysfsBusID));
     }
 }
 
@@ -1023,58 +1049,59 @@ void DeviceGenerator::getCdromInfoFromLshw()
 void DeviceGenerator::getOthersInfoFromHwinfo()
 {
     //  加载从hwinfo中获取的其他设备信息
-    const QList<QMap<QString, QString>> &lstMap = DeviceManager::instance()->cmdInfo("hwinfo_usb");
-    QList<QMap<QString, QString> >::const_iterator it = lstMap.begin();
-    for (; it != lstMap.end(); ++it) {
-        if ((*it).size() < 3)
+    const UsbKeys &keys = usbKeys();
+    const QList<CmdRecord> &lstRecord = DeviceManager::instance()->cmdRecords("hwinfo_usb");
+    foreach (const CmdRecord &record, lstRecord) {
+        if (record.size() < 3)
             continue;
         /*  bug 141439 不可见功能设计需要再次思考*/
-        if ((*it).find("Device") != (*it).end() &&
-                ((*it)["Device"].contains("fingerprint", Qt::CaseInsensitive)  ||
-                 (*it)["Device"].contains("MOH", Qt::CaseInsensitive)
+        const QString &deviceName = record.value(keys.device);
+        if (record.contains(keys.device) &&
+                (deviceName.contains("fingerprint", Qt::CaseInsensitive)  ||
+                 deviceName.contains("MOH", Qt::CaseInsensitive)
                 )) {
             DeviceOthers *device = new DeviceOthers();
             device->setForcedDisplay(true);
-            device->setInfoFromHwinfo(*it);
+            device->setInfoFromHwinfo(record.toMap());
             DeviceManager::instance()->addOthersDevice(device);
             continue;
         }
 
         bool isOtherDevice = true;
-        QString curBus = (*it)["SysFS BusID"];
+        QString curBus = record.value(keys.sysfsBusID);
         curBus.replace(QRegExp("\\.[0-9]{1,2}$"), "");
-        const QStringList &lstBusId = DeviceManager::instance()->getBusId();
         // 判断该设备是否已经在其他类别中显示
-        if ((*it).find("unique_id") != (*it).end() && (*it)["Hardware Class"] != "others") {
+        if (record.contains(keys.uniqueID) && record.value(keys.hardwareClass) != "others") {
             isOtherDevice = false;
-        } else if ((*it).find("unique_id") == (*it).end()) {
-            if (curBus.isEmpty() || lstBusId.indexOf(curBus) != -1)
+        } else if (!record.contains(keys.uniqueID)) {
+            if (curBus.isEmpty() || DeviceManager::instance()->containsBusId(curBus))
                 isOtherDevice = false;
         }
 
         // 添加其他设备
         if (isOtherDevice) {
+            const QMap<QString, QString> &mapInfo = record.toMap();
             // 先判断是否存在
-            QString path = pciPath(*it);
+            QString path = pciPath(mapInfo);
             // 判断authorized是否存在，不存在则直接返回
             if (!QFile::exists("/sys" + path + "/authorized")) {
                 continue;
             }
 
-            QString unique_id = uniqueID(*it);
+            QString unique_id = uniqueID(mapInfo);
             DeviceOthers *device = dynamic_cast<DeviceOthers *>(DeviceManager::instance()->getOthersDevice(unique_id));
             if (device) {
                 device->setEnableValue(false);
                 continue;
             } else {
-                if ((*it).find("path") != (*it).end()) {
+                if (mapInfo.find("path") != mapInfo.end()) {
                     continue;
                 }
             }
 
 
             device = new DeviceOthers();
-            device->setInfoFromHwinfo(*it);
+            device->setInfoFromHwinfo(mapInfo);
             DeviceManager::instance()->addOthersDevice(device);
         }
     }
@@ -1102,11 +1129,13 @@ void DeviceGenerator::addBusIDFromHwinfo(const QString &sysfsBusID)
     QString busID = sysfsBusID;
     busID.replace(QRegExp("\\.[0-9]+$"), "");
 
+    QMutexLocker locker(&m_BusIDMutex);
     m_ListBusID.append(busID);
 }
 
-const QStringList &DeviceGenerator::getBusIDFromHwinfo()
+QStringList DeviceGenerator::getBusIDFromHwinfo()
 {
+    QMutexLocker locker(&m_BusIDMutex);
     return m_ListBusID;
 }
 
@@ -112,7 +112,7 @@ public:
     virtual void generatorPowerDevice();
 
     /**
-     * @brief addBusIDFromHwinfo:添加从hwinfo中获取的BusID
+     * @brief addBusIDFromHwinfo:添加从hwinfo中获取的BusID，一次生成中各类设备共用同一个生成器，线程安全
      * @param sysfsBusID:被添加的BusID
      */
     void addBusIDFromHwinfo(const QString &sysfsBusID);
@@ -121,7 +121,7 @@ public:
      * @brief getBusIDFromHwinfo:获取所有从hwinfo中添加的BusID
      * @return 所有BusID组成的StringList
      */
-    const QStringList &getBusIDFromHwinfo();
+    QStringList getBusIDFromHwinfo();
 
     /**
      * @brief getProductName: 获取系统产品名称
@@ -331,6 +331,7 @@ protected:
 
 protected:
     QStringList m_ListBusID;
+    QMutex      m_BusIDMutex;       //<! 保护 m_ListBusID
 };
 
 #endif // DEVICEGENERATOR_H
@@ -4,15 +4,17 @@
 
 #include "GenerateDevicePool.h"
 
-#include <QDateTime>
 #include <QDebug>
+#include <QMutexLocker>
 
 #include "DeviceGenerator.h"
 #include "DeviceFactory.h"
 #include "DeviceManager.h"
 
-GenerateTask::GenerateTask(DeviceType deviceType)
+GenerateTask::GenerateTask(DeviceType deviceType, DeviceGenerator *generator, GenerateDevicePool *parent)
     : m_Type(deviceType)
+    , mp_Generator(generator)
+    , mp_Parent(parent)
 {
 
 }
@@ -24,11 +26,26 @@ GenerateTask::~GenerateTask()
 
 void GenerateTask::run()
 {
-    DeviceGenerator *generator = DeviceFactory::getDeviceGenerator();
+    if (mp_Generator) {
+        generate(mp_Generator);
+    } else {
+        DeviceGenerator *generator = DeviceFactory::getDeviceGenerator();
+        if (!generator)
+            return;
+
+        generate(generator);
+        DeviceManager::instance()->addBusId(generator->getBusIDFromHwinfo());
+        delete generator;
+        generator = nullptr;
+    }
 
-    if (!generator)
-        return;
+    // 通知依赖该类型的任务
+    if (mp_Parent)
+        mp_Parent->finishedTask(m_Type);
+}
 
+void GenerateTask::generate(DeviceGenerator *generator)
+{
     switch (m_Type) {
     case DT_Computer:
         generator->generatorComputerDevice();
@@ -84,47 +101,63 @@ void GenerateTask::run()
     default:
         break;
     }
-
-    emit finished(generator->getBusIDFromHwinfo());
-    delete generator;
-    generator = nullptr;
 }
 
 
 GenerateDevicePool::GenerateDevicePool()
     : QThreadPool()
+    , mp_Generator(nullptr)
+    , m_FinishedGenerator(0)
 {
     initType();
 }
 
 void GenerateDevicePool::generateDevice()
 {
-    m_FinishedGenerator = 0;
-
-    QList<DeviceType>::iterator it = m_TypeList.begin();
-    for (; it != m_TypeList.end(); ++it) {
-        GenerateTask *task = new GenerateTask((*it));
-        connect(task, &GenerateTask::finished, this, &GenerateDevicePool::slotFinished);
-        QThreadPool::globalInstance()->start(task);
-//        task->setAutoDelete(true);
+    // 一次生成中所有任务共用一个生成器
+    mp_Generator = DeviceFactory::getDeviceGenerator();
+    if (!mp_Generator)
+        return;
+
+    QList<DeviceType> lstReady;
+    {
+        QMutexLocker locker(&m_Mutex);
+        m_FinishedGenerator = 0;
+        m_PendingDepend.clear();
+        foreach (DeviceType type, m_TypeList) {
+            int pending = m_DependList.value(type).size();
+            m_PendingDepend.insert(type, pending);
+            if (0 == pending)
+                lstReady.append(type);
+        }
     }
 
-    // 当所有设备执行完毕之后，开始执行生成其它设备的任务
-    // 这里是为了确保其它设备在最后一个生成
-    qint64 beginMSecond = QDateTime::currentMSecsSinceEpoch();
-    while (true) {
-        qint64 curMSecond = QDateTime::currentMSecsSinceEpoch();
-        if (m_FinishedGenerator == m_TypeList.size()  || curMSecond - beginMSecond > 4000) {
-            DeviceGenerator *generator = DeviceFactory::getDeviceGenerator();
-            generator->generatorOthersDevice();
+    // 没有依赖的任务先并行执行，其余任务在依赖全部完成时由 finishedTask 启动
+    foreach (DeviceType type, lstReady)
+        startTask(type);
+
+    // 后启动的任务在前一个任务结束之前加入线程池，全部完成后才返回
+    waitForDone(-1);
 
-            // 指针使用结束释放
-            delete generator;
-            generator = nullptr;
+    delete mp_Generator;
+    mp_Generator = nullptr;
+}
 
-            break;
+void GenerateDevicePool::finishedTask(DeviceType type)
+{
+    QList<DeviceType> lstReady;
+    {
+        QMutexLocker locker(&m_Mutex);
+        ++m_FinishedGenerator;
+        QMap<DeviceType, QList<DeviceType> >::const_iterator it = m_DependList.cbegin();
+        for (; it != m_DependList.cend(); ++it) {
+            if (it.value().contains(type) && 0 == --m_PendingDepend[it.key()])
+                lstReady.append(it.key());
         }
     }
+
+    foreach (DeviceType ready, lstReady)
+        startTask(ready);
 }
 
 void GenerateDevicePool::initType()
@@ -145,11 +178,18 @@ void GenerateDevicePool::initType()
     m_TypeList.push_back(DT_Print);
     m_TypeList.push_back(DT_Cdrom);
     m_TypeList.push_back(DT_Power);
-//    m_TypeList.push_back(DT_Others);
+
+    // 其它设备排除已经在其它类别中显示的总线ID和存储设备，依赖其它所有类型
+    m_DependList.insert(DT_Others, m_TypeList);
+    m_TypeList.push_back(DT_Others);
 }
 
-void GenerateDevicePool::slotFinished(const QStringList &lst)
+void GenerateDevicePool::startTask(DeviceType type)
 {
-    DeviceManager::instance()->addBusId(lst);
-    m_FinishedGenerator++;
+    // 其它设备开始前，所有类型的总线ID都已生成
+    if (DT_Others == type)
+        DeviceManager::instance()->addBusId(mp_Generator->getBusIDFromHwinfo());
+
+    GenerateTask *task = new GenerateTask(type, mp_Generator, this);
+    start(task);
 }
@@ -9,6 +9,10 @@
 #include <QObject>
 #include <QThreadPool>
 #include <QMutex>
+#include <QMap>
+
+class DeviceGenerator;
+class GenerateDevicePool;
 
 /**
  * @brief The DeviceType enum
@@ -45,14 +49,26 @@ class GenerateTask: public QObject, public QRunnable
     Q_OBJECT
 
 public:
-    GenerateTask(DeviceType deviceType);
+    /**
+     * @brief GenerateTask
+     * @param deviceType : 设备类型
+     * @param generator : 本次生成共用的生成器，nullptr 时任务自己创建
+     * @param parent : 任务结束后通知 parent 启动依赖该类型的任务
+     */
+    explicit GenerateTask(DeviceType deviceType, DeviceGenerator *generator = nullptr, GenerateDevicePool *parent = nullptr);
     ~GenerateTask();
-signals:
-    void finished(const QStringList &lst);
 protected:
     void run();
+private:
+    /**
+     * @brief generate : 生成一类设备
+     */
+    void generate(DeviceGenerator *generator);
+
 private:
     DeviceType           m_Type;
+    DeviceGenerator      *mp_Generator;
+    GenerateDevicePool   *mp_Parent;
 };
 
 
@@ -64,26 +80,34 @@ public:
     GenerateDevicePool();
 
     /**
-     * @brief generateDevice
+     * @brief generateDevice : 按依赖关系生成所有设备，全部生成后返回
      */
     void generateDevice();
 
+    /**
+     * @brief finishedTask : 任务结束，启动依赖已全部完成的任务
+     * @param type : 已完成的设备类型
+     */
+    void finishedTask(DeviceType type);
+
 private:
     /**
-     * @brief initType
+     * @brief initType : 初始化设备类型及其依赖
      */
     void initType();
 
-private slots:
     /**
-     * @brief slotFinished : end operation
-     * @param lst
+     * @brief startTask : 启动一类设备的生成任务
      */
-    void slotFinished(const QStringList &lst);
+    void startTask(DeviceType type);
 
 private:
-    QList<DeviceType>            m_TypeList;
-    int                          m_FinishedGenerator;
+    QList<DeviceType>                       m_TypeList;             //<! 所有设备类型
+    QMap<DeviceType, QList<DeviceType> >    m_DependList;           //<! 设备类型 -> 必须先完成的设备类型
+    QMap<DeviceType, int>                   m_PendingDepend;        //<! 本次生成中尚未完成的依赖个数
+    DeviceGenerator                         *mp_Generator;          //<! 本次生成共用的生成器
+    int                                     m_FinishedGenerator;    //<! 本次生成已完成的任务个数
+    QMutex                                  m_Mutex;                //<! 保护依赖计数
 };
 
 #endif // GENERATEDEVICEPOOL_H
@@ -7,8 +7,11 @@
 #include <QObjectCleanupHandler>
 #include <QDebug>
 
+#include <utility>
+
 #include "CmdTool.h"
 #include "DeviceManager.h"
+#include "DBusInterface.h"
 
 static QMutex mutex;
 
@@ -30,8 +33,8 @@ void CmdTask::run()
 {
     CmdTool tool;
     tool.loadCmdInfo(m_Key, m_File);
-    const QMap<QString, QList<QMap<QString, QString> > > &cmdInfo = tool.cmdInfo();
-    mp_Parent->finishedCmd(m_Info, cmdInfo);
+    // 解析结果整体移交，不再复制
+    mp_Parent->finishedCmd(m_Info, std::move(tool.cmdInfo()));
 }
 
 GetInfoPool::GetInfoPool()
@@ -45,6 +48,9 @@ void GetInfoPool::getAllInfo()
 {
     DeviceManager::instance()->clear();
 
+    // 一次DBus调用获取所有变化的信息，各个任务从缓存中读取
+    DBusInterface::getInstance()->fetchChangedInfos();
+
     QList<QStringList>::iterator it = m_CmdList.begin();
     for (; it != m_CmdList.end(); ++it) {
         CmdTask *task = new CmdTask((*it)[0], (*it)[1], (*it)[2], this);
@@ -53,12 +59,14 @@ void GetInfoPool::getAllInfo()
     }
 }
 
-void GetInfoPool::finishedCmd(const QString &info, const QMap<QString, QList<QMap<QString, QString> > > &cmdInfo)
+void GetInfoPool::finishedCmd(const QString &info, QMap<QString, QList<QMap<QString, QString> > > cmdInfo)
 {
-    DeviceManager::instance()->addCmdInfo(cmdInfo);
+    DeviceManager::instance()->addCmdInfo(std::move(cmdInfo));
     QMutexLocker m_lock(&mutex);
     m_FinishedNum++;
     if (m_FinishedNum == m_CmdList.size()) {
+        // 缓存只在本轮获取中使用，之后的刷新和热插拔需要重新获取
+        DBusInterface::getInstance()->invalidateCache();
         emit finishedAll(info);
         m_FinishedNum = 0;
     }
@@ -83,7 +91,6 @@ void GetInfoPool::initCmd()
     m_CmdList.append({ "dmidecode13",          "dmidecode_13.txt",       ""});
     m_CmdList.append({ "dmidecode16",          "dmidecode_16.txt",       ""});
     m_CmdList.append({ "dmidecode17",          "dmidecode_17.txt",       ""});
-    m_CmdList.append({"dr_config", "dr_config.txt", ""});
 
     m_CmdList.append({ "hwinfo_monitor",       "hwinfo_monitor.txt",     tr("Loading CD-ROM Info...")});
     m_CmdList.append({ "hwinfo",         "hwinfo.txt",       ""});
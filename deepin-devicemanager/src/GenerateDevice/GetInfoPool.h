@@ -46,9 +46,9 @@ public:
     /**
      * @brief finishedCmd
      * @param info
-     * @param cmdInfo
+     * @param cmdInfo : 任务解析的结果，移交给 DeviceManager
      */
-    void finishedCmd(const QString &info, const QMap<QString, QList<QMap<QString, QString> > > &cmdInfo);
+    void finishedCmd(const QString &info, QMap<QString, QList<QMap<QString, QString> > > cmdInfo);
     /**
      * @brief setFramework：设置架构
      * @param arch:架构
@@ -171,18 +171,21 @@ void HWGenerator::generatorNetworkDevice()
         }
     }
 
-    // 设置从lshw中获取的信息
+    // 设置从lshw中获取的信息，网卡的 unique id 为物理地址，与 lshw 的 serial 匹配
+    QHash<QString, DeviceNetwork *> mapSerial;
+    for (QList<DeviceNetwork *>::const_iterator itDevice = lstDevice.cbegin(); itDevice != lstDevice.cend(); ++itDevice) {
+        if (!(*itDevice)->uniqueID().isEmpty() && !mapSerial.contains((*itDevice)->uniqueID()))
+            mapSerial.insert((*itDevice)->uniqueID(), *itDevice);
+    }
+
     const QList<QMap<QString, QString>> &lstLshw = DeviceManager::instance()->cmdInfo("lshw_network");
     for (QList<QMap<QString, QString> >::const_iterator it = lstLshw.begin(); it != lstLshw.end(); ++it) {
-        if ((*it).find("serial") == (*it).end())
+        QMap<QString, QString>::const_iterator serial = (*it).find("serial");
+        if (serial == (*it).end())
             continue;
-        const QString &serialNumber = (*it)["serial"];
-        for (QList<DeviceNetwork *>::iterator itDevice = lstDevice.begin(); itDevice != lstDevice.end(); ++itDevice) {
-            if (!serialNumber.isEmpty() && (*itDevice)->uniqueID() == serialNumber) {
-                (*itDevice)->setInfoFromLshw(*it);
-                break;
-            }
-        }
+        DeviceNetwork *device = mapSerial.value(serial.value());
+        if (device)
+            device->setInfoFromLshw(*it);
     }
 
     foreach (DeviceNetwork *device, lstDevice) {
@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "HwinfoParser.h"
+
+#include <string.h>
+
+/**
+ * @brief isSpace : the same as QChar::isSpace for ASCII
+ */
+static inline bool isSpace(char c)
+{
+    return ' ' == c || '\t' == c || '\n' == c || '\r' == c || '\v' == c || '\f' == c;
+}
+
+/**
+ * @brief trim : trim the spaces of [begin, end)
+ */
+static inline void trim(const char *&begin, const char *&end)
+{
+    while (begin < end && isSpace(*begin))
+        ++begin;
+    while (end > begin && isSpace(end[-1]))
+        --end;
+}
+
+/**
+ * @brief find : memmem of [begin, end)
+ */
+static inline const char *find(const char *begin, const char *end, const char *needle, size_t size)
+{
+    if (end <= begin)
+        return nullptr;
+    return static_cast<const char *>(memmem(begin, static_cast<size_t>(end - begin), needle, size));
+}
+
+/**
+ * @brief contains
+ */
+static inline bool contains(const char *begin, const char *end, const char *needle)
+{
+    return nullptr != find(begin, end, needle, strlen(needle));
+}
+
+/**
+ * @brief fieldValue : the value of the key, appended if not exist, the same as QMap::operator[]
+ */
+static QString &fieldValue(HwinfoRecord &record, QLatin1String key)
+{
+    int index = record.indexOf(key);
+    if (index < 0) {
+        HwinfoField field;
+        field.key = key;
+        record.fields.append(field);
+        index = record.fields.size() - 1;
+    }
+    return record.fields[index].value;
+}
+
+int HwinfoRecord::indexOf(QLatin1String key) const
+{
+    for (int i = 0; i < fields.size(); ++i) {
+        if (fields[i].key == key)
+            return i;
+    }
+    return -1;
+}
+
+QString HwinfoRecord::value(QLatin1String key) const
+{
+    int index = indexOf(key);
+    return index < 0 ? QString() : fields[index].value;
+}
+
+QMap<QString, QString> HwinfoRecord::toMap() const
+{
+    QMap<QString, QString> mapInfo;
+    foreach (const HwinfoField &field, fields)
+        mapInfo.insert(field.key, field.value);
+    return mapInfo;
+}
+
+HwinfoParser::HwinfoParser(const QByteArray &data)
+    : m_Data(data)
+{
+    // 记录之间以空行分隔
+    const char *pos = m_Data.constData();
+    const char *end = pos + m_Data.size();
+    while (pos < end) {
+        const char *next = find(pos, end, "\n\n", 2);
+        if (!next)
+            next = end;
+        if (next > pos)
+            parseRecord(pos, next);
+        pos = next + 2;
+    }
+}
+
+const QVector<HwinfoRecord> &HwinfoParser::records() const
+{
+    return m_Records;
+}
+
+void HwinfoParser::parseRecord(const char *begin, const char *end)
+{
+    HwinfoRecord record;
+    record.fields.reserve(32);
+    QString vid;
+    while (begin < end) {
+        const char *eol = static_cast<const char *>(memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        if (!eol)
+            eol = end;
+        parseLine(begin, eol, record, vid);
+        begin = eol + 1;
+    }
+
+    // Module Alias 去掉最后10个字符的序列号
+    int index = record.indexOf(QLatin1String("Module Alias"));
+    if (index >= 0) {
+        QString &alias = record.fields[index].value;
+        int n = 0;
+        while (n < 10 && n < alias.size()) {
+            ushort c = alias[alias.size() - 1 - n].unicode();
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')))
+                break;
+            ++n;
+        }
+        if (10 == n)
+            alias.chop(10);
+    }
+    m_Records.append(record);
+}
+
+void HwinfoParser::parseLine(const char *begin, const char *end, HwinfoRecord &record, QString &vid)
+{
+    static const char *s_Ps2Value = "PS/2";
+
+    QLatin1String key;
+    const char *valueBegin = nullptr;
+    const char *valueEnd = nullptr;
+    if (contains(begin, end, "PS/2 Mouse")) {
+        key = QLatin1String("Hotplug");
+        valueBegin = s_Ps2Value;
+        valueEnd = s_Ps2Value + 4;
+    } else {
+        // 只有一个 ": " 的行才是属性
+        const char *sep = find(begin, end, ": ", 2);
+        if (!sep || find(sep + 2, end, ": ", 2))
+            return;
+        const char *keyBegin = begin;
+        const char *keyEnd = sep;
+        trim(keyBegin, keyEnd);
+        key = QLatin1String(keyBegin, static_cast<int>(keyEnd - keyBegin));
+        valueBegin = sep + 2;
+        valueEnd = end;
+    }
+    trim(valueBegin, valueEnd);
+
+    int index = record.indexOf(key);
+    if (index >= 0)
+        record.fields[index].value += QLatin1Char(' ');
+
+    // Vendor: pci 0x8086 "Intel Corporation" 中取出 VID PID
+    QLatin1String idKey;
+    if (key == QLatin1String("SubDevice"))
+        idKey = QLatin1String("PsubID");
+    else if (key == QLatin1String("SubVendor"))
+        idKey = QLatin1String("VsubID");
+    else if (key == QLatin1String("Vendor"))
+        idKey = QLatin1String("VID");
+    else if (key == QLatin1String("Device"))
+        idKey = QLatin1String("PID");
+    if (idKey.size() > 0 && valueEnd > valueBegin
+            && !contains(valueBegin, valueEnd, "unknown") && contains(valueBegin, valueEnd, "0x")) {
+        const char *space = static_cast<const char *>(memchr(valueBegin, ' ', static_cast<size_t>(valueEnd - valueBegin)));
+        if (space) {
+            const char *wordBegin = space + 1;
+            const char *wordEnd = static_cast<const char *>(memchr(wordBegin, ' ', static_cast<size_t>(valueEnd - wordBegin)));
+            if (!wordEnd)
+                wordEnd = valueEnd;
+            trim(wordBegin, wordEnd);
+            QString word = QString::fromLatin1(wordBegin, static_cast<int>(wordEnd - wordBegin));
+            fieldValue(record, idKey) += word;
+
+            if (idKey == QLatin1String("VID")) {
+                vid = word;
+            } else if (idKey == QLatin1String("PID") && !vid.isEmpty()) {
+                fieldValue(record, QLatin1String("VID_PID")) += vid + word.remove("0x");
+                vid.clear();
+            }
+        }
+    }
+
+    // 取第一个和最后一个引号之间的内容
+    const char *first = static_cast<const char *>(memchr(valueBegin, '"', static_cast<size_t>(valueEnd - valueBegin)));
+    const char *last = static_cast<const char *>(memrchr(valueBegin, '"', static_cast<size_t>(valueEnd - valueBegin)));
+    if (first && last > first) {
+        // 如果信息中有unknown 则过滤
+        if (contains(first + 1, last, "unknown"))
+            return;
+        QString value = QString::fromUtf8(first + 1, static_cast<int>(last - first - 1));
+        // 这里是为了防止  "usb-storage", "sr"  -》 usb-storage", "sr
+        if (key == QLatin1String("Driver") || key == QLatin1String("Driver Modules"))
+            value.remove(QLatin1Char('"'));
+        fieldValue(record, key) += value;
+    } else if (key == QLatin1String("Resolution")) {
+        fieldValue(record, key) += QString::fromUtf8(valueBegin, static_cast<int>(valueEnd - valueBegin));
+    } else if (!contains(valueBegin, valueEnd, "unknown")) {
+        fieldValue(record, key) = QString::fromUtf8(valueBegin, static_cast<int>(valueEnd - valueBegin));
+    }
+}
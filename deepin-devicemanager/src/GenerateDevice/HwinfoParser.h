@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HWINFOPARSER_H
+#define HWINFOPARSER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QMap>
+
+/**
+ * @brief The HwinfoField struct : 一个属性，key 直接指向 hwinfo 的原始数据
+ */
+struct HwinfoField {
+    QLatin1String   key;        //<! Hardware Class, Unique ID, SysFS ID, Model ...
+    QString         value;      //<! 解析后的值
+};
+
+/**
+ * @brief The HwinfoRecord struct : 一段 hwinfo 信息，属性按出现的顺序保存
+ */
+struct HwinfoRecord {
+    /**
+     * @brief indexOf
+     * @param key
+     * @return -1 if not found
+     */
+    int indexOf(QLatin1String key) const;
+
+    /**
+     * @brief value
+     * @param key
+     * @return empty if not found
+     */
+    QString value(QLatin1String key) const;
+
+    /**
+     * @brief toMap : the same map as CmdTool::getMapInfoFromHwinfo
+     * @return
+     */
+    QMap<QString, QString> toMap() const;
+
+    QVector<HwinfoField>    fields;     //<! 属性
+};
+
+/**
+ * @brief The HwinfoParser class
+ * 一次遍历 hwinfo 输出的 UTF-8 数据，按空行切分为记录，不生成中间的 QStringList，也不使用正则表达式，
+ * 解析规则与 CmdTool::getMapInfoFromHwinfo 相同。记录的 key 指向 m_Data，parser 需要比记录存活更久
+ */
+class HwinfoParser
+{
+public:
+    explicit HwinfoParser(const QByteArray &data);
+
+    /**
+     * @brief records
+     * @return
+     */
+    const QVector<HwinfoRecord> &records() const;
+
+private:
+    /**
+     * @brief parseRecord : the lines between two blank lines
+     */
+    void parseRecord(const char *begin, const char *end);
+
+    /**
+     * @brief parseLine : Key: value
+     * @param vid : the VID of the record, used by VID_PID
+     */
+    static void parseLine(const char *begin, const char *end, HwinfoRecord &record, QString &vid);
+
+private:
+    QByteArray                  m_Data;         //<! hwinfo 输出，隐式共享，不复制
+    QVector<HwinfoRecord>       m_Records;      //<! 解析结果
+};
+
+#endif // HWINFOPARSER_H
@@ -177,8 +177,7 @@ void KLUGenerator::getOthersInfoFromHwinfo()
         bool isOtherDevice = true;
         QString curBus = (*it)["SysFS BusID"];
         curBus.replace(QRegExp("\\.[0-9]{1,2}$"), "");
-        const QStringList &lstBusId = DeviceManager::instance()->getBusId();
-        if (lstBusId.indexOf(curBus) != -1)
+        if (DeviceManager::instance()->containsBusId(curBus))
             isOtherDevice = false;
 
         if ((*it)["Driver"].contains("usb-storage"))
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CollectorBundle.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QRegExp>
+#include <QDebug>
+
+std::atomic<CollectorBundle *> CollectorBundle::s_Instance;
+std::mutex CollectorBundle::m_mutex;
+
+CollectorBundle::CollectorBundle()
+    : m_Capturing(false)
+    , m_Replaying(false)
+{
+    // 回放优先，避免把回放的结果再录制一遍
+    QString replay = QString::fromLocal8Bit(qgetenv(REPLAY_DIR_ENV));
+    QString capture = QString::fromLocal8Bit(qgetenv(CAPTURE_DIR_ENV));
+    if (!replay.isEmpty()) {
+        m_Replaying = true;
+        m_Dir = replay;
+    } else if (!capture.isEmpty()) {
+        m_Capturing = true;
+        m_Dir = capture;
+    }
+}
+
+bool CollectorBundle::isCapturing()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Capturing;
+}
+
+bool CollectorBundle::isReplaying()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Replaying;
+}
+
+void CollectorBundle::setReplayDir(const QString &dir)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Capturing = false;
+    m_Replaying = !dir.isEmpty();
+    m_Dir = dir;
+}
+
+bool CollectorBundle::replayInfos(QMap<QString, QString> &infos)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (!m_Replaying)
+        return false;
+
+    QDir dir(m_Dir + "/info");
+    if (!dir.exists())
+        return false;
+
+    infos.clear();
+    QStringList names = dir.entryList(QStringList() << "*.txt", QDir::Files, QDir::Name);
+    foreach (const QString &name, names) {
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        infos.insert(name.left(name.size() - 4), QString::fromUtf8(file.readAll()));
+    }
+    return true;
+}
+
+bool CollectorBundle::replayCmd(const QString &cmd, QString &info)
+{
+    QMutexLocker locker(&m_Mutex);
+    info.clear();
+    QFile file(cmdFile(cmd));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    info = QString::fromUtf8(file.readAll());
+    return true;
+}
+
+void CollectorBundle::captureCmd(const QString &cmd, const QString &info)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (m_Capturing)
+        writeFile(cmdFile(cmd), info.toUtf8());
+}
+
+QString CollectorBundle::filePath(const QString &path)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (!m_Replaying)
+        return path;
+    return m_Dir + "/fs" + path;
+}
+
+void CollectorBundle::captureFile(const QString &path, const QByteArray &data)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (m_Capturing)
+        writeFile(m_Dir + "/fs" + path, data);
+}
+
+QString CollectorBundle::replayArch()
+{
+    QMutexLocker locker(&m_Mutex);
+    if (!m_Replaying)
+        return QString();
+    QFile file(m_Dir + "/arch");
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+    return QString::fromLocal8Bit(file.readAll()).trimmed();
+}
+
+void CollectorBundle::captureArch(const QString &arch)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (m_Capturing && !QFile::exists(m_Dir + "/arch"))
+        writeFile(m_Dir + "/arch", arch.toLocal8Bit() + "\n");
+}
+
+QString CollectorBundle::cmdFile(const QString &cmd)
+{
+    QString name = cmd.simplified();
+    name.replace(QRegExp("[\\s/]"), "_");
+    return QString("%1/cmd/%2.txt").arg(m_Dir).arg(name);
+}
+
+void CollectorBundle::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(data);
+        if (file.commit())
+            return;
+    }
+    qWarning() << "Failed to capture :" << path;
+}
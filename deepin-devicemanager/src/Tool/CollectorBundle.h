@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COLLECTORBUNDLE_H
+#define COLLECTORBUNDLE_H
+
+#include <QString>
+#include <QMap>
+#include <QMutex>
+
+#include <mutex>
+#include <atomic>
+
+#define CAPTURE_DIR_ENV "DEVICEMANAGER_CAPTURE_DIR"    // 与后台相同，设置后保存客户端执行的命令和读取的文件
+#define REPLAY_DIR_ENV  "DEVICEMANAGER_REPLAY_DIR"     // 与后台相同，设置后不通过dbus获取，直接从该目录读取
+
+/**
+ * @brief The CollectorBundle class
+ * 与后台共用一个录制目录：
+ *   info/<key>.txt   后台的采集结果，回放时代替 dbus 获取的信息
+ *   cmd/<cmd>.txt    客户端执行的命令的输出
+ *   fs/<path>        客户端直接读取的文件
+ *   arch             录制机器的架构，决定使用哪一个生成器
+ */
+class CollectorBundle
+{
+public:
+    inline static CollectorBundle *getInstance()
+    {
+        // 利用原子变量解决，单例模式造成的内存泄露
+        CollectorBundle *sin = s_Instance.load();
+
+        if (!sin) {
+            // std::lock_guard 自动加锁解锁
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sin = s_Instance.load();
+
+            if (!sin) {
+                sin = new CollectorBundle();
+                s_Instance.store(sin);
+            }
+        }
+
+        return sin;
+    }
+
+    /**
+     * @brief isCapturing
+     * @return
+     */
+    bool isCapturing();
+
+    /**
+     * @brief isReplaying
+     * @return
+     */
+    bool isReplaying();
+
+    /**
+     * @brief setReplayDir : replay another bundle, used by the benchmark
+     * @param dir : empty to stop replaying
+     */
+    void setReplayDir(const QString &dir);
+
+    /**
+     * @brief replayInfos : all info/<key>.txt of the bundle
+     * @param infos : key -> info
+     * @return
+     */
+    bool replayInfos(QMap<QString, QString> &infos);
+
+    /**
+     * @brief replayCmd : the captured output of the cmd
+     * @param cmd
+     * @param info
+     * @return false if not captured
+     */
+    bool replayCmd(const QString &cmd, QString &info);
+
+    /**
+     * @brief captureCmd
+     * @param cmd
+     * @param info
+     */
+    void captureCmd(const QString &cmd, const QString &info);
+
+    /**
+     * @brief filePath : the path in the bundle when replaying
+     * @param path : /proc/bus/input/devices ...
+     * @return
+     */
+    QString filePath(const QString &path);
+
+    /**
+     * @brief captureFile
+     * @param path
+     * @param data
+     */
+    void captureFile(const QString &path, const QByteArray &data);
+
+    /**
+     * @brief replayArch
+     * @return : empty if not replaying or not captured
+     */
+    QString replayArch();
+
+    /**
+     * @brief captureArch
+     * @param arch
+     */
+    void captureArch(const QString &arch);
+
+protected:
+    CollectorBundle();
+
+private:
+    /**
+     * @brief cmdFile : cmd/<cmd>.txt, the spaces and slashes of the cmd are replaced with _
+     */
+    QString cmdFile(const QString &cmd);
+
+    /**
+     * @brief writeFile
+     */
+    static void writeFile(const QString &path, const QByteArray &data);
+
+private:
+    static std::atomic<CollectorBundle *> s_Instance;
+    static std::mutex m_mutex;
+
+    QMutex      m_Mutex;            //<! 保护以下成员
+    bool        m_Capturing;        //<! 是否录制
+    bool        m_Replaying;        //<! 是否回放
+    QString     m_Dir;              //<! bundle directory
+};
+
+#endif // COLLECTORBUNDLE_H
@@ -10,6 +10,7 @@
 
 #include "DeviceManager.h"
 #include "DeviceCpu.h"
+#include "DBusInterface.h"
 
 LoadCpuInfoThread::LoadCpuInfoThread()
 {
@@ -17,6 +18,12 @@ LoadCpuInfoThread::LoadCpuInfoThread()
 
 void LoadCpuInfoThread::run()
 {
+    // 优先使用后台的频率采样，后台不支持时执行lscpu
+    QMap<int, uint> mapFreq;
+    if (DBusInterface::getInstance()->getCpuFreq(mapFreq) && !mapFreq.isEmpty()) {
+        DeviceManager::instance()->setCpuCurFreq(mapFreq);
+        return;
+    }
     getCpuInfoFromLscpu();
 }
 
@@ -6,6 +6,7 @@
 #include "commonfunction.h"
 #include "commondefine.h"
 #include "DBusInterface.h"
+#include "CollectorBundle.h"
 
 // 其它头文件
 #include <QString>
@@ -29,11 +30,16 @@ static QString boardVendorKey = "";
 
 QString Common::getArch()
 {
-    QString arch;
+    // 回放时使用录制机器的架构
+    QString arch = CollectorBundle::getInstance()->replayArch();
+    if (!arch.isEmpty())
+        return arch;
+
     struct utsname utsbuf;
     if (-1 != uname(&utsbuf)) {
         arch = QString::fromLocal8Bit(utsbuf.machine);
     }
+    CollectorBundle::getInstance()->captureArch(arch);
     return arch;
 }
 
@@ -119,6 +119,27 @@ TEST_F(UT_DeviceInfo, UT_DeviceInfo_setAttribute)
     EXPECT_STREQ("abc@123", value.toStdString().c_str());
 }
 
+TEST_F(UT_DeviceInfo, UT_DeviceInfo_lshwJoinKeys)
+{
+    QMap<QString, QString> mapinfo;
+    mapinfo.insert("bus info", "pci@0000:01:00.0");
+    QStringList keys = DeviceBaseInfo::lshwJoinKeys(mapinfo);
+    EXPECT_EQ(QStringList() << "0000:01:00.0" << "pci@0000:01:00.0", keys);
+
+    mapinfo.insert("bus info", "usb@1:8");
+    mapinfo.insert("logical name", "enp2s0");
+    mapinfo.insert("serial", "00:e0:4c:68:00:01");
+    keys = DeviceBaseInfo::lshwJoinKeys(mapinfo);
+    EXPECT_EQ(QStringList() << "00:e0:4c:68:00:01" << "usb@1:8", keys);
+
+    // 与 matchToLshw 的结果一致
+    audio->m_HwinfoToLshw = "usb@1:8";
+    EXPECT_TRUE(audio->matchToLshw(mapinfo));
+    audio->m_HwinfoToLshw = "0000:01:00.0";
+    EXPECT_FALSE(audio->matchToLshw(mapinfo));
+    EXPECT_TRUE(DeviceBaseInfo::lshwJoinKeys(QMap<QString, QString>()).isEmpty());
+}
+
 TEST_F(UT_DeviceInfo, UT_DeviceInfo_mapInfoToList)
 {
     m_deviceBaseInfo = dynamic_cast<DeviceBaseInfo *>(audio);
@@ -28,6 +28,9 @@
 #include <QCoreApplication>
 #include <QPaintEvent>
 #include <QPainter>
+
+#include <thread>
+#include <vector>
 #include <QIODevice>
 
 #include <gtest/gtest.h>
@@ -37,16 +40,20 @@ class UT_DeviceManager : public UT_HEAD
 public:
     void SetUp()
     {
+        // 每个用例从空的命令信息开始，不依赖执行顺序
+        DeviceManager::instance()->clearCmdInfo();
     }
     void TearDown()
     {
+        // 用例直接修改了设备列表，重建索引
+        DeviceManager::instance()->resetShards();
     }
 };
 
 TEST_F(UT_DeviceManager, UT_DeviceManager_clear)
 {
     DeviceManager::instance()->clear();
-    EXPECT_EQ(0, DeviceManager::instance()->m_cmdInfo.size());
+    EXPECT_EQ(nullptr, DeviceManager::instance()->m_CmdSlots.load());
     EXPECT_EQ(0, DeviceManager::instance()->m_ListDeviceMouse.size());
     EXPECT_EQ(0, DeviceManager::instance()->m_ListDeviceStorage.size());
     EXPECT_EQ(0, DeviceManager::instance()->m_ListDeviceMonitor.size());
@@ -669,6 +676,7 @@ TEST_F(UT_DeviceManager, UT_DeviceManager_addBusId)
     EXPECT_EQ(1, DeviceManager::instance()->m_BusIdList.size());
 
     DeviceManager::instance()->m_BusIdList.clear();
+    DeviceManager::instance()->m_BusIdSet.clear();
 }
 
 TEST_F(UT_DeviceManager, UT_DeviceManager_getBusId)
@@ -679,7 +687,10 @@ TEST_F(UT_DeviceManager, UT_DeviceManager_getBusId)
     QStringList ret = DeviceManager::instance()->getBusId();
 
     EXPECT_EQ(1, ret.size());
+    EXPECT_TRUE(DeviceManager::instance()->containsBusId("bus"));
+    EXPECT_FALSE(DeviceManager::instance()->containsBusId("usb"));
     DeviceManager::instance()->m_BusIdList.clear();
+    DeviceManager::instance()->m_BusIdSet.clear();
 }
 
 TEST_F(UT_DeviceManager, UT_DeviceManager_addCmdInfo_001)
@@ -691,8 +702,8 @@ TEST_F(UT_DeviceManager, UT_DeviceManager_addCmdInfo_001)
     QMap<QString, QList<QMap<QString, QString>>> cmdInfo;
     cmdInfo.insert("audio", info);
     DeviceManager::instance()->addCmdInfo(cmdInfo);
-    EXPECT_EQ(1, DeviceManager::instance()->m_cmdInfo.size());
-    EXPECT_EQ(1, DeviceManager::instance()->m_cmdInfo["audio"].size());
+    EXPECT_EQ(1, DeviceManager::instance()->cmdRecords("audio").size());
+    EXPECT_EQ(nullptr, DeviceManager::instance()->m_CmdSlots.load()->next);
 }
 
 void ut_manager_setcmdinfo()
@@ -702,7 +713,10 @@ void ut_manager_setcmdinfo()
     mapinfo.insert("Name", "Name");
     QList<QMap<QString, QString>> lst;
     lst.append(mapinfo);
-    DeviceManager::instance()->m_cmdInfo.insert(key, lst);
+    QMap<QString, QList<QMap<QString, QString>>> cmdInfo;
+    cmdInfo.insert(key, lst);
+    DeviceManager::instance()->clearCmdInfo();
+    DeviceManager::instance()->addCmdInfo(cmdInfo);
 }
 
 TEST_F(UT_DeviceManager, UT_DeviceManager_addCmdInfo_002)
@@ -715,14 +729,44 @@ TEST_F(UT_DeviceManager, UT_DeviceManager_addCmdInfo_002)
     QMap<QString, QList<QMap<QString, QString>>> cmdInfo;
     cmdInfo.insert("audio", info);
     DeviceManager::instance()->addCmdInfo(cmdInfo);
-    EXPECT_EQ(1, DeviceManager::instance()->m_cmdInfo.size());
-    EXPECT_EQ(2, DeviceManager::instance()->m_cmdInfo["audio"].size());
+    QList<CmdRecord> records = DeviceManager::instance()->cmdRecords("audio");
+    ASSERT_EQ(2, records.size());
+    // 按发布顺序拼接
+    EXPECT_EQ(QString("Name"), records[0].value(QString("Name")));
+    EXPECT_EQ(QString("name"), records[1].value(QString("name")));
 }
 
 TEST_F(UT_DeviceManager, UT_DeviceManager_cmdInfo)
 {
+    ut_manager_setcmdinfo();
+    ut_manager_setcmdinfo();
     QList<QMap<QString, QString>> lst = DeviceManager::instance()->cmdInfo("audio");
-    EXPECT_EQ(2, lst.size());
+    EXPECT_EQ(1, lst.size());
+    EXPECT_EQ(QString("Name"), lst[0].value("Name"));
+}
+
+TEST_F(UT_DeviceManager, UT_DeviceManager_addCmdInfo_concurrent)
+{
+    // 多个任务同时发布，生成器同时读取
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([i]() {
+            QMap<QString, QString> mapinfo;
+            mapinfo.insert("index", QString::number(i));
+            QMap<QString, QList<QMap<QString, QString>>> cmdInfo;
+            cmdInfo["ut_concurrent"].append(mapinfo);
+            cmdInfo["ut_concurrent_" + QString::number(i)].append(mapinfo);
+            DeviceManager::instance()->addCmdInfo(std::move(cmdInfo));
+            DeviceManager::instance()->cmdRecords("ut_concurrent");
+            DeviceManager::instance()->cmdInfo("ut_concurrent");
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(8, DeviceManager::instance()->cmdRecords("ut_concurrent").size());
+    EXPECT_EQ(1, DeviceManager::instance()->cmdRecords("ut_concurrent_3").size());
+    EXPECT_EQ(8, DeviceManager::instance()->cmdInfo("ut_concurrent").size());
 }
 
 TEST_F(UT_DeviceManager, UT_DeviceManager_getDeviceOverview)
@@ -785,7 +829,7 @@ TEST_F(UT_DeviceManager, UT_DeviceManager_inputInfo)
     EXPECT_EQ(mapinfo, map);
 }
 
-QList<QMap<QString, QString>> &ut_manager_cmd_btdevice()
+QList<QMap<QString, QString>> ut_manager_cmd_btdevice()
 {
     static QList<QMap<QString, QString>> lst;
     QMap<QString, QString> map;
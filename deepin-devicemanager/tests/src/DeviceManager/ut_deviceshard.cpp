@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "DeviceShard.h"
+#include "DeviceOthers.h"
+
+#include "ut_Head.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+static QString ut_shard_busInfo(const DeviceBaseInfo *device)
+{
+    const DeviceOthers *others = dynamic_cast<const DeviceOthers *>(device);
+    return others ? others->busInfo() : QString();
+}
+
+class UT_DeviceShard : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_Shard = new DeviceShard(m_LstDevice);
+    }
+    void TearDown()
+    {
+        delete m_Shard;
+        qDeleteAll(m_LstDevice);
+        m_LstDevice.clear();
+    }
+
+    DeviceOthers *newDevice(const QString &uniqueID, const QString &busInfo = QString())
+    {
+        DeviceOthers *device = new DeviceOthers;
+        device->m_UniqueID = uniqueID;
+        device->m_BusInfo = busInfo;
+        return device;
+    }
+
+    QList<DeviceBaseInfo *> m_LstDevice;
+    DeviceShard *m_Shard;
+};
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_find)
+{
+    DeviceOthers *first = newDevice("1-1:1.0");
+    DeviceOthers *second = newDevice("1-2:1.0");
+    DeviceOthers *same = newDevice("1-1:1.0");
+    m_Shard->append(first);
+    m_Shard->append(second);
+    m_Shard->append(same);
+
+    EXPECT_EQ(3, m_LstDevice.size());
+    EXPECT_EQ(first, m_Shard->find(DeviceShard::UniqueID, "1-1:1.0"));
+    EXPECT_EQ(second, m_Shard->find(DeviceShard::UniqueID, "1-2:1.0"));
+    EXPECT_EQ(nullptr, m_Shard->find(DeviceShard::UniqueID, "1-3:1.0"));
+    // 未设置取值方式的索引
+    EXPECT_EQ(nullptr, m_Shard->find(DeviceShard::BusID, ""));
+}
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_find_two_index)
+{
+    m_Shard->setIndexKey(DeviceShard::BusID, ut_shard_busInfo);
+    DeviceOthers *first = newDevice("1-1:1.0", "usb@1:8");
+    DeviceOthers *second = newDevice("1-2:1.0", "usb@1:9");
+    m_Shard->append(first);
+    m_Shard->append(second);
+
+    EXPECT_EQ(second, m_Shard->find(DeviceShard::BusID, "usb@1:9"));
+    EXPECT_EQ(first, m_Shard->find(DeviceShard::UniqueID, "1-2:1.0", DeviceShard::BusID, "usb@1:8"));
+    EXPECT_EQ(second, m_Shard->find(DeviceShard::UniqueID, "1-2:1.0", DeviceShard::BusID, "none"));
+}
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_findAll)
+{
+    DeviceOthers *first = newDevice("1-1:1.0");
+    DeviceOthers *second = newDevice("1-1:1.1");
+    DeviceOthers *third = newDevice("1-2:1.0");
+    DeviceOthers *fourth = newDevice("1-3:1.0");
+    first->m_HwinfoToLshw = "usb@1:1";
+    second->m_HwinfoToLshw = "usb@1:1";
+    third->m_HwinfoToLshw = "0000:01:00.0";
+    fourth->m_HwinfoToLshw = "usb@1:3";
+    m_Shard->append(first);
+    m_Shard->append(second);
+    m_Shard->append(third);
+    m_Shard->append(fourth);
+
+    // 同一个 usb 设备的多个接口，按列表顺序返回
+    QList<DeviceBaseInfo *> lst = m_Shard->findAll(DeviceShard::HwinfoToLshw, QStringList() << "usb@1:1");
+    EXPECT_EQ(QList<DeviceBaseInfo *>() << first << second, lst);
+
+    lst = m_Shard->findAll(DeviceShard::HwinfoToLshw, QStringList() << "usb@1:3" << "0000:01:00.0" << "usb@1:3");
+    EXPECT_EQ(QList<DeviceBaseInfo *>() << third << fourth, lst);
+    EXPECT_TRUE(m_Shard->findAll(DeviceShard::HwinfoToLshw, QStringList() << "usb@1:9").isEmpty());
+}
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_list_modified)
+{
+    DeviceOthers *first = newDevice("1-1:1.0");
+    DeviceOthers *second = newDevice("1-2:1.0");
+    m_Shard->append(first);
+    m_Shard->append(second);
+
+    // 绕过 append 删除和添加设备
+    m_LstDevice.removeOne(first);
+    delete first;
+    EXPECT_EQ(nullptr, m_Shard->find(DeviceShard::UniqueID, "1-1:1.0"));
+    EXPECT_EQ(second, m_Shard->find(DeviceShard::UniqueID, "1-2:1.0"));
+
+    DeviceOthers *third = newDevice("1-3:1.0");
+    m_LstDevice.removeOne(second);
+    delete second;
+    m_LstDevice.append(third);
+    EXPECT_EQ(third, m_Shard->find(DeviceShard::UniqueID, "1-3:1.0"));
+}
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_update)
+{
+    m_Shard->setIndexKey(DeviceShard::BusID, ut_shard_busInfo);
+    DeviceOthers *device = newDevice("1-1:1.0");
+    m_Shard->append(device);
+    EXPECT_EQ(nullptr, m_Shard->find(DeviceShard::BusID, "usb@1:8"));
+
+    device->m_BusInfo = "usb@1:8";
+    m_Shard->update(device);
+    EXPECT_EQ(device, m_Shard->find(DeviceShard::BusID, "usb@1:8"));
+
+    // find 返回的设备被修改后，下一次查找时更新索引
+    device->m_UniqueID = "1-2:1.0";
+    EXPECT_EQ(nullptr, m_Shard->find(DeviceShard::UniqueID, "1-1:1.0"));
+    EXPECT_EQ(device, m_Shard->find(DeviceShard::UniqueID, "1-2:1.0"));
+}
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_update_untouched)
+{
+    m_Shard->setIndexKey(DeviceShard::BusID, ut_shard_busInfo);
+    DeviceOthers *first = newDevice("1-1:1.0", "usb@1:8");
+    DeviceOthers *second = newDevice("1-2:1.0", "usb@1:8");
+    m_Shard->append(first);
+    m_Shard->append(second);
+
+    // 没有经过 find 和 update 直接修改设备，按旧的 key 查找时重建索引
+    first->m_BusInfo = "usb@1:9";
+    EXPECT_EQ(second, m_Shard->find(DeviceShard::BusID, "usb@1:8"));
+    EXPECT_EQ(first, m_Shard->find(DeviceShard::BusID, "usb@1:9"));
+    EXPECT_EQ(first, m_Shard->find(DeviceShard::UniqueID, "1-1:1.0"));
+}
+
+TEST_F(UT_DeviceShard, UT_DeviceShard_append_concurrent)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([this, t]() {
+            for (int i = 0; i < 50; ++i)
+                m_Shard->append(newDevice(QString("%1-%2").arg(t).arg(i)));
+        }));
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(200, m_LstDevice.size());
+    EXPECT_NE(nullptr, m_Shard->find(DeviceShard::UniqueID, "0-0"));
+    EXPECT_NE(nullptr, m_Shard->find(DeviceShard::UniqueID, "3-49"));
+}
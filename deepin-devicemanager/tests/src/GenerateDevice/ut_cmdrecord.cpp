@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "CmdRecord.h"
+#include "ut_Head.h"
+
+#include <gtest/gtest.h>
+
+class UT_CmdRecord : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+        m_MapInfo.insert("SysFS BusID", "1-1:1.0");
+        m_MapInfo.insert("Hardware Class", "camera");
+        m_MapInfo.insert("Model", "Integrated Camera");
+        m_MapInfo.insert("Driver", "uvcvideo");
+    }
+    void TearDown()
+    {
+    }
+
+    QMap<QString, QString> m_MapInfo;
+};
+
+TEST_F(UT_CmdRecord, UT_CmdRecord_keyId)
+{
+    int id = CmdRecord::keyId("Hardware Class");
+    EXPECT_EQ(id, CmdRecord::keyId(QString("Hardware") + " Class"));
+    EXPECT_EQ(id, CmdRecord::findKeyId("Hardware Class"));
+    EXPECT_EQ(QString("Hardware Class"), CmdRecord::keyName(id));
+    EXPECT_EQ(-1, CmdRecord::findKeyId("UT_CmdRecord never interned"));
+    EXPECT_TRUE(CmdRecord::keyName(-1).isEmpty());
+}
+
+TEST_F(UT_CmdRecord, UT_CmdRecord_value)
+{
+    CmdRecord record(m_MapInfo);
+    EXPECT_EQ(4, record.size());
+    EXPECT_TRUE(record.contains(CmdRecord::keyId("Model")));
+    EXPECT_FALSE(record.contains(CmdRecord::keyId("Serial ID")));
+    EXPECT_EQ(QString("camera"), record.value(CmdRecord::keyId("Hardware Class")));
+    EXPECT_EQ(QString("uvcvideo"), record.value(QString("Driver")));
+    EXPECT_TRUE(record.value(QString("UT_CmdRecord never interned")).isEmpty());
+
+    record.insert(CmdRecord::keyId("Model"), "USB Camera");
+    record.insert(CmdRecord::keyId("Serial ID"), "0001");
+    EXPECT_EQ(5, record.size());
+    EXPECT_EQ(QString("USB Camera"), record.value(QString("Model")));
+    EXPECT_EQ(QString("0001"), record.value(QString("Serial ID")));
+}
+
+TEST_F(UT_CmdRecord, UT_CmdRecord_toMap)
+{
+    QList<QMap<QString, QString> > lstMap;
+    lstMap.append(m_MapInfo);
+    lstMap.append(QMap<QString, QString>());
+
+    QList<CmdRecord> lstRecord = CmdRecord::fromList(lstMap);
+    ASSERT_EQ(2, lstRecord.size());
+    EXPECT_TRUE(lstRecord[1].isEmpty());
+    EXPECT_EQ(m_MapInfo, lstRecord[0].toMap());
+    EXPECT_EQ(lstMap, CmdRecord::toList(lstRecord));
+    EXPECT_TRUE(CmdRecord(m_MapInfo) == lstRecord[0]);
+}
@@ -36,7 +36,6 @@ TEST_F(UT_CmdTool, UT_CmdTool_loadCmdInfo)
     m_cmdTool->loadCmdInfo("lshw", "lshw.txt");
     m_cmdTool->loadCmdInfo("printer", "printer.txt");
     m_cmdTool->loadCmdInfo("dmidecode0", "dmidecode_0.txt");
-    m_cmdTool->loadCmdInfo("dr_config", "dr_config.txt");
     m_cmdTool->loadCmdInfo("lscpu", "lscpu.txt");
     m_cmdTool->loadCmdInfo("xrandr", "xrandr.txt");
     m_cmdTool->loadCmdInfo("lsblk_d", "lsblk_d.txt");
@@ -172,6 +171,34 @@ TEST_F(UT_CmdTool, UT_CmdTool_loadLshwInfo)
     EXPECT_EQ(10, size);
 }
 
+bool ut_getRecords_loadLshwInfo(void *obj, const QString &source, QList<QMap<QString, QString> > &records)
+{
+    Q_UNUSED(obj);
+    Q_UNUSED(source);
+    QMap<QString, QString> system;
+    system.insert("*-", "uos-PC");
+    system.insert("description", "Desktop Computer");
+    QMap<QString, QString> cpu;
+    cpu.insert("*-", "cpu:0");
+    cpu.insert("product", "Intel(R) Core(TM) i5");
+    QMap<QString, QString> pci;
+    pci.insert("*-", "pci");
+    records << system << cpu << pci;
+    return true;
+}
+TEST_F(UT_CmdTool, UT_CmdTool_loadLshwInfo_records)
+{
+    Stub stub;
+    stub.set(ADDR(DBusInterface, getRecords), ut_getRecords_loadLshwInfo);
+    m_cmdTool->loadLshwInfo("lshw.txt");
+
+    // 按 "*-" 的值分类，分类之后不再保留
+    ASSERT_EQ(2, m_cmdTool->m_cmdInfo.size());
+    EXPECT_EQ(QString("Desktop Computer"), m_cmdTool->m_cmdInfo["lshw_system"][0].value("description"));
+    EXPECT_EQ(QString("Intel(R) Core(TM) i5"), m_cmdTool->m_cmdInfo["lshw_cpu"][0].value("product"));
+    EXPECT_FALSE(m_cmdTool->m_cmdInfo["lshw_cpu"][0].contains("*-"));
+}
+
 bool ut_getDeviceInfo_loadLsblkInfo(void *obj, QString &deviceInfo, const QString &file)
 {
     deviceInfo = "NAME ROTA\n"
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "DBusInterface.h"
+#include "CollectorBundle.h"
 #include "ut_Head.h"
 #include "stub.h"
 
@@ -56,3 +57,88 @@ TEST_F(UT_DBusInterface, UT_DBusInterface_getInfo_002)
     DBusInterface::getInstance()->getInfo("lshw", info);
     // EXPECT_FALSE(DBusInterface::getInstance()->getInfo("lshw",info));
 }
+
+TEST_F(UT_DBusInterface, UT_DBusInterface_getInfo_cache)
+{
+    DBusInterface *iface = DBusInterface::getInstance();
+    iface->m_MapCache.insert("lshw", "cached lshw");
+    iface->m_CacheValid = true;
+
+    // 批量获取后直接从缓存中读取，没有的信息为空
+    QString info;
+    EXPECT_TRUE(iface->getInfo("lshw", info));
+    EXPECT_EQ(QString("cached lshw"), info);
+    EXPECT_TRUE(iface->getInfo("smartctl_sdz", info));
+    EXPECT_TRUE(info.isEmpty());
+
+    iface->m_MapCache.clear();
+    iface->m_CacheValid = false;
+}
+
+TEST_F(UT_DBusInterface, UT_DBusInterface_invalidateCache)
+{
+    Stub stub;
+    stub.set(ADDR(CollectorBundle, isReplaying), ut_replay_002);
+
+    DBusInterface *iface = DBusInterface::getInstance();
+    iface->m_MapCache.insert("lshw", "cached lshw");
+    iface->m_Generation = 5;
+    iface->m_CacheValid = true;
+
+    // 刷新后不再使用缓存，保留版本号以便只获取变化的信息
+    iface->invalidateCache();
+    EXPECT_FALSE(iface->m_CacheValid);
+    EXPECT_EQ(5u, iface->m_Generation);
+    EXPECT_EQ(QString("cached lshw"), iface->m_MapCache.value("lshw"));
+
+    iface->m_MapCache.clear();
+    iface->m_Generation = 0;
+}
+
+static int ut_fetchRecords_count = 0;
+bool ut_fetchRecords(void *obj, const QStringList &sources, QMap<QString, QList<QMap<QString, QString> > > &mapRecords)
+{
+    Q_UNUSED(obj);
+    ++ut_fetchRecords_count;
+    foreach (const QString &source, sources)
+        mapRecords.insert(source, QList<QMap<QString, QString> >());
+    QMap<QString, QString> map;
+    map.insert("Vendor", "LENOVO");
+    mapRecords["dmidecode_0"].append(map);
+    return true;
+}
+TEST_F(UT_DBusInterface, UT_DBusInterface_getRecords_cache)
+{
+    Stub stub;
+    stub.set(ADDR(CollectorBundle, isReplaying), ut_replay_002);
+    stub.set(ADDR(DBusInterface, fetchRecords), ut_fetchRecords);
+    ut_fetchRecords_count = 0;
+
+    // 所有来源的记录一次获取
+    DBusInterface *iface = DBusInterface::getInstance();
+    iface->invalidateCache();
+    QList<QMap<QString, QString> > records;
+    EXPECT_TRUE(iface->getRecords("dmidecode_0", records));
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ(QString("LENOVO"), records[0].value("Vendor"));
+    records.clear();
+    EXPECT_TRUE(iface->getRecords("lshw", records));
+    EXPECT_TRUE(records.isEmpty());
+    EXPECT_EQ(1, ut_fetchRecords_count);
+
+    // 一轮结束后重新获取
+    iface->invalidateCache();
+    EXPECT_TRUE(iface->getRecords("dmidecode_4", records));
+    EXPECT_EQ(2, ut_fetchRecords_count);
+
+    iface->invalidateCache();
+    iface->m_MapRecords.clear();
+}
+
+TEST_F(UT_DBusInterface, UT_DBusInterface_isLargeKey)
+{
+    EXPECT_TRUE(DBusInterface::isLargeKey("hwinfo"));
+    EXPECT_TRUE(DBusInterface::isLargeKey("lshw"));
+    EXPECT_FALSE(DBusInterface::isLargeKey("dmesg_facts"));
+    EXPECT_FALSE(DBusInterface::isLargeKey("lscpu"));
+}
@@ -61,8 +61,13 @@ public:
     DeviceGenerator *m_deviceGenerator = nullptr;
 };
 
+QList<CmdRecord> ut_DeviceGenerator_cmdRecords()
+{
+    return CmdRecord::fromList(lstMap);
+}
+
 //virtual void generatorComputerDevice();
-const QList<QMap<QString, QString> > &ut_DeviceGenerator_cmdInfo()
+QList<QMap<QString, QString> > ut_DeviceGenerator_cmdInfo()
 {
     return lstMap;
 }
@@ -128,7 +133,7 @@ TEST_F(UT_DeviceGenerator, UT_DeviceGenerator_generatorMonitorDevice)
     EXPECT_TRUE(DeviceManager::instance()->m_ListDeviceMonitor.size());
 }
 
-const QList<QMap<QString, QString> > &ut_DeviceGenerator_cmdInfo_hwinfonetwork(void *obj, const QString &key)
+QList<QMap<QString, QString> > ut_DeviceGenerator_cmdInfo_hwinfonetwork(void *obj, const QString &key)
 {
     if ("hwinfo_network" == key) {
         QMap<QString, QString> mapInfo;
@@ -507,6 +512,7 @@ TEST_F(UT_DeviceGenerator, UT_DeviceGenerator_getBlueToothInfoFromHwinfo)
 {
     Stub stub;
     stub.set(ADDR(DeviceManager, cmdInfo), ut_DeviceGenerator_cmdInfo);
+    stub.set(ADDR(DeviceManager, cmdRecords), ut_DeviceGenerator_cmdRecords);
     m_deviceGenerator->getBluetoothInfoFromHciconfig();
     m_deviceGenerator->getBlueToothInfoFromHwinfo();
     EXPECT_TRUE(DeviceManager::instance()->m_ListDeviceBluetooth.size());
@@ -576,6 +582,7 @@ TEST_F(UT_DeviceGenerator, UT_DeviceGenerator_getImageInfoFromHwinfo)
 {
     Stub stub;
     stub.set(ADDR(DeviceManager, cmdInfo), ut_DeviceGenerator_cmdInfo);
+    stub.set(ADDR(DeviceManager, cmdRecords), ut_DeviceGenerator_cmdRecords);
     m_deviceGenerator->getImageInfoFromHwinfo();
     EXPECT_TRUE(DeviceManager::instance()->m_ListDeviceImage.size());
 }
@@ -585,6 +592,7 @@ TEST_F(UT_DeviceGenerator, UT_DeviceGenerator_getImageInfoFromLshw)
 {
     Stub stub;
     stub.set(ADDR(DeviceManager, cmdInfo), ut_DeviceGenerator_cmdInfo);
+    stub.set(ADDR(DeviceManager, cmdRecords), ut_DeviceGenerator_cmdRecords);
     m_deviceGenerator->getImageInfoFromHwinfo();
     m_deviceGenerator->getImageInfoFromLshw();
     EXPECT_TRUE(DeviceManager::instance()->m_ListDeviceImage.size());
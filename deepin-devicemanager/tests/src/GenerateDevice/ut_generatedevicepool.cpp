@@ -48,11 +48,39 @@ public:
 // void initType();
 TEST_F(UT_GenerateDevicePool,UT_GenerateDevicePool_initType){
     m_generateDevicePool->m_TypeList.clear();
+    m_generateDevicePool->m_DependList.clear();
     m_generateDevicePool->initType();
-    EXPECT_EQ(16, m_generateDevicePool->m_TypeList.size());
+    EXPECT_EQ(17, m_generateDevicePool->m_TypeList.size());
+    EXPECT_EQ(1, m_generateDevicePool->m_DependList.size());
+    EXPECT_EQ(16, m_generateDevicePool->m_DependList.value(DT_Others).size());
 }
 
 TEST_F(UT_GenerateDevicePool,UT_GenerateDevicePool_generateDevice){
     m_generateDevicePool->generateDevice();
-    EXPECT_EQ(m_generateDevicePool->m_FinishedGenerator,0);
+    EXPECT_EQ(m_generateDevicePool->m_TypeList.size(), m_generateDevicePool->m_FinishedGenerator);
+    EXPECT_EQ(0, m_generateDevicePool->m_PendingDepend.value(DT_Others));
+    EXPECT_EQ(nullptr, m_generateDevicePool->mp_Generator);
+}
+
+static QList<DeviceType> ut_startedTask;
+void ut_GenerateDevicePool_startTask(void *obj, DeviceType type)
+{
+    Q_UNUSED(obj);
+    ut_startedTask.append(type);
+}
+
+TEST_F(UT_GenerateDevicePool,UT_GenerateDevicePool_finishedTask){
+    Stub stub;
+    stub.set(ADDR(GenerateDevicePool, startTask), ut_GenerateDevicePool_startTask);
+    ut_startedTask.clear();
+
+    m_generateDevicePool->m_DependList.insert(DT_Others, QList<DeviceType>() << DT_Cpu << DT_Gpu);
+    m_generateDevicePool->m_PendingDepend.insert(DT_Others, 2);
+
+    // 依赖没有全部完成时不启动
+    m_generateDevicePool->finishedTask(DT_Cpu);
+    EXPECT_TRUE(ut_startedTask.isEmpty());
+    m_generateDevicePool->finishedTask(DT_Gpu);
+    EXPECT_EQ(QList<DeviceType>() << DT_Others, ut_startedTask);
+    EXPECT_EQ(2, m_generateDevicePool->m_FinishedGenerator);
 }
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "HwinfoParser.h"
+#include "CmdTool.h"
+#include "ut_Head.h"
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <gtest/gtest.h>
+
+static const char *s_UsbItem =
+    "%1: USB 00.0: 0000 Unclassified device\n"
+    "  [Created at usb.122]\n"
+    "  Unique ID: %2.%3Wvy1HbLtE0\n"
+    "  Parent ID: k4bc.2DFUsyrieMD\n"
+    "  SysFS ID: /devices/pci0000:00/0000:00:14.0/usb1/1-%1/1-%1:1.%3\n"
+    "  SysFS BusID: 1-%1:1.%3\n"
+    "  Hardware Class: unknown\n"
+    "  Model: \"Realtek USB Card Reader\"\n"
+    "  Hotplug: USB\n"
+    "  Vendor: usb 0x0bda \"Realtek Semiconductor Corp.\"\n"
+    "  Device: usb 0x0129 \"RTS5129 Card Reader Controller\"\n"
+    "  Revision: \"39.60\"\n"
+    "  Serial ID: \"20100201396000000\"\n"
+    "  Driver: \"rtsx_usb\", \"usb-storage\"\n"
+    "  Driver Modules: \"rtsx_usb\"\n"
+    "  Speed: 480 Mbps\n"
+    "  Module Alias: \"usb:v0BDAp0129d3960dcFFdscFFdpFFicFFiscFFipFFin00\"\n"
+    "  Driver Info #0:\n"
+    "    Driver Status: rtsx_usb is active\n"
+    "    Driver Activation Cmd: \"modprobe rtsx_usb\"\n"
+    "  Config Status: cfg=new, avail=yes, need=no, active=unknown\n"
+    "  Attached to: #%4 (Hub)\n";
+
+class UT_HwinfoParser : public UT_HEAD
+{
+public:
+    void SetUp()
+    {
+    }
+    void TearDown()
+    {
+    }
+
+    QString usbDump(int count)
+    {
+        QString dump;
+        for (int i = 0; i < count; ++i)
+            dump += QString(s_UsbItem).arg(i).arg(i % 97).arg(i % 3).arg(i / 8) + "\n";
+        return dump;
+    }
+};
+
+TEST_F(UT_HwinfoParser, UT_HwinfoParser_sameAsCmdTool)
+{
+    QString dump = usbDump(4);
+    dump += "05: None 00.0: 10002 LCD Monitor\n"
+            "  Hardware Class: monitor\n"
+            "  Model: \"DELL U2412M\"\n"
+            "  Vendor: DEL \"DELL\"\n"
+            "  Device: eisa 0xa07e \"DELL U2412M\"\n"
+            "  Resolution: 1920x1200@60Hz\n"
+            "  Resolution: 1600x1200@60Hz\n"
+            "  Unknown Key: unknown\n"
+            "\n\n"
+            "06: PS/2 00.0: 10500 PS/2 Mouse\n"
+            "  Hardware Class: mouse\n"
+            "  Model: \"Generic PS/2 Mouse\"\n";
+
+    HwinfoParser parser(dump.toUtf8());
+    QStringList items = dump.split("\n\n", QString::SkipEmptyParts);
+    ASSERT_EQ(items.size(), parser.records().size());
+
+    CmdTool tool;
+    for (int i = 0; i < items.size(); ++i) {
+        QMap<QString, QString> mapInfo;
+        tool.getMapInfoFromHwinfo(items[i], mapInfo);
+        EXPECT_EQ(mapInfo, parser.records()[i].toMap());
+    }
+
+    const HwinfoRecord &usb = parser.records()[1];
+    EXPECT_EQ(QString("1-1:1.1"), usb.value(QLatin1String("SysFS BusID")));
+    EXPECT_EQ(QString("0x0bda0129"), usb.value(QLatin1String("VID_PID")));
+    EXPECT_EQ(QString("rtsx_usb, usb-storage"), usb.value(QLatin1String("Driver")));
+    EXPECT_EQ(QString("usb:v0BDAp0129d3960dcFFdscFFdpFFicFFiscFF"), usb.value(QLatin1String("Module Alias")));
+    EXPECT_EQ(QString("1920x1200@60Hz 1600x1200@60Hz"), parser.records()[4].value(QLatin1String("Resolution")));
+    EXPECT_EQ(QString("PS/2"), parser.records()[5].value(QLatin1String("Hotplug")));
+}
+
+TEST_F(UT_HwinfoParser, UT_HwinfoParser_benchmark)
+{
+    // 约 2MB 的 hwinfo --usb 输出
+    QString dump = usbDump(2700);
+    QByteArray data = dump.toUtf8();
+    ASSERT_GT(data.size(), 2 * 1000 * 1000);
+
+    QElapsedTimer timer;
+    timer.start();
+    HwinfoParser parser(data);
+    qint64 parseMsec = timer.elapsed();
+    EXPECT_EQ(2700, parser.records().size());
+
+    timer.restart();
+    CmdTool tool;
+    foreach (const QString &item, dump.split("\n\n", QString::SkipEmptyParts)) {
+        QMap<QString, QString> mapInfo;
+        tool.getMapInfoFromHwinfo(item, mapInfo);
+    }
+    qint64 legacyMsec = timer.elapsed();
+
+    // 只输出耗时，不作为断言，覆盖率编译和负载较高的机器上耗时不稳定
+    qInfo() << "hwinfo" << data.size() << "bytes, HwinfoParser" << parseMsec << "ms, getMapInfoFromHwinfo" << legacyMsec << "ms";
+}
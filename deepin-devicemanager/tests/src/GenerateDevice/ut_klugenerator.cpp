@@ -57,7 +57,7 @@ public:
     KLUGenerator *m_KLUGenerator = nullptr;
 };
 
-const QList<QMap<QString, QString> > & ut_DeviceGenerator_klu_cmdInfo(){
+QList<QMap<QString, QString> > ut_DeviceGenerator_klu_cmdInfo(){
     return kluLstMap;
 }
 
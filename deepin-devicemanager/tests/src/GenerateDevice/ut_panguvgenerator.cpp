@@ -131,7 +131,7 @@ public:
     MipsGenerator *m_MipsGenerator = nullptr;
 };
 
-const QList<QMap<QString, QString> > & ut_PanguGenerator_cmdInfo(){
+QList<QMap<QString, QString> > ut_PanguGenerator_cmdInfo(){
     return panGuLstMap;
 }
 // MipsGenerator virtual void generatorComputerDevice() override;
@@ -30,7 +30,7 @@ public:
     LoadCpuInfoThread *m_loadCpuInfoThread;
 };
 
-const QList<QMap<QString, QString>>& ut_LoadCpuInfoThread_cmdInfo()
+QList<QMap<QString, QString>> ut_LoadCpuInfoThread_cmdInfo()
 {
     static QList<QMap<QString, QString>> list;
     list.clear();